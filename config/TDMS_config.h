@@ -16,19 +16,36 @@ extern "C" {
 
 
 /* Functionality Options --------------------------------------------------------*/
+/**
+ * @brief  Allocation of Group and Channel objects
+ *         - 0: static: fixed arrays and names that are sized by the
+ *              configurations below (no heap allocation)
+ *         - 1: dynamic: any number of Groups, Channels and name length. Paths
+ *              are allocated from an arena and objects can be found by path
+ *              in O(1). TDMS_DeInitFile must be called to release the memory.
+ */
+#define TDMS_CONFIG_DYNAMIC_OBJECTS         0
+
 /**
  * @brief  Max NULL terminated strings length of File, Group and Channel data
- *         types
+ *         types (static objects only)
  */
 #define TDMS_CONFIG_GROUP_NAME_LEN          30
 #define TDMS_CONFIG_CHANNEL_NAME_LEN        30
 
 /**
- * @brief  Determines max Channels of Group and max Groups of TDMS file
+ * @brief  Determines max Channels of Group and max Groups of TDMS file (static
+ *         objects only)
  */
 #define TDMS_CONFIG_MAX_GROUP_OF_FILE       4
 #define TDMS_CONFIG_MAX_CHANNEL_OF_GROUP    8
 
+/**
+ * @brief  Max number of coefficients of polynomial scales of DAQmx Channels
+ *         (static objects only)
+ */
+#define TDMS_CONFIG_MAX_SCALE_COEFFICIENTS  8
+
 /**
  * @brief  Determines system Endianness
  *         - 0: little-endian
@@ -36,6 +53,29 @@ extern "C" {
  */
 #define TDMS_CONFIG_SYSTEM_ENDIANNESS       0
 
+/**
+ * @brief  Determines Endianness of generated TDMS files (big-endian segments
+ *         are marked by kTocBigEndian). If it is not defined, it is the same as
+ *         system Endianness and raw data is saved without byte swapping.
+ *         - 0: little-endian
+ *         - 1: big-endian
+ */
+// #define TDMS_CONFIG_OUTPUT_ENDIANNESS       0
+
+/**
+ * @brief  Initial size of the buffer of TDMS Writer objects (Byte). The buffer
+ *         grows when a segment does not fit in it.
+ */
+#define TDMS_CONFIG_WRITER_BUFFER_SIZE      4096
+
+/**
+ * @brief  Enables the features that need a POSIX system (e.g. file descriptor
+ *         sinks). If it is not defined, it is enabled on POSIX systems.
+ *         - 0: disable
+ *         - 1: enable
+ */
+// #define TDMS_CONFIG_POSIX                   1
+
 
 
 #ifdef __cplusplus
@@ -10,34 +10,27 @@
 #include <string.h>
 #include <stdlib.h> 
 #include "TDMS.h"
-
-#define MEMALLOC(size) calloc(4096, sizeof(uint8_t)); \
-                       if(!Buffer) \
-                       { \
-                         printf("malloc failed!\n"); \
-                         char ch; \
-                         scanf("%c", &ch); \
-                         return (1); \
-                       }
-
+#include "TDMS_Reader.h"
 
 int main()
 {
   printf("TDMS Library test\n");
 
   FILE *MyFile;
+  FILE *MyIndexFile;
   TDMS_File_t FileTDMS;
   TDMS_Group_t Group1;
   TDMS_Group_t Group2;
   TDMS_Channel_t Channel1Group1;
   TDMS_Channel_t Channel2Group1;
   TDMS_Channel_t Channel1Group2;
-
-  uint8_t *Buffer;
-  uint32_t Size = 0;
+  TDMS_Writer_t Writer;
+  TDMS_Reader_t Reader;
+  uint32_t CounterI;
 
   MyFile = fopen("./build/Test.tdms", "wb");
-  if (!MyFile)
+  MyIndexFile = fopen("./build/Test.tdms_index", "wb");
+  if (!MyFile || !MyIndexFile)
   {
     printf("File open failed!\n");
     char ch;
@@ -79,98 +72,74 @@ int main()
     printf("Add Channel 3 failed!");
 
 
-  TDMS_GenFirstPart(&FileTDMS, NULL, &Size);
-  Buffer = MEMALLOC(Size + 1);
-  TDMS_GenFirstPart(&FileTDMS, Buffer, &Size);
-  fwrite(Buffer, 1, Size, MyFile);
-  free(Buffer);
-
-
-  TDMS_AddPropertyToFile(NULL,
-                         &Size,
-                         "Description",
-                         TDMS_DataType_String,
-                         "A file generated by TDMS library");
-  Buffer = MEMALLOC(Size + 1);
-  TDMS_AddPropertyToFile(Buffer,
-                         &Size,
-                         "Description",
-                         TDMS_DataType_String,
-                         "A file generated by TDMS library");
-  fwrite(Buffer, 1, Size, MyFile);
-  free(Buffer);
-
-  TDMS_AddPropertyToFile(NULL,
-                         &Size,
-                         "Author",
-                         TDMS_DataType_String,
-                         "Hossein-M98");
-  Buffer = MEMALLOC(Size + 1);
-  TDMS_AddPropertyToFile(Buffer,
-                         &Size,
-                         "Author",
-                         TDMS_DataType_String,
-                         "Hossein-M98");
-  fwrite(Buffer, 1, Size, MyFile);
-  free(Buffer);
-
-
-  TDMS_AddPropertyToGroup(&Group1,
-                          NULL,
-                          &Size,
-                          "Description",
-                          TDMS_DataType_String,
-                          "This is Group 1");
-  Buffer = MEMALLOC(Size + 1);
-  TDMS_AddPropertyToGroup(&Group1,
-                          Buffer,
-                          &Size,
-                          "Description",
-                          TDMS_DataType_String, "This is Group 1");
-  fwrite(Buffer, 1, Size, MyFile);
-  free(Buffer);
-
-
-  TDMS_AddPropertyToChannel(&Channel1Group2,
-                            NULL,
-                            &Size,
-                            "Description",
-                            TDMS_DataType_String,
-                            "This is a Date and Time channel");
-  Buffer = MEMALLOC(Size + 1);
-  TDMS_AddPropertyToChannel(&Channel1Group2,
-                            Buffer,
-                            &Size,
-                            "Description",
-                            TDMS_DataType_String,
-                            "This is a Date and Time channel");
-  fwrite(Buffer, 1, Size, MyFile);
-  free(Buffer);
+  if (TDMS_InitWriterStream(&Writer, &FileTDMS, MyFile) != TDMS_OK)
+  {
+    printf("Init writer failed!\n");
+    char ch;
+    scanf("%c", &ch);
+    return (1);
+  }
+
+  if (TDMS_WriterSetIndexStream(&Writer, MyIndexFile) != TDMS_OK)
+    printf("Set index file failed!");
+
+  TDMS_WriterGenFirstPart(&Writer);
+
+
+  TDMS_WriterAddPropertyToFile(&Writer,
+                               "Description",
+                               TDMS_DataType_String,
+                               "A file generated by TDMS library");
+
+  TDMS_WriterAddPropertyToFile(&Writer,
+                               "Author",
+                               TDMS_DataType_String,
+                               "Hossein-M98");
+
+
+  TDMS_WriterAddPropertyToGroup(&Writer,
+                                &Group1,
+                                "Description",
+                                TDMS_DataType_String,
+                                "This is Group 1");
+
+
+  TDMS_WriterAddPropertyToChannel(&Writer,
+                                  &Channel1Group2,
+                                  "Description",
+                                  TDMS_DataType_String,
+                                  "This is a Date and Time channel");
 
 
   uint8_t Data[] = {0,1,2,3,4,5,6,7,8,9,10,11,12,13,14};
   float Data2[] = {100.25, 101.5, 102.75, 103.25, 104.5, 105.75};
-  TDMS_SetGroupDataValues(&Group1, NULL, &Size,
-                          Data, sizeof(Data) / sizeof(uint8_t),
-                          Data2, sizeof(Data2) / sizeof(float));
-  Buffer = MEMALLOC(Size + 1);
-  TDMS_SetGroupDataValues(&Group1, Buffer, &Size,
-                          Data, sizeof(Data) / sizeof(uint8_t),
-                          Data2, sizeof(Data2) / sizeof(float));
-  fwrite(Buffer, 1, Size, MyFile);
-  free(Buffer);
+  TDMS_WriterSetGroupDataValues(&Writer, &Group1,
+                                Data, (uint64_t) (sizeof(Data) / sizeof(uint8_t)),
+                                Data2, (uint64_t) (sizeof(Data2) / sizeof(float)));
 
   uint64_t second = TDMS_TimeSecond(2023, 5, 17, 12, 14, 10);
   TDMS_Timestamp_t Data4[] = {{.Fraction = 0, .Second = second}};
-  TDMS_SetChannelDataValues(&Channel1Group2, NULL, &Size,
-                            Data4, sizeof(Data4) / sizeof(TDMS_Timestamp_t));
-  Buffer = MEMALLOC(Size + 1);
-  TDMS_SetChannelDataValues(&Channel1Group2, Buffer, &Size,
-                            Data4, sizeof(Data4) / sizeof(TDMS_Timestamp_t));
-  fwrite(Buffer, 1, Size, MyFile);
-  free(Buffer);
+  TDMS_WriterSetChannelDataValues(&Writer, &Channel1Group2,
+                                  Data4, sizeof(Data4) / sizeof(TDMS_Timestamp_t));
+
+  TDMS_DeInitWriter(&Writer);
+  TDMS_DeInitFile(&FileTDMS);
 
-  printf("Process finished successfully!\n");
   fclose(MyFile);
+  fclose(MyIndexFile);
+
+  // Read the generated file back
+  if (TDMS_ReaderOpen(&Reader, "./build/Test.tdms") != TDMS_OK)
+  {
+    printf("Read file failed!\n");
+    return (1);
+  }
+  for (CounterI = 0; CounterI < Reader.NumOfObjects; CounterI++)
+    printf("%.*s: %llu values\n",
+           (int) Reader.Objects[CounterI].PathLen, Reader.Objects[CounterI].Path,
+           (unsigned long long) Reader.Objects[CounterI].NumOfValues);
+  TDMS_ReaderClose(&Reader);
+
+  printf("Process finished successfully!\n");
   return (0);
 }
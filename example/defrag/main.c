@@ -0,0 +1,76 @@
+/**
+ **********************************************************************************
+ * @file   main.c
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  Defragment a TDMS file into one segment with a contiguous block of
+ *         raw data for each Channel
+ **********************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "TDMS.h"
+#include "TDMS_Reader.h"
+
+#define DEFRAG_BUFFER_SIZE  (1024 * 1024)
+
+static TDMS_Result_t
+FileSinkWrite(void *Context, const uint8_t *Data, uint64_t Size)
+{
+  if (fwrite(Data, 1, (size_t) Size, (FILE *) Context) != (size_t) Size)
+    return TDMS_IO_ERROR;
+
+  return TDMS_OK;
+}
+
+int main(int argc, char **argv)
+{
+  TDMS_Reader_t Reader;
+  TDMS_Sink_t Sink = {NULL, FileSinkWrite, NULL, NULL};
+  TDMS_Sink_t IndexSink = {NULL, FileSinkWrite, NULL, NULL};
+  TDMS_Result_t Result;
+  FILE *OutFile;
+  FILE *OutIndexFile = NULL;
+
+  if (argc < 3)
+  {
+    printf("Usage: %s <input.tdms> <output.tdms> [output.tdms_index]\n", argv[0]);
+    return 1;
+  }
+
+  if (TDMS_ReaderOpen(&Reader, argv[1]) != TDMS_OK)
+  {
+    printf("Open %s failed!\n", argv[1]);
+    return 1;
+  }
+
+  OutFile = fopen(argv[2], "wb");
+  if (argc > 3)
+    OutIndexFile = fopen(argv[3], "wb");
+  if (!OutFile || (argc > 3 && !OutIndexFile))
+  {
+    printf("File open failed!\n");
+    TDMS_ReaderClose(&Reader);
+    return 1;
+  }
+  Sink.Context = OutFile;
+  IndexSink.Context = OutIndexFile;
+
+  Result = TDMS_ReaderDefragment(&Reader, &Sink,
+                                 OutIndexFile ? &IndexSink : NULL,
+                                 DEFRAG_BUFFER_SIZE);
+  if (fclose(OutFile) != 0 && Result == TDMS_OK)
+    Result = TDMS_IO_ERROR;
+  if (OutIndexFile && fclose(OutIndexFile) != 0 && Result == TDMS_OK)
+    Result = TDMS_IO_ERROR;
+
+  if (Result != TDMS_OK)
+    printf("Defragment failed (%d)!\n", (int) Result);
+  else
+    printf("%u segments, %u objects -> 1 segment\n",
+           Reader.NumOfSegments, Reader.NumOfObjects);
+
+  TDMS_ReaderClose(&Reader);
+
+  return (Result == TDMS_OK) ? 0 : 1;
+}
@@ -3,63 +3,99 @@
  * @file   TDMS.c
  * @author Hossein.M (https://github.com/Hossein-M98)
  * @brief  Generate NI TDMS file (.TDMS)
- * @note   This library cannot read TDMS files.
+ * @note   TDMS files are read by TDMS_Reader.
  *         This library do not support all data types.
  **********************************************************************************
  */
 
 /* Includes ---------------------------------------------------------------------*/
+// clock_gettime, fseeko and ftello are POSIX functions, and FILE streams have
+// 64 bit offsets on 32 bit systems
+#if !defined(_WIN32)
+#if !defined(_POSIX_C_SOURCE) && !defined(_GNU_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+#if !defined(_FILE_OFFSET_BITS)
+#define _FILE_OFFSET_BITS 64
+#endif
+#endif
 #include "TDMS.h"
 #include "TDMS_config.h"
+#include "TDMS_Private.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdarg.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if (TDMS_CONFIG_POSIX == 1)
+#include <time.h>
+#include <sys/types.h>
+#endif
 
 
 /* Private Constants ------------------------------------------------------------*/
 /**
- * @brief  Lead in part constants
- */ 
-#define LeadInPartLen         28
-#define TAG_TDSm_Num          0x5444536D
-#define Version_Number4713    0x69120000	
-
-/**
- * @brief  ToC mask constants
- */ 
-#define kTocMetaData          0x00000002
-#define kTocRawData           0x00000008
-#define kTocNewObjList        0x00000004
-#define kTocInterleavedData   0x00000020
-#define kTocBigEndian         0x00000040
-#define kTocDAQmxRawData      0x00000080
-
-/**
- * @brief  Data type constants
- */
-#define tdsTypeVoid                   0x00000000
-#define tdsTypeI8                     0x00000001
-#define tdsTypeI16                    0x00000002
-#define tdsTypeI32                    0x00000003
-#define tdsTypeI64                    0x00000004
-#define tdsTypeU8                     0x00000005
-#define tdsTypeU16                    0x00000006
-#define tdsTypeU32                    0x00000007
-#define tdsTypeU64                    0x00000008
-#define tdsTypeSingleFloat            0x00000009
-#define tdsTypeDoubleFloat            0x0000000A
-#define tdsTypeExtendedFloat          0x0000000B
-#define tdsTypeSingleFloatWithUnit    0x00000019
-#define tdsTypeDoubleFloatWithUnit    0x0000001A
-#define tdsTypeExtendedFloatWithUnit  0x0000001B
-#define tdsTypeString                 0x00000020
-#define tdsTypeBoolean                0x00000021
-#define tdsTypeTimeStamp              0x00000044
-#define tdsTypeFixedPoint             0x0000004F
-#define tdsTypeComplexSingleFloat     0x0008000C
-#define tdsTypeComplexDoubleFloat     0x0010000D
-#define tdsTypeDAQmxRawData           0xFFFFFFFF
+ * @brief  Size of the buffers that their size is not known
+ */
+#define UnknownBufferSize     0xFFFFFFFFFFFFFFFF
+
+/**
+ * @brief  Number of values of each Channel that are interleaved together (rows
+ *         of a block stay in cache while all Channels are copied into them)
+ */
+#define InterleaveBlockLen    512
+
+/**
+ * @brief  Size of the blocks of arena of dynamic objects (Byte)
+ */
+#define ArenaBlockSize        4096
+
+/**
+ * @brief  Initial size of hash tables of dynamic objects
+ */
+#define ObjectHashInitialSize 64
+
+/**
+ * @brief  Size of offset of next Property and length of each Property that is
+ *         saved in a Property Builder (Byte)
+ */
+#define PropertyRecordLen     16
+
+/**
+ * @brief  Number of Properties of waveform Channels (wf_start_time,
+ *         wf_start_offset and wf_increment)
+ */
+#define WaveformNumOfProperties 3
+
+/**
+ * @brief  Number of Properties of DAQmx Channels (NI_Scaling_Status,
+ *         NI_Number_Of_Scales and NI_Scale[0] Properties; Polynomial_Coefficients
+ *         of polynomial scales are not counted)
+ */
+#define LinearScaleNumOfProperties      6
+#define PolynomialScaleNumOfProperties  5
+
+/**
+ * @brief  Length of index information of an object in a DAQmx raw data
+ *         segment without the path (Byte): (4B path length) + (4B index type)
+ *         + (4B data type) + (4B dimension) + (8B number of values) +
+ *         (4B number of scalers) + (20B scaler) + (4B number of widths) +
+ *         (4B width) + (4B number of properties)
+ */
+#define DAQmxObjectLen        60
+
+/**
+ * @brief  Raw data values are byte swapped when Endianness of output is not
+ *         the same as system
+ */
+#define SwapRawData           (TDMS_CONFIG_OUTPUT_ENDIANNESS != TDMS_CONFIG_SYSTEM_ENDIANNESS)
+
+/**
+ * @brief  ToC flag of all generated segments
+ */
+#define OutputToC             ((TDMS_CONFIG_OUTPUT_ENDIANNESS == 1) ? kTocBigEndian : 0)
 
 /**
  * @brief  LabVIEW Timestamp base
@@ -68,24 +104,47 @@
 #define BaseMonth   1
 #define BaseDay     1
 
+/**
+ * @brief  Seconds between LabVIEW Timestamp base and Unix epoch (1970-01-01)
+ */
+#define UnixEpochSecond       2082844800ll
+
+/**
+ * @brief  Nanoseconds to 2^-64 fractions of a second: 2^64 / 10^9 is
+ *         18446744073.709551616, so a fraction is Ns * NsToFractionInt plus
+ *         (Ns * NsToFractionFrac) >> 32 (error is less than one fraction)
+ */
+#define NsPerSecond           1000000000ll
+#define NsToFractionInt       18446744073ull
+#define NsToFractionFrac      3047500986ull
 
-/* Private Macro ----------------------------------------------------------------*/
 /**
- * @brief  Determine whether or not a year is leap year 
+ * @brief  Position of FILE streams (64 bit on Windows and POSIX systems)
  */
-#define leapYear(year) (((year % 4 == 0 && year % 100 != 0) || year % 400 == 0) \
-                            ? 1 : 0)
+#if defined(_WIN32)
+#define StreamPos_t           __int64
+#define StreamTell            _ftelli64
+#define StreamSeek            _fseeki64
+#elif (TDMS_CONFIG_POSIX == 1)
+#define StreamPos_t           off_t
+#define StreamTell            ftello
+#define StreamSeek            fseeko
+#else
+#define StreamPos_t           long
+#define StreamTell            ftell
+#define StreamSeek            fseek
+#endif
 
 
 /* Private Variables ------------------------------------------------------------*/
 /**
- * @brief  Specify the number of days in the month
- *         daysPerMonth[0][]: non leap year
- *         daysPerMonth[0][]: leap year
- */ 
-const int8_t
-    daysPerMonth[2][13] = {{-1, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31},
-                           {-1, 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31}};
+ * @brief  Path of the File object with its length, as it is saved in meta data
+ */
+#if (TDMS_CONFIG_OUTPUT_ENDIANNESS == 0)
+const uint8_t filePathBytes[5] = {0x01, 0x00, 0x00, 0x00, '/'};
+#else
+const uint8_t filePathBytes[5] = {0x00, 0x00, 0x00, 0x01, '/'};
+#endif
 
 const uint32_t dataTypeBinary[TDMS_DataType_MAX] =
 {
@@ -137,6 +196,31 @@ const uint8_t dataTypeLength[TDMS_DataType_MAX] =
   [TDMS_DataType_ComplexDoubleFloat] = 0
 };
 
+const uint32_t daqmxDataType[TDMS_DataType_MAX] =
+{
+  [TDMS_DataType_Void] = daqmxTypeNone,
+  [TDMS_DataType_I8] = daqmxTypeI8,
+  [TDMS_DataType_I16] = daqmxTypeI16,
+  [TDMS_DataType_I32] = daqmxTypeI32,
+  [TDMS_DataType_I64] = daqmxTypeI64,
+  [TDMS_DataType_U8] = daqmxTypeU8,
+  [TDMS_DataType_U16] = daqmxTypeU16,
+  [TDMS_DataType_U32] = daqmxTypeU32,
+  [TDMS_DataType_U64] = daqmxTypeU64,
+  [TDMS_DataType_SingleFloat] = daqmxTypeSingleFloat,
+  [TDMS_DataType_DoubleFloat] = daqmxTypeDoubleFloat,
+  [TDMS_DataType_ExtendedFloat] = daqmxTypeNone,
+  [TDMS_DataType_SingleFloatWithUnit] = daqmxTypeNone,
+  [TDMS_DataType_DoubleFloatWithUnit] = daqmxTypeNone,
+  [TDMS_DataType_ExtendedFloatWithUnit] = daqmxTypeNone,
+  [TDMS_DataType_String] = daqmxTypeNone,
+  [TDMS_DataType_Boolean] = daqmxTypeNone,
+  [TDMS_DataType_TimeStamp] = daqmxTypeNone,
+  [TDMS_DataType_FixedPoint] = daqmxTypeNone,
+  [TDMS_DataType_ComplexSingleFloat] = daqmxTypeNone,
+  [TDMS_DataType_ComplexDoubleFloat] = daqmxTypeNone
+};
+
 
 /**
  ==================================================================================
@@ -144,55 +228,83 @@ const uint8_t dataTypeLength[TDMS_DataType_MAX] =
  ==================================================================================
  */
 
+/**
+ * @brief  Calculate number of days between Unix epoch (1970-01-01) and a date
+ *         of proleptic Gregorian calendar in constant time
+ * @note   Years are counted from March, so the leap day is the last day of the
+ *         year, and 400 years (an era) always have 146097 days.
+ * 
+ * @param  Year: Year number
+ * @param  Month: Month number (1 to 12)
+ * @param  Day: Day number (1 to 31)
+ * @retval Number of days (negative before Unix epoch)
+ */
+static int32_t
+TDMS_DaysFromCivil(int32_t Year, uint32_t Month, uint32_t Day)
+{
+  int32_t Era = 0;
+  uint32_t YearOfEra = 0;
+  uint32_t DayOfYear = 0;
+  uint32_t DayOfEra = 0;
+
+  Year -= (Month <= 2);
+  Era = (Year >= 0 ? Year : Year - 399) / 400;
+  YearOfEra = (uint32_t) (Year - Era * 400); // 0 to 399
+  DayOfYear = (153 * (Month > 2 ? Month - 3 : Month + 9) + 2) / 5 + Day - 1;
+  DayOfEra = YearOfEra * 365 + YearOfEra / 4 - YearOfEra / 100 + DayOfYear;
+
+  return Era * 146097 + (int32_t) DayOfEra - 719468;
+}
+
+
 /**
  * @brief  Calculate number of days between LabVIEW Timestamp base and inserted
  *         date
- * @param  Day: Day number (0 to 31)
- * @param  Month: Month number (0 to 12)
+ * @param  Day: Day number (1 to 31)
+ * @param  Month: Month number (1 to 12)
  * @param  Year: Year number (1904 to ...)
  * @retval Number of days
  */
 static uint32_t
 TDMS_DateDef(uint8_t Day, uint8_t Month, uint16_t Year)
 {
-  int16_t y, m;
-  uint32_t total_days = 0;
-
   if (Year < BaseYear)
     return 0;
 
-  for (y = Year; y >= BaseYear; y--)
-  {
-    if (y == Year)
-    {
-      for (m = Month; m >= 1; m--)
-      {
-        if (m == Month)
-          total_days += Day;
-        else
-          total_days += daysPerMonth[leapYear(y)][m];
-      }
-    }
-    else if (y == BaseYear)
-    {
-      for (m = 12; m >= BaseMonth; m--)
-      {
-        if (m == BaseMonth)
-          total_days += daysPerMonth[leapYear(y)][m] - BaseDay;
-        else
-          total_days += daysPerMonth[leapYear(y)][m];
-      }
-    }
-    else
-    {
-      for (m = 12; m >= 1; m--)
-      {
-        total_days += daysPerMonth[leapYear(y)][m];
-      }
-    }
-  }
+  return (uint32_t) (TDMS_DaysFromCivil(Year, Month, Day) -
+                     TDMS_DaysFromCivil(BaseYear, BaseMonth, BaseDay));
+}
+
+
+/**
+ * @brief  Convert nanoseconds of a second to 2^-64 fractions of a second
+ * @param  Ns: Nanoseconds (0 to 999999999)
+ * @retval Fractions of a second
+ */
+static inline uint64_t
+TDMS_NsToFraction(uint32_t Ns)
+{
+  return Ns * NsToFractionInt + ((Ns * NsToFractionFrac) >> 32);
+}
+
+
+/**
+ * @brief  Split nanoseconds since Unix epoch into seconds since LabVIEW
+ *         Timestamp base and nanoseconds of the second
+ * @param  Ns: Nanoseconds since Unix epoch
+ * @param  Second: Pointer to save seconds since LabVIEW Timestamp base
+ * @retval Nanoseconds of the second (0 to 999999999)
+ */
+static inline uint32_t
+TDMS_SplitUnixNs(int64_t Ns, int64_t *Second)
+{
+  int64_t Rem = Ns % NsPerSecond;
+  // -1 if Ns is before a whole second (and Rem is negative), else 0 (no branch)
+  int64_t Borrow = -(int64_t) (Rem < 0);
+
+  *Second = Ns / NsPerSecond + UnixEpochSecond + Borrow;
 
-  return total_days;
+  return (uint32_t) (Rem + (Borrow & NsPerSecond));
 }
 
 
@@ -243,29 +355,203 @@ TDMS_GenerateChannelPath(TDMS_Group_t *Group,
 }
 
 
+#if (TDMS_CONFIG_DYNAMIC_OBJECTS == 1)
+/**
+ * @brief  Hash of path of an object (FNV-1a)
+ * @param  Path: NULL terminated path of the object
+ * @retval Hash of the path
+ */
+static uint32_t
+TDMS_HashPath(const char *Path)
+{
+  uint32_t Hash = 2166136261u;
+
+  while (*Path)
+  {
+    Hash ^= (uint8_t) *Path++;
+    Hash *= 16777619u;
+  }
+
+  return Hash;
+}
+
+
+/**
+ * @brief  Allocate memory from arena of a File
+ * @note   The memory is released by TDMS_DeInitFile.
+ *
+ * @param  File: Pointer to TDMS File object structure
+ * @param  Len: Size of the memory (Byte)
+ * @retval Pointer to the memory or Null if allocation failed
+ */
+static char *
+TDMS_ArenaAlloc(TDMS_File_t *File, uint64_t Len)
+{
+  uint8_t *Block = NULL;
+  uint64_t Size = ArenaBlockSize;
+  char *Memory = NULL;
+
+  if (File->ArenaUsed + Len > File->ArenaSize)
+  {
+    if (Len + sizeof(uint8_t *) > Size)
+      Size = Len + sizeof(uint8_t *);
+    Block = (uint8_t *) malloc((size_t) Size);
+    if (!Block)
+      return NULL;
+
+    // each block starts with pointer to the previous one
+    memcpy(Block, &File->Arena, sizeof(uint8_t *));
+    File->Arena = Block;
+    File->ArenaUsed = sizeof(uint8_t *);
+    File->ArenaSize = Size;
+  }
+
+  Memory = (char *) &File->Arena[File->ArenaUsed];
+  File->ArenaUsed += Len;
+
+  return Memory;
+}
+
+
+/**
+ * @brief  Release the last memory that is allocated from arena of a File
+ * @note   It is used when adding an object fails, so the memory is used by the
+ *         next allocation.
+ *
+ * @param  File: Pointer to TDMS File object structure
+ * @param  Len: Size of the memory (Byte)
+ * @retval None
+ */
+static void
+TDMS_ArenaRelease(TDMS_File_t *File, uint64_t Len)
+{
+  File->ArenaUsed -= Len;
+}
+
+
+/**
+ * @brief  Add a Group to hash table of its File
+ * @note   The table grows (and Groups of GroupArray are added again) when it
+ *         is half full.
+ *
+ * @param  File: Pointer to TDMS File object structure
+ * @param  Group: Pointer to TDMS Group object structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ */
+static TDMS_Result_t
+TDMS_HashGroup(TDMS_File_t *File, TDMS_Group_t *Group)
+{
+  TDMS_Group_t **GroupHash = NULL;
+  uint32_t GroupHashSize = 0;
+  uint32_t Slot = 0;
+  uint32_t CounterI = 0;
+
+  if ((File->NumOfGroups + 1) * 2 > File->GroupHashSize)
+  {
+    GroupHashSize = File->GroupHashSize ?
+                    (File->GroupHashSize << 1) : ObjectHashInitialSize;
+    GroupHash = (TDMS_Group_t **) calloc(GroupHashSize, sizeof(TDMS_Group_t *));
+    if (!GroupHash)
+      return TDMS_NO_MEMORY;
+    free(File->GroupHash);
+    File->GroupHash = GroupHash;
+    File->GroupHashSize = GroupHashSize;
+
+    for (CounterI = 0; CounterI < File->NumOfGroups; CounterI++)
+    {
+      Slot = TDMS_HashPath(File->GroupArray[CounterI]->GroupPath) &
+             (GroupHashSize - 1);
+      while (GroupHash[Slot])
+        Slot = (Slot + 1) & (GroupHashSize - 1);
+      GroupHash[Slot] = File->GroupArray[CounterI];
+    }
+  }
+
+  Slot = TDMS_HashPath(Group->GroupPath) & (File->GroupHashSize - 1);
+  while (File->GroupHash[Slot])
+    Slot = (Slot + 1) & (File->GroupHashSize - 1);
+  File->GroupHash[Slot] = Group;
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Add a Channel to hash table of its File
+ * @note   The table grows (and Channels of all Groups are added again) when it
+ *         is half full.
+ *
+ * @param  File: Pointer to TDMS File object structure
+ * @param  Channel: Pointer to TDMS Channel object structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ */
+static TDMS_Result_t
+TDMS_HashChannel(TDMS_File_t *File, TDMS_Channel_t *Channel)
+{
+  TDMS_Channel_t **ChannelHash = NULL;
+  TDMS_Group_t *Group = NULL;
+  uint32_t ChannelHashSize = 0;
+  uint32_t Slot = 0;
+  uint32_t CounterI = 0;
+  uint32_t CounterJ = 0;
+
+  if (((uint64_t) File->NumOfChannels + 1) * 2 > File->ChannelHashSize)
+  {
+    ChannelHashSize = File->ChannelHashSize ?
+                      (File->ChannelHashSize << 1) : ObjectHashInitialSize;
+    ChannelHash = (TDMS_Channel_t **) calloc(ChannelHashSize,
+                                             sizeof(TDMS_Channel_t *));
+    if (!ChannelHash)
+      return TDMS_NO_MEMORY;
+    free(File->ChannelHash);
+    File->ChannelHash = ChannelHash;
+    File->ChannelHashSize = ChannelHashSize;
+
+    for (CounterI = 0; CounterI < File->NumOfGroups; CounterI++)
+    {
+      Group = File->GroupArray[CounterI];
+      for (CounterJ = 0; CounterJ < Group->NumOfChannels; CounterJ++)
+      {
+        Slot = TDMS_HashPath(Group->ChannelArray[CounterJ]->ChannelPath) &
+               (ChannelHashSize - 1);
+        while (ChannelHash[Slot])
+          Slot = (Slot + 1) & (ChannelHashSize - 1);
+        ChannelHash[Slot] = Group->ChannelArray[CounterJ];
+      }
+    }
+  }
+
+  Slot = TDMS_HashPath(Channel->ChannelPath) & (File->ChannelHashSize - 1);
+  while (File->ChannelHash[Slot])
+    Slot = (Slot + 1) & (File->ChannelHashSize - 1);
+  File->ChannelHash[Slot] = Channel;
+  File->NumOfChannels++;
+
+  return TDMS_OK;
+}
+#endif
+
+
 /**
- * @brief  Saves a 32 bit data in Little Endian format into a pointed area
+ * @brief  Saves a 32 bit data of meta data in output Endianness into a pointed
+ *         area
  * @param  data: Pointer to array that value save into
  * @param  value: 32 bit data
  * @retval 4
  */
 static uint8_t
-TDMS_SaveDataLittleEndian32(uint8_t *data, uint32_t value)
+TDMS_SaveData32(uint8_t *data, uint32_t value)
 {
-  typedef union
-  {
-    uint32_t  Uint32Value;
-    uint8_t   Uint8Value[4];
-  } U32toU8_t;
-
-  U32toU8_t Buffer = {.Uint32Value = value,};
-  
   for (uint8_t i = 0; i < 4; i++)
   {
-#if (TDMS_CONFIG_SYSTEM_ENDIANNESS == 0)
-    data[i] = Buffer.Uint8Value[i];
+#if (TDMS_CONFIG_OUTPUT_ENDIANNESS == 0)
+    data[i] = (uint8_t) (value >> (i * 8));
 #else
-    data[i] = Buffer.Uint8Value[4-i];
+    data[i] = (uint8_t) (value >> ((3 - i) * 8));
 #endif
   }
   
@@ -274,32 +560,49 @@ TDMS_SaveDataLittleEndian32(uint8_t *data, uint32_t value)
 
 
 /**
- * @brief  Saves a 64 bit data in Little Endian format into a pointed area
+ * @brief  Saves a 64 bit data of meta data in output Endianness into a pointed
+ *         area
  * @param  data: Pointer to array that value save into
  * @param  value: 64 bit data
  * @retval 8
  */
 static uint8_t
-TDMS_SaveDataLittleEndian64(uint8_t *data, uint64_t value)
+TDMS_SaveData64(uint8_t *data, uint64_t value)
 {
-  typedef union
+  for (uint8_t i = 0; i < 8; i++)
   {
-    uint32_t  Uint64Value;
-    uint8_t   Uint8Value[8];
-  } U64toU8_t;
-  
-  U64toU8_t Buffer = {.Uint64Value = value,};
+#if (TDMS_CONFIG_OUTPUT_ENDIANNESS == 0)
+    data[i] = (uint8_t) (value >> (i * 8));
+#else
+    data[i] = (uint8_t) (value >> ((7 - i) * 8));
+#endif
+  }
+
+  return 8;
+}
+
+
+/**
+ * @brief  Loads a 64 bit data of meta data in output Endianness from a pointed
+ *         area
+ * @param  data: Pointer to array that value is loaded from
+ * @retval 64 bit data
+ */
+static uint64_t
+TDMS_LoadData64(const uint8_t *data)
+{
+  uint64_t value = 0;
 
   for (uint8_t i = 0; i < 8; i++)
   {
-#if (TDMS_CONFIG_SYSTEM_ENDIANNESS == 0)
-    data[i] = Buffer.Uint8Value[i];
+#if (TDMS_CONFIG_OUTPUT_ENDIANNESS == 0)
+    value |= ((uint64_t) data[i]) << (i * 8);
 #else
-    data[i] = Buffer.Uint8Value[8-i];
+    value |= ((uint64_t) data[i]) << ((7 - i) * 8);
 #endif
   }
 
-  return 8;
+  return value;
 }
 
 
@@ -316,17 +619,55 @@ TDMS_SaveStrToMetaDataPart(uint8_t *data, const char *str)
   
   StringLen = strlen(str);
   // write length of str and calculate total number of bytes written
-  StringLen += TDMS_SaveDataLittleEndian32(data, StringLen);
+  TDMS_SaveData32(data, StringLen);
   
-  strcpy((char *) &data[4], str); // write str to data location
+  memcpy(&data[4], str, StringLen); // write str to data location
   
-  return StringLen;
+  return StringLen + 4;
+}
+
+
+/**
+ * @brief  Stores a path that is already in standard TDMS format (length
+ *         followed by the path) into pointed area
+ * @param  data: Pointer to area that value save into.
+ * @param  PathBytes: Pointer to the length and the path
+ * @param  PathLen: Length of the path
+ * @retval Number of bytes written into array.
+ */
+static uint32_t
+TDMS_SavePathToMetaDataPart(uint8_t *data,
+                            const uint8_t *PathBytes, uint32_t PathLen)
+{
+  memcpy(data, PathBytes, PathLen + 4);
+
+  return PathLen + 4;
+}
+
+
+/**
+ * @brief  Writes the tag of TDMS segment Lead IN part
+ * @param  LeadInSTR: Pointer to area that Lead In part footprint stores into
+ * @param  Tag: TAG_TDSm_Num for TDMS file and TAG_TDSh_Num for TDMS index file
+ * @retval None
+ */
+static void
+TDMS_GenerateLeadInTag(uint8_t *LeadInSTR, uint32_t Tag)
+{
+  uint8_t CounterI = 0;
+
+  for(CounterI=0; CounterI<4; CounterI++)
+    LeadInSTR[CounterI] = (Tag)>>(24-CounterI*8); //Big Endian
 }
 
 
 /**
  * @brief  Generates TDMS segment Lead IN part
  * @param  LeadInSTR: Pointer to area that Lead In part footprint stores into
+ * @note   ToC is always little-endian. Version and offsets are saved in output
+ *         Endianness, and kTocBigEndian is added to ToC when the output is
+ *         big-endian.
+ * 
  * @param  ToC_value: Indicate what kind of data the segment contains
  * @param  NextSegmentOffset_value: describe the length of the remaining segment
  *                                  (overall length of the segment minus length of
@@ -344,756 +685,5603 @@ TDMS_GenerateLeadInPart(uint8_t *LeadInSTR,
   uint8_t CounterI = 0;
   uint8_t CounterJ = 0;
   
-  for(CounterI=0; CounterI<4; CounterI++, CounterJ++)
-    LeadInSTR[CounterJ] = (TAG_TDSm_Num)>>(24-CounterI*8); //Big Endian
+  TDMS_GenerateLeadInTag(LeadInSTR, TAG_TDSm_Num);
+  CounterJ += 4;
+
+  ToC_value |= OutputToC;
     
   for(CounterI=0; CounterI<4; CounterI++, CounterJ++)
     LeadInSTR[CounterJ] = (ToC_value&0x000000EE)>>(CounterI*8); // Little Endian
     
-  for(CounterI=0; CounterI<4; CounterI++, CounterJ++)
-    LeadInSTR[CounterJ] = (Version_Number4713)>>(24-CounterI*8);
-    
-  for(CounterI=0; CounterI<8; CounterI++, CounterJ++)
-    LeadInSTR[CounterJ] = (NextSegmentOffset_value)>>(CounterI*8);
-    
-  for(CounterI=0; CounterI<8; CounterI++, CounterJ++)
-    LeadInSTR[CounterJ] = (RawDataOffset_value)>>(CounterI*8);
+  CounterJ += TDMS_SaveData32(&LeadInSTR[CounterJ], Version_Number4713);
+  CounterJ += TDMS_SaveData64(&LeadInSTR[CounterJ], NextSegmentOffset_value);
+  TDMS_SaveData64(&LeadInSTR[CounterJ], RawDataOffset_value);
+}
 
+
+/**
+ * @brief  Loads ToC of a generated TDMS segment Lead IN part
+ * @param  LeadInSTR: Pointer to Lead In part
+ * @retval ToC (always little-endian)
+ */
+static uint32_t
+TDMS_LoadLeadInToC(const uint8_t *LeadInSTR)
+{
+  uint32_t ToC_value = 0;
+  uint8_t CounterI = 0;
+
+  for (CounterI = 0; CounterI < 4; CounterI++)
+    ToC_value |= ((uint32_t) LeadInSTR[4 + CounterI]) << (CounterI * 8);
+
+  return ToC_value;
 }
 
 
 /**
- * @brief  Add Property to the object
- * @note   To use this function, you must first create and initialize the File and
- *         use TDMS_GenFirstPart
- * 
- * @param  Path: Object path
- * @param  Buffer: Pointer to the buffer that data save in
- * @note   If the buffer address is Null, then function only calculates needed
- *         buffer size
- * 
- * @param  Size: Size of data in buffer (Byte)
- * @param  Name: Name of Property
- * @param  DataType: Data type of Property
- * @param  Value: Pointer to the value of Property
- * @retval TDMS_Result_t
- *         - TDMS_OK: Operation was successful
- *         - TDMS_WRONG_ARG: Wrong argument
+ * @brief  Forget object list of previous raw data segment of the file
+ * @param  File: Pointer to TDMS File object structure
+ * @retval None
  */
-static TDMS_Result_t
-TDMS_AddPropertyToObject(char *Path,
-                        uint8_t *Buffer, uint32_t *Size,
-                        char *Name, TDMS_Data_t DataType, void *Value)
+static void
+TDMS_InvalidateLayout(TDMS_File_t *File)
 {
-  uint32_t DataSize = 0;
-  uint32_t MetaDataLen = 0;
-  uint32_t PropertyDataLen = 0;
+  TDMS_Channel_t *Channel = File->LayoutFirst;
+  TDMS_Channel_t *Next = NULL;
 
-  PropertyDataLen = dataTypeLength[DataType];
-  if (PropertyDataLen == 0 && DataType != TDMS_DataType_String)
-    return TDMS_WRONG_ARG;
-  
-  /*** ***/
-  /*** Meta Data len calculation ***/
-  /*** ***/
-  // (4B number of objects) +
-  // (4B file path length) +
-  // (4B raw data index) + (4B number of properties)
-  // (4B property name length) +
-  // (4B property data type)
-  MetaDataLen += 24;
-  MetaDataLen += strlen(Path); // Group path length
-  MetaDataLen += strlen(Name); // Property name length
-  if(DataType == TDMS_DataType_String)
+  while (Channel)
   {
-    // (4B string length)
-    MetaDataLen += 4;
-    MetaDataLen += strlen((const char *)Value); // String length
+    Next = (TDMS_Channel_t *) Channel->LayoutNext;
+    Channel->LayoutNext = NULL;
+    Channel->LayoutNumOfValues = 0;
+    Channel = Next;
   }
-  else
-    MetaDataLen += PropertyDataLen;
-  
-  
-  /*** ***/
-  /*** if Buffer address is NULL, return back. ***/
-  /*** ***/
-  if(Buffer == NULL)
-  {
-    DataSize = LeadInPartLen + MetaDataLen;
-    *Size = DataSize;
-    
-    return TDMS_OK;
+
+  File->LayoutFirst = NULL;
+}
+
+
+/**
+ * @brief  Check if Channels of a raw data segment have the same object list and
+ *         raw data index of previous raw data segment of the file
+ * @param  File: Pointer to TDMS File object structure
+ * @param  Channels: Array of Channels of the segment (ChunkNumOfValues of each
+ *                   Channel must be set)
+ * @param  NumOfChannels: Number of Channels in array
+ * @retval 1: same layout, 0: different layout
+ */
+static uint8_t
+TDMS_IsSameLayout(TDMS_File_t *File,
+                  TDMS_Channel_t **Channels, uint32_t NumOfChannels)
+{
+  TDMS_Channel_t *Layout = File->LayoutFirst;
+  uint32_t CounterI = 0;
+
+  if (!Layout)
+    return 0;
+
+  for (CounterI = 0; CounterI < NumOfChannels; CounterI++)
+  {
+    if (!Channels[CounterI]->ChunkNumOfValues)
+      continue;
+
+    if (Layout != Channels[CounterI] ||
+        Layout->LayoutNumOfValues != Channels[CounterI]->ChunkNumOfValues)
+      return 0;
+
+    Layout = (TDMS_Channel_t *) Layout->LayoutNext;
   }
-  
-  
+
+  return (Layout == NULL) ? 1 : 0;
+}
+
+
+/**
+ * @brief  Save object list and raw data index of a raw data segment as the
+ *         layout of the file
+ * @param  File: Pointer to TDMS File object structure
+ * @param  Channels: Array of Channels of the segment (ChunkNumOfValues of each
+ *                   Channel must be set)
+ * @param  NumOfChannels: Number of Channels in array
+ * @retval None
+ */
+static void
+TDMS_SaveLayout(TDMS_File_t *File,
+                TDMS_Channel_t **Channels, uint32_t NumOfChannels)
+{
+  TDMS_Channel_t *Last = NULL;
+  uint32_t CounterI = 0;
+
+  TDMS_InvalidateLayout(File);
+
+  for (CounterI = 0; CounterI < NumOfChannels; CounterI++)
+  {
+    if (!Channels[CounterI]->ChunkNumOfValues)
+      continue;
+
+    Channels[CounterI]->LayoutNumOfValues = Channels[CounterI]->ChunkNumOfValues;
+    if (Last)
+      Last->LayoutNext = (void *) Channels[CounterI];
+    else
+      File->LayoutFirst = Channels[CounterI];
+    Last = Channels[CounterI];
+  }
+}
+
+
+/**
+ * @brief  Count the values of waveform Channels of a raw data segment
+ * @note   wf_start_time of the first part of next files (rotating Writer) is
+ *         moved by them.
+ * 
+ * @param  Channels: Array of Channels of the segment (ChunkNumOfValues of each
+ *                   Channel must be set)
+ * @param  NumOfChannels: Number of Channels in array
+ * @retval None
+ */
+static void
+TDMS_CountWaveformValues(TDMS_Channel_t **Channels, uint32_t NumOfChannels)
+{
+  uint32_t CounterI = 0;
+
+  for (CounterI = 0; CounterI < NumOfChannels; CounterI++)
+    if (Channels[CounterI]->Waveform)
+      Channels[CounterI]->WfNumOfValues += Channels[CounterI]->ChunkNumOfValues;
+}
+
+
+/**
+ * @brief  Copy Boolean values and convert them to 0 and 1
+ * @param  Dest: Pointer to destination (can be the same as Src)
+ * @param  Src: Pointer to data values
+ * @param  NumOfValues: Number of values
+ * @retval None
+ */
+static void
+TDMS_NormalizeBoolean(uint8_t *Dest, const uint8_t *Src, uint64_t NumOfValues)
+{
+  uint64_t CounterI = 0;
+
+#if defined(__SSE2__)
+  const __m128i Zero = _mm_setzero_si128();
+  const __m128i One = _mm_set1_epi8(1);
+
+  for (; CounterI + 16 <= NumOfValues; CounterI += 16)
+  {
+    __m128i Value = _mm_loadu_si128((const __m128i *) &Src[CounterI]);
+    _mm_storeu_si128((__m128i *) &Dest[CounterI],
+                     _mm_andnot_si128(_mm_cmpeq_epi8(Value, Zero), One));
+  }
+#endif
+
+  for (; CounterI < NumOfValues; CounterI++)
+    Dest[CounterI] = (Src[CounterI]) ? 1 : 0;
+}
+
+
+#if defined(__SSE2__)
+/**
+ * @brief  Reverse bytes of each element of a register
+ * @param  Value: Register
+ * @param  Width: Size of each element (2, 4 or 8 Byte)
+ * @retval Swapped elements
+ */
+static inline __m128i
+TDMS_SwapSSE2(__m128i Value, uint32_t Width)
+{
+  // bytes of 16 bit words, then words of 32 bit and 32 bit of 64 bit elements
+  Value = _mm_or_si128(_mm_slli_epi16(Value, 8), _mm_srli_epi16(Value, 8));
+  if (Width >= 4)
+  {
+    Value = _mm_shufflelo_epi16(Value, _MM_SHUFFLE(2, 3, 0, 1));
+    Value = _mm_shufflehi_epi16(Value, _MM_SHUFFLE(2, 3, 0, 1));
+  }
+  if (Width == 8)
+    Value = _mm_shuffle_epi32(Value, _MM_SHUFFLE(2, 3, 0, 1));
+
+  return Value;
+}
+#endif
+
+
+/**
+ * @brief  Copy values and reverse bytes of each value
+ * @param  Dest: Pointer to destination (can be the same as Src)
+ * @param  Src: Pointer to data values
+ * @param  Width: Size of each value (Byte)
+ * @param  NumOfValues: Number of values
+ * @retval None
+ */
+static void
+TDMS_SwapBytes(uint8_t *Dest, const uint8_t *Src,
+               uint32_t Width, uint64_t NumOfValues)
+{
+  uint64_t Len = Width * NumOfValues;
+  uint64_t Pos = 0;
+  uint32_t CounterI = 0;
+  uint8_t Value[8];
+
+#if defined(__SSE2__)
+  if (Width == 2 || Width == 4 || Width == 8)
+  {
+    for (; Pos + 16 <= Len; Pos += 16)
+      _mm_storeu_si128((__m128i *) &Dest[Pos],
+                       TDMS_SwapSSE2(_mm_loadu_si128((const __m128i *) &Src[Pos]),
+                                     Width));
+  }
+#endif
+
+  for (; Pos + Width <= Len; Pos += Width)
+  {
+    for (CounterI = 0; CounterI < Width && CounterI < 8; CounterI++)
+      Value[CounterI] = Src[Pos + Width - 1 - CounterI];
+    memcpy(&Dest[Pos], Value, CounterI);
+  }
+}
+
+
+/**
+ * @brief  Check if values of a data type are saved as they are in memory
+ * @param  DataType: Data type of the values
+ * @retval 1: values are copied, 0: values are converted by TDMS_ConvertValues
+ */
+static inline uint8_t
+TDMS_IsNativeRawData(TDMS_Data_t DataType)
+{
+  // Booleans are saved as 0 and 1
+  if (DataType == TDMS_DataType_Boolean)
+    return 0;
+
+  // TDMS_Timestamp_t is a little-endian 128 bit value only on little-endian
+  // systems
+  if (DataType == TDMS_DataType_TimeStamp)
+    return (TDMS_CONFIG_SYSTEM_ENDIANNESS == 0 &&
+            TDMS_CONFIG_OUTPUT_ENDIANNESS == 0) ? 1 : 0;
+
+  return (!SwapRawData || dataTypeLength[DataType] <= 1) ? 1 : 0;
+}
+
+
+/**
+ * @brief  Copy values and convert them to output Endianness (and Booleans to 0
+ *         and 1)
+ * @param  Dest: Pointer to destination (can be the same as Src)
+ * @param  Src: Pointer to data values
+ * @param  DataType: Data type of the values
+ * @param  NumOfValues: Number of values
+ * @retval None
+ */
+static void
+TDMS_ConvertValues(uint8_t *Dest, const uint8_t *Src,
+                   TDMS_Data_t DataType, uint64_t NumOfValues)
+{
+  uint64_t CounterI = 0;
+  uint64_t Half = 0;
+
+  if (TDMS_IsNativeRawData(DataType))
+  {
+    if (Dest != Src)
+      memcpy(Dest, Src, (size_t) (dataTypeLength[DataType] * NumOfValues));
+    return;
+  }
+
+  if (DataType == TDMS_DataType_Boolean)
+  {
+    TDMS_NormalizeBoolean(Dest, Src, NumOfValues);
+    return;
+  }
+
+  if (DataType != TDMS_DataType_TimeStamp)
+  {
+    TDMS_SwapBytes(Dest, Src, dataTypeLength[DataType], NumOfValues);
+    return;
+  }
+
+  // Timestamp: each field in output Endianness, and Second before Fraction in
+  // big-endian output
+  if (SwapRawData)
+    TDMS_SwapBytes(Dest, Src, 8, NumOfValues * 2);
+  else if (Dest != Src)
+    memcpy(Dest, Src, (size_t) (dataTypeLength[DataType] * NumOfValues));
+
+  for (CounterI = 0;
+       CounterI < NumOfValues && TDMS_CONFIG_OUTPUT_ENDIANNESS == 1;
+       CounterI++)
+  {
+    memcpy(&Half, &Dest[CounterI * 16], 8);
+    memmove(&Dest[CounterI * 16], &Dest[CounterI * 16 + 8], 8);
+    memcpy(&Dest[CounterI * 16 + 8], &Half, 8);
+  }
+}
+
+
+/**
+ * @brief  Convert interleaved raw data to output Endianness (and Booleans to 0
+ *         and 1) in place
+ * @param  Frames: Pointer to interleaved raw data
+ * @param  Channels: Array of Channels of the raw data
+ * @param  NumOfChannels: Number of Channels in array
+ * @param  NumOfFrames: Number of frames (values of each Channel)
+ * @retval None
+ */
+static void
+TDMS_ConvertFrames(uint8_t *Frames, TDMS_Channel_t **Channels,
+                   uint32_t NumOfChannels, uint64_t NumOfFrames)
+{
+  uint64_t CounterI = 0;
+  uint32_t CounterJ = 0;
+  TDMS_Data_t DataType;
+
+  for (CounterI = 0; CounterI < NumOfFrames; CounterI++)
+  {
+    for (CounterJ = 0; CounterJ < NumOfChannels; CounterJ++)
+    {
+      DataType = Channels[CounterJ]->ChannelDataType;
+      if (!TDMS_IsNativeRawData(DataType))
+        TDMS_ConvertValues(Frames, Frames, DataType, 1);
+      Frames += dataTypeLength[DataType];
+    }
+  }
+}
+
+
+/**
+ * @brief  Copy values of a Channel into its column of interleaved raw data
+ * @param  Dest: Pointer to the column in first row of raw data
+ * @param  Src: Pointer to data values
+ * @param  Width: Size of each value (Byte)
+ * @param  RowLen: Size of each row of raw data (Byte)
+ * @param  NumOfValues: Number of values
+ * @retval None
+ */
+static void
+TDMS_InterleaveChannel(uint8_t *Dest, const uint8_t *Src,
+                       uint32_t Width, uint32_t RowLen, uint64_t NumOfValues)
+{
+  uint64_t CounterI = 0;
+
+  switch (Width)
+  {
+  case 1:
+    for (CounterI = 0; CounterI < NumOfValues; CounterI++)
+      Dest[CounterI * RowLen] = Src[CounterI];
+    break;
+
+  case 2:
+    for (CounterI = 0; CounterI < NumOfValues; CounterI++)
+      memcpy(&Dest[CounterI * RowLen], &Src[CounterI * 2], 2);
+    break;
+
+  case 4:
+    for (CounterI = 0; CounterI < NumOfValues; CounterI++)
+      memcpy(&Dest[CounterI * RowLen], &Src[CounterI * 4], 4);
+    break;
+
+  case 8:
+    for (CounterI = 0; CounterI < NumOfValues; CounterI++)
+      memcpy(&Dest[CounterI * RowLen], &Src[CounterI * 8], 8);
+    break;
+
+  default:
+    for (CounterI = 0; CounterI < NumOfValues; CounterI++)
+      memcpy(&Dest[CounterI * RowLen], &Src[CounterI * Width], Width);
+    break;
+  }
+}
+
+
+#if defined(__SSE2__)
+/**
+ * @brief  Interleave low or high halves of two registers
+ * @param  A: First register
+ * @param  B: Second register
+ * @param  Width: Size of each element (1, 2, 4 or 8 Byte)
+ * @param  High: 0 for low halves, 1 for high halves
+ * @retval Interleaved elements
+ */
+static inline __m128i
+TDMS_UnpackSSE2(__m128i A, __m128i B, uint32_t Width, uint8_t High)
+{
+  switch (Width)
+  {
+  case 1:
+    return High ? _mm_unpackhi_epi8(A, B) : _mm_unpacklo_epi8(A, B);
+  case 2:
+    return High ? _mm_unpackhi_epi16(A, B) : _mm_unpacklo_epi16(A, B);
+  case 4:
+    return High ? _mm_unpackhi_epi32(A, B) : _mm_unpacklo_epi32(A, B);
+  default:
+    return High ? _mm_unpackhi_epi64(A, B) : _mm_unpacklo_epi64(A, B);
+  }
+}
+
+
+/**
+ * @brief  Interleave values of 2 or 4 Channels with the same data type size
+ *         using SSE2 (16 Bytes of each Channel per step)
+ * @param  Dest: Pointer to raw data
+ * @param  Channels: Array of 2 or 4 Channels (ChunkValues must be set)
+ * @param  NumOfChannels: Number of Channels in array (2 or 4)
+ * @param  Width: Size of each value (1, 2, 4 or 8 Byte)
+ * @param  NumOfValues: Number of values of each Channel
+ * @retval Number of values that are interleaved (the rest must be interleaved
+ *         by TDMS_InterleaveChannel)
+ */
+static uint64_t
+TDMS_InterleaveSSE2(uint8_t *Dest, TDMS_Channel_t **Channels,
+                    uint32_t NumOfChannels, uint32_t Width, uint64_t NumOfValues)
+{
+  const uint8_t *SrcA = (const uint8_t *) Channels[0]->ChunkValues;
+  const uint8_t *SrcB = (const uint8_t *) Channels[1]->ChunkValues;
+  const uint8_t *SrcC = NULL;
+  const uint8_t *SrcD = NULL;
+  uint64_t Step = 16 / Width;
+  uint64_t CounterI = 0;
+  __m128i A, B, C, D, AB0, AB1, CD0, CD1;
+
+  if (NumOfChannels == 4)
+  {
+    SrcC = (const uint8_t *) Channels[2]->ChunkValues;
+    SrcD = (const uint8_t *) Channels[3]->ChunkValues;
+  }
+
+  for (CounterI = 0; CounterI + Step <= NumOfValues; CounterI += Step)
+  {
+    A = _mm_loadu_si128((const __m128i *) &SrcA[CounterI * Width]);
+    B = _mm_loadu_si128((const __m128i *) &SrcB[CounterI * Width]);
+    AB0 = TDMS_UnpackSSE2(A, B, Width, 0);
+    AB1 = TDMS_UnpackSSE2(A, B, Width, 1);
+
+    if (NumOfChannels == 2)
+    {
+      _mm_storeu_si128((__m128i *) &Dest[0], AB0);
+      _mm_storeu_si128((__m128i *) &Dest[16], AB1);
+      Dest += 32;
+      continue;
+    }
+
+    C = _mm_loadu_si128((const __m128i *) &SrcC[CounterI * Width]);
+    D = _mm_loadu_si128((const __m128i *) &SrcD[CounterI * Width]);
+    CD0 = TDMS_UnpackSSE2(C, D, Width, 0);
+    CD1 = TDMS_UnpackSSE2(C, D, Width, 1);
+
+    // pairs of AB and CD are interleaved again with double width
+    if (Width == 8)
+    {
+      _mm_storeu_si128((__m128i *) &Dest[0], AB0);
+      _mm_storeu_si128((__m128i *) &Dest[16], CD0);
+      _mm_storeu_si128((__m128i *) &Dest[32], AB1);
+      _mm_storeu_si128((__m128i *) &Dest[48], CD1);
+    }
+    else
+    {
+      _mm_storeu_si128((__m128i *) &Dest[0], TDMS_UnpackSSE2(AB0, CD0, Width * 2, 0));
+      _mm_storeu_si128((__m128i *) &Dest[16], TDMS_UnpackSSE2(AB0, CD0, Width * 2, 1));
+      _mm_storeu_si128((__m128i *) &Dest[32], TDMS_UnpackSSE2(AB1, CD1, Width * 2, 0));
+      _mm_storeu_si128((__m128i *) &Dest[48], TDMS_UnpackSSE2(AB1, CD1, Width * 2, 1));
+    }
+    Dest += 64;
+  }
+
+  return CounterI;
+}
+#endif
+
+
+/**
+ * @brief  Interleave values of Channels into raw data (one row per value)
+ * @param  Dest: Pointer to raw data
+ * @param  Channels: Array of Channels (ChunkValues must be set)
+ * @param  NumOfChannels: Number of Channels in array
+ * @param  NumOfValues: Number of values of each Channel
+ * @retval None
+ */
+static void
+TDMS_InterleaveValues(uint8_t *Dest, TDMS_Channel_t **Channels,
+                      uint32_t NumOfChannels, uint64_t NumOfValues)
+{
+  uint32_t Width = dataTypeLength[Channels[0]->ChannelDataType];
+  uint32_t RowLen = 0;
+  uint32_t Offset = 0;
+  uint8_t SameWidth = 1;
+  uint64_t Done = 0;
+  uint64_t BlockLen = 0;
+  uint32_t CounterI = 0;
+
+  for (CounterI = 0; CounterI < NumOfChannels; CounterI++)
+  {
+    if (dataTypeLength[Channels[CounterI]->ChannelDataType] != Width)
+      SameWidth = 0;
+    RowLen += dataTypeLength[Channels[CounterI]->ChannelDataType];
+  }
+
+#if defined(__SSE2__)
+  if (SameWidth && Width <= 8 && (Width & (Width - 1)) == 0 &&
+      (NumOfChannels == 2 || NumOfChannels == 4))
+    Done = TDMS_InterleaveSSE2(Dest, Channels, NumOfChannels, Width, NumOfValues);
+#else
+  (void) SameWidth;
+#endif
+
+  for (; Done < NumOfValues; Done += BlockLen)
+  {
+    BlockLen = NumOfValues - Done;
+    if (BlockLen > InterleaveBlockLen)
+      BlockLen = InterleaveBlockLen;
+
+    Offset = 0;
+    for (CounterI = 0; CounterI < NumOfChannels; CounterI++)
+    {
+      Width = dataTypeLength[Channels[CounterI]->ChannelDataType];
+      TDMS_InterleaveChannel(&Dest[Done * RowLen + Offset],
+                             (const uint8_t *) Channels[CounterI]->ChunkValues +
+                                 Done * Width,
+                             Width, RowLen, BlockLen);
+      Offset += Width;
+    }
+  }
+}
+
+
+/**
+ * @brief  Saves meta data of a raw data segment with new object list
+ * @param  data: Pointer to area that meta data save into
+ * @param  Channels: Array of Channels of the segment (ChunkNumOfValues of each
+ *                   Channel must be set, Channels without values are skipped)
+ *
+ * @param  NumOfChannels: Number of Channels in array
+ * @param  NumOfObjects: Number of Channels that have values
+ * @param  NumOfValuesOffset: Array to save offset of number of values of each
+ *                            Channel in data (0: Channel has no values), or
+ *                            Null
+ *
+ * @param  DAQmxWidth: Size of a frame of DAQmx raw data (Byte), or 0 if the
+ *                     Channels are not DAQmx Channels
+ *
+ * @retval Number of bytes written into array.
+ */
+static uint64_t
+TDMS_SaveObjectList(uint8_t *data,
+                    TDMS_Channel_t **Channels, uint32_t NumOfChannels,
+                    uint32_t NumOfObjects, uint64_t *NumOfValuesOffset,
+                    uint32_t DAQmxWidth)
+{
+  TDMS_Channel_t *Channel = NULL;
+  uint64_t DataSize = 0;
+  uint32_t ByteOffset = 0;
+  uint32_t CounterI = 0;
+
+  DataSize += TDMS_SaveData32(&data[DataSize],
+                              NumOfObjects); // Number of objects
+  for (CounterI = 0; CounterI < NumOfChannels; CounterI++)
+  {
+    Channel = Channels[CounterI];
+    if (NumOfValuesOffset)
+      NumOfValuesOffset[CounterI] = 0;
+    if (!Channel->ChunkNumOfValues)
+      continue;
+
+    DataSize += TDMS_SavePathToMetaDataPart(&data[DataSize],
+                                            Channel->ChannelPathBytes,
+                                            Channel->ChannelPathLen); // Channel path
+
+    if (DAQmxWidth)
+    {
+      DataSize += TDMS_SaveData32(&data[DataSize],
+                                  DAQmxFormatChangingScaler); // DAQmx raw data index
+      DataSize += TDMS_SaveData32(&data[DataSize],
+                                  tdsTypeDAQmxRawData); // Data type
+    }
+    else
+    {
+      DataSize += TDMS_SaveData32(&data[DataSize],
+                                  0x14); // Length of index information
+      DataSize += TDMS_SaveData32(&data[DataSize],
+                                  dataTypeBinary[Channel->ChannelDataType]); // Data type of the raw data assigned to this object
+    }
+    DataSize += TDMS_SaveData32(&data[DataSize],
+                                0x01); // Dimension of the raw data array (must be 1)
+    if (NumOfValuesOffset)
+      NumOfValuesOffset[CounterI] = DataSize;
+    DataSize += TDMS_SaveData64(&data[DataSize],
+                                Channel->ChunkNumOfValues); // Number of raw data Values
+
+    if (DAQmxWidth)
+    {
+      DataSize += TDMS_SaveData32(&data[DataSize],
+                                  1); // Number of format changing scalers
+      DataSize += TDMS_SaveData32(&data[DataSize],
+                                  daqmxDataType[Channel->ChannelDataType]); // DAQmx data type
+      DataSize += TDMS_SaveData32(&data[DataSize],
+                                  0); // Raw buffer index
+      DataSize += TDMS_SaveData32(&data[DataSize],
+                                  ByteOffset); // Byte offset of the value in a frame
+      DataSize += TDMS_SaveData32(&data[DataSize],
+                                  0); // Sample format bitmap
+      DataSize += TDMS_SaveData32(&data[DataSize],
+                                  0); // Scale ID
+      DataSize += TDMS_SaveData32(&data[DataSize],
+                                  1); // Number of raw data widths
+      DataSize += TDMS_SaveData32(&data[DataSize],
+                                  DAQmxWidth); // Raw data width (size of a frame)
+      ByteOffset += dataTypeLength[Channel->ChannelDataType];
+    }
+
+    DataSize += TDMS_SaveData32(&data[DataSize],
+                                0); // Number of properties
+  }
+
+  return DataSize;
+}
+
+
+/**
+ * @brief  Generate a raw data segment for some Channels of a File
+ * @note   If the Channels, their data types and their number of values are the
+ *         same as previous raw data segment of the file, only Lead In part and
+ *         raw data are generated (kTocRawData segment). Otherwise, a new object
+ *         list with meta data is generated.
+ * 
+ * @param  File: Pointer to TDMS File object structure
+ * @param  Channels: Array of Channels of the segment. ChunkValues and
+ *                   ChunkNumOfValues of each Channel must be set. Channels
+ *                   with no values are ignored.
+ * 
+ * @param  NumOfChannels: Number of Channels in array
+ * @param  Interleaved: 1 to generate interleaved raw data (kTocInterleavedData).
+ *                      All of the Channels must have the same number of values.
+ *                      DAQmx Channels are always interleaved (kTocDAQmxRawData)
+ *                      and can not be mixed with other Channels.
+ * 
+ * @param  Frames: Pointer to raw data that is already interleaved (ChunkValues
+ *                 of Channels are not used). If it is Null and Interleaved is
+ *                 1, values of the Channels are interleaved into the buffer.
+ * 
+ * @param  Buffer: Pointer to the buffer that data save in
+ * @note   If the buffer address is Null, then function only calculates needed
+ *         buffer size and returns TDMS_OK.
+ * 
+ * @param  BufferSize: Size of the buffer (Byte)
+ * @param  Size: Size of data in buffer (Byte)
+ * @param  IoVec: Pointer to an array of NumOfChannels + 1 elements (2 elements
+ *                for interleaved raw data). If it is not Null, raw data is not
+ *                copied into the buffer. The first element points to the Lead
+ *                In part and meta data in buffer and the next elements point to
+ *                raw data of the Channels (or Frames). Values of Channels that
+ *                must be interleaved or converted (Booleans and values in other
+ *                byte order) are still generated in the buffer.
+ * 
+ * @param  NumOfIoVec: Number of used elements of IoVec
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_OUT_OF_CAP: Buffer is smaller than Size (nothing is generated)
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+static TDMS_Result_t
+TDMS_GenDataSegment(TDMS_File_t *File,
+                    TDMS_Channel_t **Channels, uint32_t NumOfChannels,
+                    uint8_t Interleaved, const void *Frames,
+                    uint8_t *Buffer, uint64_t BufferSize, uint64_t *Size,
+                    TDMS_IoVec_t *IoVec, uint32_t *NumOfIoVec)
+{
+  uint64_t DataSize = 0;
+  uint64_t RawDataLen = 0; // Bytes
+  uint64_t MetaDataLen = 0;
+  uint64_t BufferRawDataLen = 0;
+  uint64_t ConvertLen = 0;
+  uint64_t Len = 0;
+  uint32_t NumberOfObjects = 0;
+  uint32_t DAQmxWidth = 0;
+  uint32_t CounterI = 0;
+  uint8_t SameLayout = 0;
+  uint8_t DAQmx = 0;
+  TDMS_Channel_t *Channel = NULL;
+
+  if (NumOfChannels)
+    DAQmx = Channels[0]->DAQmx;
+  if (DAQmx)
+    Interleaved = 1;
+
   /*** ***/
-  /*** generate lead in part ***/
+  /*** Raw Data & Meta Data len calculation ***/
   /*** ***/
-  TDMS_GenerateLeadInPart(&Buffer[DataSize],
-                          kTocNewObjList | kTocMetaData,
-                          MetaDataLen,
-                          MetaDataLen);
+  SameLayout = TDMS_IsSameLayout(File, Channels, NumOfChannels);
+  MetaDataLen = 4; // Number of objects
+  for (CounterI = 0; CounterI < NumOfChannels; CounterI++)
+  {
+    Channel = Channels[CounterI];
+    if (Interleaved && Channel->ChunkNumOfValues != Channels[0]->ChunkNumOfValues)
+      return TDMS_WRONG_ARG;
+    if (Channel->DAQmx != DAQmx)
+      return TDMS_WRONG_ARG;
+    if (!Channel->ChunkNumOfValues)
+      continue;
+
+    if (dataTypeLength[Channel->ChannelDataType] == 0)
+      return TDMS_WRONG_ARG;
+    Len = dataTypeLength[Channel->ChannelDataType] * Channel->ChunkNumOfValues;
+    RawDataLen += Len;
+    if (!TDMS_IsNativeRawData(Channel->ChannelDataType))
+      ConvertLen += Len;
+
+    // (4B channel path length) + (4B length of index information) +
+    // (4B data type) + (4B dimension) + (8B number of values) +
+    // (4B number of properties)
+    MetaDataLen += DAQmx ? DAQmxObjectLen : 28;
+    MetaDataLen += Channel->ChannelPathLen; // Channel path
+    DAQmxWidth += dataTypeLength[Channel->ChannelDataType];
+    NumberOfObjects++;
+  }
+
+  if (IoVec)
+    *NumOfIoVec = 0;
+
+  if (!NumberOfObjects)
+  {
+    *Size = 0;
+    return TDMS_OK;
+  }
+
+  if (SameLayout)
+    MetaDataLen = 0;
+
+  // raw data that is generated in the buffer (values that must be converted
+  // to output Endianness or to 0 and 1 are not passed to IoVec)
+  if (!IoVec || (Interleaved && (!Frames || ConvertLen)))
+    BufferRawDataLen = RawDataLen;
+  else if (!Interleaved)
+    BufferRawDataLen = ConvertLen;
+
+
+  /*** ***/
+  /*** if Buffer address is NULL, return back. ***/
+  /*** ***/
+  if (Buffer == NULL)
+  {
+    *Size = LeadInPartLen + MetaDataLen + BufferRawDataLen;
+
+    return TDMS_OK;
+  }
+
+  if (BufferSize < LeadInPartLen + MetaDataLen + BufferRawDataLen)
+  {
+    *Size = LeadInPartLen + MetaDataLen + BufferRawDataLen;
+
+    return TDMS_OUT_OF_CAP;
+  }
+
+
+  /*** ***/
+  /*** generate lead in part ***/
+  /*** ***/
+  TDMS_GenerateLeadInPart(&Buffer[DataSize],
+                          (SameLayout ? kTocRawData :
+                                        kTocRawData | kTocNewObjList | kTocMetaData) |
+                          (DAQmx ? kTocDAQmxRawData :
+                                   (Interleaved ? kTocInterleavedData : 0)),
+                          MetaDataLen + RawDataLen,
+                          MetaDataLen);
+  DataSize += LeadInPartLen;
+
+  /*** ***/
+  /*** generate meta data ***/
+  /*** ***/
+  if (!SameLayout)
+  {
+    DataSize += TDMS_SaveObjectList(&Buffer[DataSize],
+                                    Channels, NumOfChannels,
+                                    NumberOfObjects, NULL,
+                                    DAQmx ? DAQmxWidth : 0);
+
+    TDMS_SaveLayout(File, Channels, NumOfChannels);
+  }
+
+  /*** ***/
+  /*** write RAW data ***/
+  /*** ***/
+  if (Interleaved && BufferRawDataLen)
+  {
+    if (Frames)
+      memcpy(&Buffer[DataSize], Frames, (size_t) RawDataLen);
+    else
+      TDMS_InterleaveValues(&Buffer[DataSize], Channels, NumOfChannels,
+                            Channels[0]->ChunkNumOfValues);
+    if (ConvertLen)
+      TDMS_ConvertFrames(&Buffer[DataSize], Channels, NumOfChannels,
+                         Channels[0]->ChunkNumOfValues);
+    DataSize += RawDataLen;
+  }
+
+  if (IoVec)
+  {
+    IoVec[0].Base = Buffer;
+    IoVec[0].Len = DataSize;
+    *NumOfIoVec = 1;
+  }
+
+  if (Interleaved && !BufferRawDataLen)
+  {
+    IoVec[1].Base = Frames;
+    IoVec[1].Len = RawDataLen;
+    *NumOfIoVec = 2;
+  }
+
+  for (CounterI = 0; CounterI < NumOfChannels && !Interleaved; CounterI++)
+  {
+    Channel = Channels[CounterI];
+    if (!Channel->ChunkNumOfValues)
+      continue;
+
+    Len = dataTypeLength[Channel->ChannelDataType] * Channel->ChunkNumOfValues;
+    if (IoVec && TDMS_IsNativeRawData(Channel->ChannelDataType))
+    {
+      IoVec[*NumOfIoVec].Base = Channel->ChunkValues;
+      IoVec[*NumOfIoVec].Len = Len;
+      (*NumOfIoVec)++;
+      continue;
+    }
+
+    TDMS_ConvertValues(&Buffer[DataSize], (const uint8_t *) Channel->ChunkValues,
+                       Channel->ChannelDataType, Channel->ChunkNumOfValues);
+    if (IoVec)
+    {
+      IoVec[*NumOfIoVec].Base = &Buffer[DataSize];
+      IoVec[*NumOfIoVec].Len = Len;
+      (*NumOfIoVec)++;
+    }
+    DataSize += Len;
+  }
+
+  *Size = DataSize;
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Generate a raw data segment in a buffer of the user and count the
+ *         values of its waveform Channels
+ * @note   The user saves the buffer, so values are counted once it is
+ *         generated. Writers count them after the sink saved the segment.
+ * 
+ * @param  File: Pointer to TDMS File object structure
+ * @param  Channels: Array of Channels of the segment
+ * @param  NumOfChannels: Number of Channels in array
+ * @param  Interleaved: 1 to generate interleaved raw data
+ * @param  Frames: Pointer to raw data that is already interleaved or Null
+ * @param  Buffer: Pointer to the buffer that data save in (Null: only the size
+ *                 is calculated)
+ * 
+ * @param  Size: Size of data in buffer (Byte)
+ * @param  IoVec: Pointer to an array of I/O vectors or Null
+ * @param  NumOfIoVec: Number of used elements of IoVec
+ * @retval TDMS_Result_t (like TDMS_GenDataSegment)
+ */
+static TDMS_Result_t
+TDMS_GenBufferDataSegment(TDMS_File_t *File,
+                          TDMS_Channel_t **Channels, uint32_t NumOfChannels,
+                          uint8_t Interleaved, const void *Frames,
+                          uint8_t *Buffer, uint64_t *Size,
+                          TDMS_IoVec_t *IoVec, uint32_t *NumOfIoVec)
+{
+  TDMS_Result_t Result = TDMS_OK;
+
+  Result = TDMS_GenDataSegment(File, Channels, NumOfChannels,
+                               Interleaved, Frames,
+                               Buffer, UnknownBufferSize, Size,
+                               IoVec, NumOfIoVec);
+  if (Result == TDMS_OK && Buffer)
+    TDMS_CountWaveformValues(Channels, NumOfChannels);
+
+  return Result;
+}
+
+
+/**
+ * @brief  Generate a raw data segment with the values of a string Channel
+ * @note   String raw data is an array of end offsets of the strings (uint32_t)
+ *         followed by the concatenated strings. Its size changes with the
+ *         strings, so the segment always has a new object list and the next raw
+ *         data segment of the file has a new object list too.
+ * 
+ * @param  Channel: Pointer to TDMS Channel object structure
+ * @param  Strings: Array of pointers to the strings (Null: Packed is used)
+ * @param  Lengths: Array of lengths of the strings (Null: strings are NULL
+ *                  terminated)
+ * 
+ * @param  Packed: Pointer to the concatenated strings (if Strings is Null)
+ * @param  PackedLen: Length of Packed (Byte)
+ * @param  EndOffsets: Array of end offsets of the strings in Packed (if Strings
+ *                     is Null, not decreasing and not more than PackedLen)
+ * 
+ * @param  NumOfValues: Number of strings
+ * @param  Buffer: Pointer to the buffer that data save in
+ * @note   If the buffer address is Null, then function only calculates needed
+ *         buffer size and returns TDMS_OK.
+ * 
+ * @param  BufferSize: Size of the buffer (Byte)
+ * @param  Size: Size of data in buffer (Byte)
+ * @param  IoVec: Pointer to an array of 3 elements. If it is not Null, packed
+ *                strings and their end offsets (if they are in output
+ *                Endianness) are not copied into the buffer.
+ * 
+ * @param  NumOfIoVec: Number of used elements of IoVec
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_OUT_OF_CAP: Buffer is smaller than Size (nothing is generated)
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+static TDMS_Result_t
+TDMS_GenStringSegment(TDMS_Channel_t *Channel,
+                      const char * const *Strings, const uint32_t *Lengths,
+                      const char *Packed, uint64_t PackedLen,
+                      const uint32_t *EndOffsets, uint64_t NumOfValues,
+                      uint8_t *Buffer, uint64_t BufferSize, uint64_t *Size,
+                      TDMS_IoVec_t *IoVec, uint32_t *NumOfIoVec)
+{
+  TDMS_Group_t *Group = (TDMS_Group_t *) Channel->GroupOfChannel;
+  uint64_t DataSize = 0;
+  uint64_t StringsLen = 0;
+  uint64_t RawDataLen = 0; // Bytes
+  uint64_t MetaDataLen = 0;
+  uint64_t BufferRawDataLen = 0;
+  uint64_t Len = 0;
+  uint64_t CounterI = 0;
+  uint8_t *Offsets = NULL;
+
+  if (Channel->ChannelDataType != TDMS_DataType_String || NumOfValues == 0)
+    return TDMS_WRONG_ARG;
+
+  /*** ***/
+  /*** Raw Data & Meta Data len calculation ***/
+  /*** ***/
+  if (Strings)
+  {
+    for (CounterI = 0; CounterI < NumOfValues; CounterI++)
+      StringsLen += Lengths ? Lengths[CounterI] : strlen(Strings[CounterI]);
+  }
+  else
+  {
+    // readers take the strings from the end offsets, so they must be in Packed
+    for (CounterI = 1; CounterI < NumOfValues; CounterI++)
+      if (EndOffsets[CounterI] < EndOffsets[CounterI - 1])
+        return TDMS_WRONG_ARG;
+    StringsLen = EndOffsets[NumOfValues - 1];
+    if (StringsLen > PackedLen)
+      return TDMS_WRONG_ARG;
+  }
+  // end offsets are 32 bit
+  if (StringsLen > UINT32_MAX)
+    return TDMS_WRONG_ARG;
+  RawDataLen = 4 * NumOfValues + StringsLen;
+
+  // (4B number of objects) + (4B channel path length) +
+  // (4B length of index information) + (4B data type) + (4B dimension) +
+  // (8B number of values) + (8B total size) + (4B number of properties)
+  MetaDataLen = 40;
+  MetaDataLen += Channel->ChannelPathLen; // Channel path
+
+  // raw data that is generated in the buffer (packed strings and their end
+  // offsets in output Endianness are passed to IoVec)
+  BufferRawDataLen = RawDataLen;
+  if (IoVec && !Strings)
+    BufferRawDataLen = TDMS_IsNativeRawData(TDMS_DataType_U32) ?
+                       0 : 4 * NumOfValues;
+
+
+  /*** ***/
+  /*** if Buffer address is NULL, return back. ***/
+  /*** ***/
+  *Size = LeadInPartLen + MetaDataLen + BufferRawDataLen;
+  if (Buffer == NULL)
+    return TDMS_OK;
+
+  if (BufferSize < LeadInPartLen + MetaDataLen + BufferRawDataLen)
+    return TDMS_OUT_OF_CAP;
+
+
+  /*** ***/
+  /*** generate lead in part ***/
+  /*** ***/
+  TDMS_GenerateLeadInPart(&Buffer[DataSize],
+                          kTocRawData | kTocNewObjList | kTocMetaData,
+                          MetaDataLen + RawDataLen,
+                          MetaDataLen);
   DataSize += LeadInPartLen;
 
+  /*** ***/
+  /*** generate meta data ***/
+  /*** ***/
+  DataSize += TDMS_SaveData32(&Buffer[DataSize],
+                              1); // Number of objects
+  DataSize += TDMS_SavePathToMetaDataPart(&Buffer[DataSize],
+                                          Channel->ChannelPathBytes,
+                                          Channel->ChannelPathLen); // Channel path
+  DataSize += TDMS_SaveData32(&Buffer[DataSize],
+                              0x1C); // Length of index information
+  DataSize += TDMS_SaveData32(&Buffer[DataSize],
+                              dataTypeBinary[TDMS_DataType_String]); // Data type
+  DataSize += TDMS_SaveData32(&Buffer[DataSize],
+                              0x01); // Dimension of the raw data array
+  DataSize += TDMS_SaveData64(&Buffer[DataSize],
+                              NumOfValues); // Number of raw data Values
+  DataSize += TDMS_SaveData64(&Buffer[DataSize],
+                              RawDataLen); // Total size of raw data (Byte)
+  DataSize += TDMS_SaveData32(&Buffer[DataSize],
+                              0); // Number of properties
+
+  TDMS_InvalidateLayout((TDMS_File_t *) Group->FileOfGroup);
+
+  /*** ***/
+  /*** write RAW data ***/
+  /*** ***/
+  if (Strings)
+  {
+    // end offsets and concatenated strings in one pass
+    Offsets = &Buffer[DataSize];
+    DataSize += 4 * NumOfValues;
+    StringsLen = 0;
+    for (CounterI = 0; CounterI < NumOfValues; CounterI++)
+    {
+      Len = Lengths ? Lengths[CounterI] : strlen(Strings[CounterI]);
+      memcpy(&Buffer[DataSize], Strings[CounterI], (size_t) Len);
+      DataSize += Len;
+      StringsLen += Len;
+      TDMS_SaveData32(&Offsets[4 * CounterI], (uint32_t) StringsLen);
+    }
+  }
+  else if (BufferRawDataLen)
+  {
+    TDMS_ConvertValues(&Buffer[DataSize], (const uint8_t *) EndOffsets,
+                       TDMS_DataType_U32, NumOfValues);
+    DataSize += 4 * NumOfValues;
+    if (!IoVec)
+    {
+      memcpy(&Buffer[DataSize], Packed, (size_t) StringsLen);
+      DataSize += StringsLen;
+    }
+  }
+
+  if (IoVec)
+  {
+    IoVec[0].Base = Buffer;
+    IoVec[0].Len = DataSize;
+    *NumOfIoVec = 1;
+    if (!Strings && !BufferRawDataLen)
+    {
+      IoVec[*NumOfIoVec].Base = EndOffsets;
+      IoVec[*NumOfIoVec].Len = 4 * NumOfValues;
+      (*NumOfIoVec)++;
+    }
+    if (!Strings && StringsLen)
+    {
+      IoVec[*NumOfIoVec].Base = Packed;
+      IoVec[*NumOfIoVec].Len = StringsLen;
+      (*NumOfIoVec)++;
+    }
+  }
+
+  *Size = DataSize;
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Calculate length of a Property in meta data
+ * @param  Name: Name of Property
+ * @param  DataType: Data type of Property
+ * @param  Value: Pointer to the value of Property
+ * @retval Length of Property (Byte) or 0 if the data type is not supported
+ */
+static uint64_t
+TDMS_PropertyLen(const char *Name, TDMS_Data_t DataType, const void *Value)
+{
+  uint64_t Len = 0;
+
+  if (DataType >= TDMS_DataType_MAX ||
+      (dataTypeLength[DataType] == 0 && DataType != TDMS_DataType_String))
+    return 0;
+
+  // (4B property name length) + (4B property data type)
+  Len = 8;
+  Len += strlen(Name); // Property name length
+  if (DataType == TDMS_DataType_String)
+  {
+    // (4B string length)
+    Len += 4;
+    Len += strlen((const char *) Value); // String length
+  }
+  else
+    Len += dataTypeLength[DataType];
+
+  return Len;
+}
+
+
+/**
+ * @brief  Stores name, data type and value of a Property into pointed area
+ * @param  data: Pointer to area that Property save into
+ * @param  Name: Name of Property
+ * @param  DataType: Data type of Property
+ * @param  Value: Pointer to the value of Property
+ * @retval Number of bytes written into array.
+ */
+static uint64_t
+TDMS_SavePropertyToMetaDataPart(uint8_t *data, const char *Name,
+                                TDMS_Data_t DataType, const void *Value)
+{
+  uint64_t DataSize = 0;
+
+  DataSize += TDMS_SaveStrToMetaDataPart(&data[DataSize],
+                                         Name); // Property name
+  DataSize += TDMS_SaveData32(&data[DataSize],
+                              dataTypeBinary[DataType]); // Data type of the property value
+
+  if (DataType == TDMS_DataType_String)
+  {
+    DataSize += TDMS_SaveStrToMetaDataPart(&data[DataSize],
+                                           (const char *) Value); // Value of the property
+  }
+  else
+  {
+    TDMS_ConvertValues(&data[DataSize], (const uint8_t *) Value,
+                       DataType, 1);
+    DataSize += dataTypeLength[DataType];
+  }
+
+  return DataSize;
+}
+
+
+/**
+ * @brief  Find slot of an object in hash table of a Property Builder
+ * @param  Builder: Pointer to TDMS Property Builder object structure
+ * @param  PathBytes: Path of the object in meta data format
+ * @retval Index of the slot of the object or the empty slot that it is added to
+ */
+static uint32_t
+TDMS_PropertyBuilderSlot(TDMS_PropertyBuilder_t *Builder,
+                         const uint8_t *PathBytes)
+{
+  uint32_t Mask = Builder->ObjectHashSize - 1;
+  uint32_t Slot = 0;
+  uint32_t Index = 0;
+
+  // objects are identified by address of their path
+  Slot = (uint32_t) (((uintptr_t) PathBytes >> 2) * 2654435761u) & Mask;
+  while ((Index = Builder->ObjectHash[Slot]) != 0)
+  {
+    if (Builder->Objects[Index - 1].PathBytes == PathBytes)
+      break;
+    Slot = (Slot + 1) & Mask;
+  }
+
+  return Slot;
+}
+
+
+/**
+ * @brief  Find an object of a Property Builder
+ * @param  Builder: Pointer to TDMS Property Builder object structure
+ * @param  PathBytes: Path of the object in meta data format
+ * @retval Pointer to the object or Null if it has no Property
+ */
+static TDMS_PropertyObject_t *
+TDMS_PropertyBuilderFind(TDMS_PropertyBuilder_t *Builder,
+                         const uint8_t *PathBytes)
+{
+  uint32_t Index = 0;
+
+  if (!Builder || !Builder->NumOfObjects)
+    return NULL;
+
+  Index = Builder->ObjectHash[TDMS_PropertyBuilderSlot(Builder, PathBytes)];
+
+  return Index ? &Builder->Objects[Index - 1] : NULL;
+}
+
+
+/**
+ * @brief  Add an object to a Property Builder
+ * @param  Builder: Pointer to TDMS Property Builder object structure
+ * @param  PathBytes: Path of the object in meta data format
+ * @param  PathLen: Length of object path
+ * @param  Channel: Pointer to Channel of the object (Null for File and Groups)
+ * @retval Pointer to the object or Null if memory allocation failed
+ */
+static TDMS_PropertyObject_t *
+TDMS_PropertyBuilderAddObject(TDMS_PropertyBuilder_t *Builder,
+                              const uint8_t *PathBytes, uint32_t PathLen,
+                              TDMS_Channel_t *Channel)
+{
+  TDMS_PropertyObject_t *Objects = NULL;
+  TDMS_PropertyObject_t *Object = NULL;
+  uint32_t *Hash = NULL;
+  uint32_t HashSize = 0;
+  uint32_t CounterI = 0;
+
+  if (Builder->NumOfObjects == Builder->ObjectsSize)
+  {
+    Objects = (TDMS_PropertyObject_t *)
+        realloc(Builder->Objects, (Builder->ObjectsSize ? Builder->ObjectsSize * 2 : 16) *
+                                  sizeof(TDMS_PropertyObject_t));
+    if (!Objects)
+      return NULL;
+    Builder->Objects = Objects;
+    Builder->ObjectsSize = Builder->ObjectsSize ? Builder->ObjectsSize * 2 : 16;
+  }
+
+  // keep the hash table at most half full
+  if ((Builder->NumOfObjects + 1) * 2 > Builder->ObjectHashSize)
+  {
+    HashSize = Builder->ObjectHashSize ? Builder->ObjectHashSize * 2 :
+                                         ObjectHashInitialSize;
+    Hash = (uint32_t *) calloc(HashSize, sizeof(uint32_t));
+    if (!Hash)
+      return NULL;
+    free(Builder->ObjectHash);
+    Builder->ObjectHash = Hash;
+    Builder->ObjectHashSize = HashSize;
+    for (CounterI = 0; CounterI < Builder->NumOfObjects; CounterI++)
+      Builder->ObjectHash[TDMS_PropertyBuilderSlot(Builder,
+                                                   Builder->Objects[CounterI].PathBytes)] =
+          CounterI + 1;
+  }
+
+  Object = &Builder->Objects[Builder->NumOfObjects];
+  Object->PathBytes = PathBytes;
+  Object->PathLen = PathLen;
+  Object->Channel = Channel;
+  Object->NumOfProperties = 0;
+  Object->PropertiesLen = 0;
+  Object->First = 0;
+  Object->Last = 0;
+  Builder->ObjectHash[TDMS_PropertyBuilderSlot(Builder, PathBytes)] =
+      ++Builder->NumOfObjects;
+
+  return Object;
+}
+
+
+/**
+ * @brief  Add Property to an object of a Property Builder
+ * @param  Builder: Pointer to TDMS Property Builder object structure
+ * @param  PathBytes: Object path in meta data format (length followed by path)
+ * @param  PathLen: Length of object path
+ * @param  Channel: Pointer to Channel of the object (Null for File and Groups)
+ * @param  Name: Name of Property
+ * @param  DataType: Data type of Property
+ * @param  Value: Pointer to the value of Property
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ */
+static TDMS_Result_t
+TDMS_PropertyBuilderAdd(TDMS_PropertyBuilder_t *Builder,
+                        const uint8_t *PathBytes, uint32_t PathLen,
+                        TDMS_Channel_t *Channel,
+                        const char *Name, TDMS_Data_t DataType,
+                        const void *Value)
+{
+  TDMS_PropertyObject_t *Object = NULL;
+  uint8_t *Properties = NULL;
+  uint64_t PropertiesSize = Builder->PropertiesSize;
+  uint64_t Offset = Builder->PropertiesLen;
+  uint64_t Next = 0;
+  uint64_t Len = 0;
+
+  if (!Name || !Value)
+    return TDMS_WRONG_ARG;
+
+  Len = TDMS_PropertyLen(Name, DataType, Value);
+  if (!Len)
+    return TDMS_WRONG_ARG;
+
+  if (Offset + PropertyRecordLen + Len > PropertiesSize)
+  {
+    if (!PropertiesSize)
+      PropertiesSize = TDMS_CONFIG_WRITER_BUFFER_SIZE;
+    while (PropertiesSize < Offset + PropertyRecordLen + Len)
+      PropertiesSize *= 2;
+    if (PropertiesSize > SIZE_MAX)
+      return TDMS_NO_MEMORY;
+
+    Properties = (uint8_t *) realloc(Builder->Properties, (size_t) PropertiesSize);
+    if (!Properties)
+      return TDMS_NO_MEMORY;
+    Builder->Properties = Properties;
+    Builder->PropertiesSize = PropertiesSize;
+  }
+
+  Object = TDMS_PropertyBuilderFind(Builder, PathBytes);
+  if (!Object)
+    Object = TDMS_PropertyBuilderAddObject(Builder, PathBytes, PathLen, Channel);
+  if (!Object)
+    return TDMS_NO_MEMORY;
+
+  // link the Property to the previous Property of the object
+  memcpy(&Builder->Properties[Offset], &Next, 8);
+  memcpy(&Builder->Properties[Offset + 8], &Len, 8);
+  TDMS_SavePropertyToMetaDataPart(&Builder->Properties[Offset + PropertyRecordLen],
+                                  Name, DataType, Value);
+  if (Object->NumOfProperties)
+    memcpy(&Builder->Properties[Object->Last], &Offset, 8);
+  else
+    Object->First = Offset;
+
+  Object->Last = Offset;
+  Object->NumOfProperties++;
+  Object->PropertiesLen += Len;
+  Builder->PropertiesLen += PropertyRecordLen + Len;
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Calculate length of waveform Properties of a Channel in meta data
+ * @param  Channel: Pointer to TDMS Channel object structure
+ * @retval Length of the Properties (0 if Channel is not a waveform)
+ */
+static uint64_t
+TDMS_WaveformPropertiesLen(TDMS_Channel_t *Channel)
+{
+  double StartOffset = 0.0;
+
+  if (!Channel->Waveform)
+    return 0;
+
+  return TDMS_PropertyLen("wf_start_time", TDMS_DataType_TimeStamp,
+                          &Channel->WfStartTime) +
+         TDMS_PropertyLen("wf_start_offset", TDMS_DataType_DoubleFloat,
+                          &StartOffset) +
+         TDMS_PropertyLen("wf_increment", TDMS_DataType_DoubleFloat,
+                          &Channel->WfIncrement);
+}
+
+
+/**
+ * @brief  Add a number of seconds to a Timestamp
+ * @param  Timestamp: Pointer to TDMS Timestamp structure
+ * @param  Seconds: Number of seconds (not negative)
+ * @retval None
+ */
+static void
+TDMS_TimestampAddSeconds(TDMS_Timestamp_t *Timestamp, double Seconds)
+{
+  int64_t Whole = (int64_t) Seconds;
+  uint64_t Fraction = 0;
+
+  // fraction is in 2^-64 seconds (shifted to keep the highest bit of double)
+  Fraction = ((uint64_t) ((Seconds - (double) Whole) * 9223372036854775808.0)) << 1;
+  Timestamp->Second += Whole;
+  Timestamp->Fraction += Fraction;
+  if (Timestamp->Fraction < Fraction)
+    Timestamp->Second++;
+}
+
+
+/**
+ * @brief  Stores waveform Properties of a Channel into pointed area
+ * @note   wf_samples is not saved. The first part is saved before the values,
+ *         so the number of samples is not known. Readers take it from the
+ *         raw data.
+ * @note   wf_start_time is the time of the first value that is not saved yet
+ *         (WfStartTime in the first file).
+ * 
+ * @param  data: Pointer to area that Properties save into
+ * @param  Channel: Pointer to TDMS Channel object structure
+ * @retval Number of bytes written into array (0 if Channel is not a waveform).
+ */
+static uint64_t
+TDMS_SaveWaveformProperties(uint8_t *data, TDMS_Channel_t *Channel)
+{
+  uint64_t DataSize = 0;
+  TDMS_Timestamp_t StartTime;
+  double StartOffset = 0.0;
+
+  if (!Channel->Waveform)
+    return 0;
+
+  StartTime = Channel->WfStartTime;
+  if (Channel->WfNumOfValues)
+    TDMS_TimestampAddSeconds(&StartTime,
+                             (double) Channel->WfNumOfValues *
+                             Channel->WfIncrement);
+
+  DataSize += TDMS_SavePropertyToMetaDataPart(&data[DataSize], "wf_start_time",
+                                              TDMS_DataType_TimeStamp,
+                                              &StartTime);
+  DataSize += TDMS_SavePropertyToMetaDataPart(&data[DataSize], "wf_start_offset",
+                                              TDMS_DataType_DoubleFloat,
+                                              &StartOffset);
+  DataSize += TDMS_SavePropertyToMetaDataPart(&data[DataSize], "wf_increment",
+                                              TDMS_DataType_DoubleFloat,
+                                              &Channel->WfIncrement);
+
+  return DataSize;
+}
+
+
+/**
+ * @brief  Stores a scale Property of a DAQmx Channel into pointed area
+ * @param  data: Pointer to area that Property save into (Null: only length is
+ *               calculated)
+ * 
+ * @param  Name: Name of Property
+ * @param  DataType: Data type of Property
+ * @param  Value: Pointer to the value of Property
+ * @retval Number of bytes written into array.
+ */
+static uint64_t
+TDMS_SaveScaleProperty(uint8_t *data, const char *Name,
+                       TDMS_Data_t DataType, const void *Value)
+{
+  if (!data)
+    return TDMS_PropertyLen(Name, DataType, Value);
+
+  return TDMS_SavePropertyToMetaDataPart(data, Name, DataType, Value);
+}
+
+
+/**
+ * @brief  Calculate number of scale Properties of a Channel
+ * @param  Channel: Pointer to TDMS Channel object structure
+ * @retval Number of the Properties (0 if Channel is not a DAQmx Channel)
+ */
+static uint32_t
+TDMS_ScaleNumOfProperties(TDMS_Channel_t *Channel)
+{
+  if (!Channel->DAQmx)
+    return 0;
+
+  if (Channel->Scale.Type == TDMS_ScaleType_Polynomial)
+    return PolynomialScaleNumOfProperties + Channel->Scale.NumOfCoefficients;
+
+  return LinearScaleNumOfProperties;
+}
+
+
+/**
+ * @brief  Stores scale Properties of a DAQmx Channel into pointed area
+ * @note   Raw values are saved unscaled with one scale that its input is the
+ *         raw data (NI_Scale[0]), so readers apply the scale.
+ * 
+ * @param  data: Pointer to area that Properties save into (Null: only length is
+ *               calculated)
+ * 
+ * @param  Channel: Pointer to TDMS Channel object structure
+ * @retval Number of bytes written into array (0 if Channel is not a DAQmx
+ *         Channel).
+ */
+static uint64_t
+TDMS_SaveScaleProperties(uint8_t *data, TDMS_Channel_t *Channel)
+{
+  uint64_t DataSize = 0;
+  uint32_t NumOfScales = 1;
+  uint32_t InputSource = 0xFFFFFFFF; // raw data
+  uint32_t CounterI = 0;
+  char Name[64];
+
+  if (!Channel->DAQmx)
+    return 0;
+
+  DataSize += TDMS_SaveScaleProperty(data ? &data[DataSize] : NULL,
+                                     "NI_Scaling_Status",
+                                     TDMS_DataType_String, "unscaled");
+  DataSize += TDMS_SaveScaleProperty(data ? &data[DataSize] : NULL,
+                                     "NI_Number_Of_Scales",
+                                     TDMS_DataType_U32, &NumOfScales);
+
+  if (Channel->Scale.Type == TDMS_ScaleType_Polynomial)
+  {
+    DataSize += TDMS_SaveScaleProperty(data ? &data[DataSize] : NULL,
+                                       "NI_Scale[0]_Scale_Type",
+                                       TDMS_DataType_String, "Polynomial");
+    DataSize += TDMS_SaveScaleProperty(data ? &data[DataSize] : NULL,
+                                       "NI_Scale[0]_Polynomial_Coefficients_Size",
+                                       TDMS_DataType_U32,
+                                       &Channel->Scale.NumOfCoefficients);
+    for (CounterI = 0; CounterI < Channel->Scale.NumOfCoefficients; CounterI++)
+    {
+      snprintf(Name, sizeof(Name), "NI_Scale[0]_Polynomial_Coefficients[%lu]",
+               (unsigned long) CounterI);
+      DataSize += TDMS_SaveScaleProperty(data ? &data[DataSize] : NULL, Name,
+                                         TDMS_DataType_DoubleFloat,
+                                         &Channel->Scale.Coefficients[CounterI]);
+    }
+    DataSize += TDMS_SaveScaleProperty(data ? &data[DataSize] : NULL,
+                                       "NI_Scale[0]_Polynomial_Input_Source",
+                                       TDMS_DataType_U32, &InputSource);
+  }
+  else
+  {
+    DataSize += TDMS_SaveScaleProperty(data ? &data[DataSize] : NULL,
+                                       "NI_Scale[0]_Scale_Type",
+                                       TDMS_DataType_String, "Linear");
+    DataSize += TDMS_SaveScaleProperty(data ? &data[DataSize] : NULL,
+                                       "NI_Scale[0]_Linear_Slope",
+                                       TDMS_DataType_DoubleFloat,
+                                       &Channel->Scale.Slope);
+    DataSize += TDMS_SaveScaleProperty(data ? &data[DataSize] : NULL,
+                                       "NI_Scale[0]_Linear_Y_Intercept",
+                                       TDMS_DataType_DoubleFloat,
+                                       &Channel->Scale.Intercept);
+    DataSize += TDMS_SaveScaleProperty(data ? &data[DataSize] : NULL,
+                                       "NI_Scale[0]_Linear_Input_Source",
+                                       TDMS_DataType_U32, &InputSource);
+  }
+
+  return DataSize;
+}
+
+
+/**
+ * @brief  Stores number of Properties and Properties of an object of a Property
+ *         Builder into pointed area
+ * @param  data: Pointer to area that Properties save into
+ * @param  Builder: Pointer to TDMS Property Builder object structure
+ * @param  Object: Pointer to the object or Null (no Property)
+ * @param  NumOfOtherProperties: Number of Properties that the caller saves after
+ *                               the Properties of the object
+ * 
+ * @retval Number of bytes written into array.
+ */
+static uint64_t
+TDMS_SaveObjectProperties(uint8_t *data, TDMS_PropertyBuilder_t *Builder,
+                          TDMS_PropertyObject_t *Object,
+                          uint32_t NumOfOtherProperties)
+{
+  uint64_t DataSize = 0;
+  uint64_t Offset = 0;
+  uint64_t Len = 0;
+  uint32_t CounterI = 0;
+
+  DataSize += TDMS_SaveData32(&data[DataSize],
+                              (Object ? Object->NumOfProperties : 0) +
+                              NumOfOtherProperties); // Number of properties
+  if (!Object)
+    return DataSize;
+
+  Offset = Object->First;
+  for (CounterI = 0; CounterI < Object->NumOfProperties; CounterI++)
+  {
+    memcpy(&Len, &Builder->Properties[Offset + 8], 8);
+    memcpy(&data[DataSize], &Builder->Properties[Offset + PropertyRecordLen],
+           (size_t) Len);
+    DataSize += Len;
+    memcpy(&Offset, &Builder->Properties[Offset], 8);
+  }
+
+  return DataSize;
+}
+
+
+/**
+ * @brief  Generate First part of TDMS file
+ * @param  File: Pointer to TDMS File object structure
+ * @param  Builder: Pointer to Property Builder that its Properties are saved
+ *                  in object list, or Null
+ *
+ * @param  Buffer: Pointer to the buffer that data save in
+ * @note   If the buffer address is Null, then function only calculates needed
+ *         buffer size
+ * 
+ * @param  BufferSize: Size of the buffer (Byte)
+ * @param  Size: Size of data in buffer (Byte)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_OUT_OF_CAP: Buffer is smaller than Size (nothing is generated)
+ */
+static TDMS_Result_t
+TDMS_GenFirstPartSegment(TDMS_File_t *File,
+                         TDMS_PropertyBuilder_t *Builder,
+                         uint8_t *Buffer,
+                         uint64_t BufferSize,
+                         uint64_t *Size)
+{
+  uint32_t CounterI = 0;
+  uint32_t CounterJ = 0;
+  uint32_t nog = 0; // Number Of Groups
+  uint32_t tnoc = 0; //  Total Number Of Channel
+  uint32_t noo = 0; //  Number Of Objects
+  uint64_t MetaDataLen = 0;
+  uint64_t DataSize = 0;
+  TDMS_PropertyObject_t *Object = NULL;
+  
+  #define RawDataLen	0
+  
+  /*** ***/
+  /*** calculate number of objects ***/
+  /*** ***/
+  nog = File->NumOfGroups;
+  for(CounterI=0; CounterI<nog; CounterI++)
+  {
+    tnoc += File->GroupArray[CounterI]->NumOfChannels;
+  }
+  noo = nog + tnoc + 1; // Groups number + total number of Channels + File object
+
+  
+  MetaDataLen = 0;
+
+  /*** File meta data ***/
+  // (4B number of objects) +
+  // (4B file path length) + (1B file path) +
+  // (4B raw data index) + (4B number of properties)
+  MetaDataLen += 17;
+  Object = TDMS_PropertyBuilderFind(Builder, filePathBytes);
+  MetaDataLen += Object ? Object->PropertiesLen : 0;
+  
+  /*** Groups meta data ***/
+  for(CounterI=0; CounterI<nog; CounterI++)
+  {
+    // (4B gorup path length) + (4B raw data index) + (4B number of properties)
+    MetaDataLen += 12;
+    MetaDataLen += File->GroupArray[CounterI]->GroupPathLen; // Groups path length
+    Object = TDMS_PropertyBuilderFind(Builder,
+                                      File->GroupArray[CounterI]->GroupPathBytes);
+    MetaDataLen += Object ? Object->PropertiesLen : 0;
+    
+    /*** Channels meta data ***/
+    for(CounterJ=0; CounterJ<File->GroupArray[CounterI]->NumOfChannels; CounterJ++)
+    {
+      // (4B channel path length) + (4B raw data index) + (4B number of properties)
+      MetaDataLen += 12;
+      MetaDataLen += File->GroupArray[CounterI]->ChannelArray[CounterJ]->ChannelPathLen; //Channels path
+      Object = TDMS_PropertyBuilderFind(Builder,
+                                        File->GroupArray[CounterI]->ChannelArray[CounterJ]->ChannelPathBytes);
+      MetaDataLen += Object ? Object->PropertiesLen : 0;
+      MetaDataLen += TDMS_WaveformPropertiesLen(File->GroupArray[CounterI]->ChannelArray[CounterJ]);
+      MetaDataLen += TDMS_SaveScaleProperties(NULL, File->GroupArray[CounterI]->ChannelArray[CounterJ]);
+    }//for(CounterJ=0; CounterJ<File->GroupArray[CounterI]->NumOfChannels; CounterJ++)
+  }//for(CounterI=0; CounterI<nog; CounterI++)
+  
+
+  /*** ***/
+  /*** if Buffer address is NULL, return back. ***/
+  /*** ***/
+  if(Buffer == NULL)
+  {
+    DataSize = LeadInPartLen + MetaDataLen + RawDataLen;
+    *Size = DataSize;
+    
+    return TDMS_OK;
+  }
+
+  if (BufferSize < LeadInPartLen + MetaDataLen + RawDataLen)
+  {
+    *Size = LeadInPartLen + MetaDataLen + RawDataLen;
+
+    return TDMS_OUT_OF_CAP;
+  }
+  
+  // New object list of the file has no raw data
+  TDMS_InvalidateLayout(File);
+
+  /*** ***/
+  /*** generate lead in part ***/
+  /*** ***/
+  TDMS_GenerateLeadInPart(&Buffer[DataSize],
+                          kTocMetaData | kTocNewObjList,
+                          MetaDataLen + RawDataLen,
+                          MetaDataLen);
+  DataSize += LeadInPartLen;
+  
+  
+  /*** ***/
+  /*** generate meta data ***/
+  /*** ***/
+  DataSize += TDMS_SaveData32(&Buffer[DataSize],
+                              noo); // Number of objects
+
+  /*** File meta data ***/
+  DataSize += TDMS_SavePathToMetaDataPart(&Buffer[DataSize],
+                                          filePathBytes, 1); // File path
+  DataSize += TDMS_SaveData32(&Buffer[DataSize],
+                              0xFFFFFFFF); // Raw data index = 0xFFFFFFFF
+  DataSize += TDMS_SaveObjectProperties(&Buffer[DataSize], Builder,
+                                        TDMS_PropertyBuilderFind(Builder,
+                                                                 filePathBytes),
+                                        0); // Properties
+
+  /*** Goups meta data ***/
+  for (CounterI = 0; CounterI < nog; CounterI++)
+  {
+    DataSize += TDMS_SavePathToMetaDataPart(&Buffer[DataSize],
+                                            File->GroupArray[CounterI]->GroupPathBytes,
+                                            File->GroupArray[CounterI]->GroupPathLen); // Groups path
+    DataSize += TDMS_SaveData32(&Buffer[DataSize],
+                                0xFFFFFFFF); // Raw data index = 0xFFFFFFFF
+    DataSize += TDMS_SaveObjectProperties(&Buffer[DataSize], Builder,
+                                          TDMS_PropertyBuilderFind(Builder,
+                                                                   File->GroupArray[CounterI]->GroupPathBytes),
+                                          0); // Properties
+
+    /*** Channels meta data ***/
+    for(CounterJ=0; CounterJ<File->GroupArray[CounterI]->NumOfChannels; CounterJ++)
+    {
+      DataSize += TDMS_SavePathToMetaDataPart(&Buffer[DataSize],
+                                              File->GroupArray[CounterI]->ChannelArray[CounterJ]->ChannelPathBytes,
+                                              File->GroupArray[CounterI]->ChannelArray[CounterJ]->ChannelPathLen); // Channels path
+
+      DataSize += TDMS_SaveData32(&Buffer[DataSize],
+                                  0xFFFFFFFF); // Raw data index = 0xFFFFFFFF
+
+      DataSize += TDMS_SaveObjectProperties(&Buffer[DataSize], Builder,
+                                            TDMS_PropertyBuilderFind(Builder,
+                                                                     File->GroupArray[CounterI]->ChannelArray[CounterJ]->ChannelPathBytes),
+                                            (File->GroupArray[CounterI]->ChannelArray[CounterJ]->Waveform ?
+                                             WaveformNumOfProperties : 0) +
+                                            TDMS_ScaleNumOfProperties(File->GroupArray[CounterI]->ChannelArray[CounterJ])); // Properties
+      DataSize += TDMS_SaveWaveformProperties(&Buffer[DataSize],
+                                              File->GroupArray[CounterI]->ChannelArray[CounterJ]); // Waveform Properties
+      DataSize += TDMS_SaveScaleProperties(&Buffer[DataSize],
+                                           File->GroupArray[CounterI]->ChannelArray[CounterJ]); // Scale Properties
+    }//for(CounterJ=0; CounterJ<File->GroupArray[CounterI]->NumOfChannels; CounterJ++)
+  }  //for(CounterI=0; CounterI<nog; CounterI++)
+
+  *Size = DataSize;
+  
+  #undef RawDataLen
+  
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Add Property to the object
+ * @note   To use this function, you must first create and initialize the File and
+ *         use TDMS_GenFirstPart
+ * @note   The segment does not contain a new object list, so the object list
+ *         of previous raw data segment stays valid for next segments.
+ * 
+ * @param  PathBytes: Object path in meta data format (length followed by path)
+ * @param  PathLen: Length of object path
+ * @param  RawDataIndex: Raw data index of the object
+ *         - 0xFFFFFFFF: Object has no raw data
+ *         - 0x00000000: Raw data index is the same as previous segment
+ * 
+ * @param  Buffer: Pointer to the buffer that data save in
+ * @note   If the buffer address is Null, then function only calculates needed
+ *         buffer size
+ * 
+ * @param  BufferSize: Size of the buffer (Byte)
+ * @param  Size: Size of data in buffer (Byte)
+ * @param  Name: Name of Property
+ * @param  DataType: Data type of Property
+ * @param  Value: Pointer to the value of Property
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_OUT_OF_CAP: Buffer is smaller than Size (nothing is generated)
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+static TDMS_Result_t
+TDMS_AddPropertyToObject(const uint8_t *PathBytes, uint32_t PathLen,
+                        uint32_t RawDataIndex,
+                        uint8_t *Buffer, uint64_t BufferSize, uint64_t *Size,
+                        char *Name, TDMS_Data_t DataType, void *Value)
+{
+  uint64_t DataSize = 0;
+  uint64_t MetaDataLen = 0;
+  uint64_t PropertyLen = 0;
+
+  PropertyLen = TDMS_PropertyLen(Name, DataType, Value);
+  if (PropertyLen == 0)
+    return TDMS_WRONG_ARG;
+  
+  /*** ***/
+  /*** Meta Data len calculation ***/
+  /*** ***/
+  // (4B number of objects) +
+  // (4B file path length) +
+  // (4B raw data index) + (4B number of properties)
+  MetaDataLen += 16;
+  MetaDataLen += PathLen; // Object path length
+  MetaDataLen += PropertyLen; // Property
+  
+  
+  /*** ***/
+  /*** if Buffer address is NULL, return back. ***/
+  /*** ***/
+  if(Buffer == NULL)
+  {
+    DataSize = LeadInPartLen + MetaDataLen;
+    *Size = DataSize;
+    
+    return TDMS_OK;
+  }
+
+  if (BufferSize < LeadInPartLen + MetaDataLen)
+  {
+    *Size = LeadInPartLen + MetaDataLen;
+
+    return TDMS_OUT_OF_CAP;
+  }
+  
+  
+  /*** ***/
+  /*** generate lead in part ***/
+  /*** ***/
+  TDMS_GenerateLeadInPart(&Buffer[DataSize],
+                          kTocMetaData,
+                          MetaDataLen,
+                          MetaDataLen);
+  DataSize += LeadInPartLen;
+
+
+  /*** ***/
+  /*** generate meta data ***/
+  /*** ***/
+  DataSize += TDMS_SaveData32(&Buffer[DataSize], 1); // Number of objects
+
+  /*** File meta data ***/
+  DataSize += TDMS_SavePathToMetaDataPart(&Buffer[DataSize],
+                                          PathBytes, PathLen); // Object path
+  DataSize += TDMS_SaveData32(&Buffer[DataSize],
+                              RawDataIndex); // Raw data index
+  DataSize += TDMS_SaveData32(&Buffer[DataSize],
+                              0x01); // Number of properties
+
+  DataSize += TDMS_SavePropertyToMetaDataPart(&Buffer[DataSize],
+                                              Name, DataType, Value); // first Property
+  
+  *Size = DataSize;
+  
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Generate one meta data segment with all Properties of a Property
+ *         Builder
+ * @param  Builder: Pointer to TDMS Property Builder object structure
+ * @param  Buffer: Pointer to the buffer that data save in
+ * @note   If the buffer address is Null, then function only calculates needed
+ *         buffer size
+ * 
+ * @param  BufferSize: Size of the buffer (Byte)
+ * @param  Size: Size of data in buffer (Byte, 0 if Builder is empty)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_OUT_OF_CAP: Buffer is smaller than Size (nothing is generated)
+ */
+static TDMS_Result_t
+TDMS_GenBuilderSegment(TDMS_PropertyBuilder_t *Builder,
+                       uint8_t *Buffer, uint64_t BufferSize, uint64_t *Size)
+{
+  TDMS_PropertyObject_t *Object = NULL;
+  uint64_t DataSize = 0;
+  uint64_t MetaDataLen = 0;
+  uint32_t CounterI = 0;
+
+  if (!Builder->NumOfObjects)
+  {
+    *Size = 0;
+    return TDMS_OK;
+  }
+
+  /*** ***/
+  /*** Meta Data len calculation ***/
+  /*** ***/
+  MetaDataLen = 4; // Number of objects
+  for (CounterI = 0; CounterI < Builder->NumOfObjects; CounterI++)
+  {
+    Object = &Builder->Objects[CounterI];
+    // (4B object path length) + (4B raw data index) +
+    // (4B number of properties)
+    MetaDataLen += 12;
+    MetaDataLen += Object->PathLen; // Object path
+    MetaDataLen += Object->PropertiesLen; // Properties
+  }
+
+  *Size = LeadInPartLen + MetaDataLen;
+  if (Buffer == NULL)
+    return TDMS_OK;
+
+  if (BufferSize < LeadInPartLen + MetaDataLen)
+    return TDMS_OUT_OF_CAP;
+
+  /*** ***/
+  /*** generate lead in part ***/
+  /*** ***/
+  TDMS_GenerateLeadInPart(&Buffer[DataSize],
+                          kTocMetaData,
+                          MetaDataLen,
+                          MetaDataLen);
+  DataSize += LeadInPartLen;
+
+  /*** ***/
+  /*** generate meta data ***/
+  /*** ***/
+  DataSize += TDMS_SaveData32(&Buffer[DataSize],
+                              Builder->NumOfObjects); // Number of objects
+  for (CounterI = 0; CounterI < Builder->NumOfObjects; CounterI++)
+  {
+    Object = &Builder->Objects[CounterI];
+    DataSize += TDMS_SavePathToMetaDataPart(&Buffer[DataSize],
+                                            Object->PathBytes,
+                                            Object->PathLen); // Object path
+    // Keep the raw data index of a Channel if it is in the object list of
+    // previous raw data segment
+    DataSize += TDMS_SaveData32(&Buffer[DataSize],
+                                (Object->Channel &&
+                                 Object->Channel->LayoutNumOfValues) ?
+                                0x00000000 : 0xFFFFFFFF); // Raw data index
+    DataSize += TDMS_SaveObjectProperties(&Buffer[DataSize],
+                                          Builder, Object, 0); // Properties
+  }
+
+  *Size = DataSize;
+
+  return TDMS_OK;
+}
+
+
+
+/**
+ * @brief  Sink write function of the Writers that save data into a stdio stream
+ * @param  Context: Pointer to FILE object of the stream
+ * @param  Data: Pointer to data
+ * @param  Size: Size of data (Byte)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_IO_ERROR: Writing into the stream failed
+ */
+static TDMS_Result_t
+TDMS_StreamSinkWrite(void *Context, const uint8_t *Data, uint64_t Size)
+{
+  if (fwrite(Data, 1, (size_t) Size, (FILE *) Context) != Size)
+    return TDMS_IO_ERROR;
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Sink write at offset function of the Writers that save data into a
+ *         stdio stream
+ * @param  Context: Pointer to FILE object of the stream
+ * @param  Data: Pointer to data
+ * @param  Size: Size of data (Byte)
+ * @param  Offset: Offset in the file (Byte)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_IO_ERROR: Writing into the stream failed
+ */
+static TDMS_Result_t
+TDMS_StreamSinkWriteAt(void *Context, const uint8_t *Data, uint64_t Size,
+                       uint64_t Offset)
+{
+  FILE *Stream = (FILE *) Context;
+  TDMS_Result_t Result = TDMS_OK;
+  StreamPos_t End = StreamTell(Stream);
+  StreamPos_t Pos = (StreamPos_t) Offset;
+
+  // the offset must fit in the position of the stream
+  if (End < 0 || Pos < 0 || (uint64_t) Pos != Offset)
+    return TDMS_IO_ERROR;
+
+  if (StreamSeek(Stream, Pos, SEEK_SET) != 0)
+    return TDMS_IO_ERROR;
+  if (fwrite(Data, 1, (size_t) Size, Stream) != Size)
+    Result = TDMS_IO_ERROR;
+  if (StreamSeek(Stream, End, SEEK_SET) != 0)
+    Result = TDMS_IO_ERROR;
+
+  return Result;
+}
+
+
+/**
+ * @brief  Make sure the buffer of the Writer is big enough
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Size: Needed size of the buffer (Byte)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ */
+static TDMS_Result_t
+TDMS_WriterReserve(TDMS_Writer_t *Writer, uint64_t Size)
+{
+  uint8_t *Buffer = NULL;
+  uint64_t BufferSize = Writer->BufferSize;
+
+  if (Size <= BufferSize)
+    return TDMS_OK;
+
+  // grow geometrically so repeated writes of slowly growing chunks do not
+  // reallocate every time
+  while (BufferSize < Size)
+    BufferSize = (BufferSize > UnknownBufferSize / 2) ? Size : BufferSize * 2;
+
+  if (BufferSize > SIZE_MAX)
+    return TDMS_NO_MEMORY;
+
+  Buffer = (uint8_t *) realloc(Writer->Buffer, (size_t) BufferSize);
+  if (!Buffer)
+    return TDMS_NO_MEMORY;
+
+  Writer->Buffer = Buffer;
+  Writer->BufferSize = BufferSize;
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Make sure the scatter-gather array of the Writer is big enough
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  NumOfIoVec: Needed number of elements
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ */
+static TDMS_Result_t
+TDMS_WriterReserveIoVec(TDMS_Writer_t *Writer, uint32_t NumOfIoVec)
+{
+  TDMS_IoVec_t *IoVec = NULL;
+
+  if (NumOfIoVec <= Writer->IoVecSize)
+    return TDMS_OK;
+
+  IoVec = (TDMS_IoVec_t *) realloc(Writer->IoVec,
+                                   NumOfIoVec * sizeof(TDMS_IoVec_t));
+  if (!IoVec)
+    return TDMS_NO_MEMORY;
+
+  Writer->IoVec = IoVec;
+  Writer->IoVecSize = NumOfIoVec;
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Pass Lead In part and meta data of a segment to the index sink of
+ *         the Writer (TDMS index file)
+ * @note   The segment in TDMS index file is the same as TDMS file, but its tag
+ *         is "TDSh" and it has no raw data.
+ * 
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Header: Pointer to Lead In part and meta data of the segment (buffer
+ *                 of the Writer or a Group Template)
+ *
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+static TDMS_Result_t
+TDMS_WriterSaveIndex(TDMS_Writer_t *Writer, uint8_t *Header)
+{
+  TDMS_Result_t Result = TDMS_OK;
+  uint64_t RawDataOffset = 0;
+
+  if (!Writer->IndexSink.Write)
+    return TDMS_OK;
+
+  // Raw data offset of Lead In part is the length of meta data
+  RawDataOffset = TDMS_LoadData64(&Header[20]);
+
+  TDMS_GenerateLeadInTag(Header, TAG_TDSh_Num);
+  Result = Writer->IndexSink.Write(Writer->IndexSink.Context,
+                                   Header, LeadInPartLen + RawDataOffset);
+  TDMS_GenerateLeadInTag(Header, TAG_TDSm_Num);
+
+  return Result;
+}
+
+
+/**
+ * @brief  Finish a segment that is passed to the sink of the Writer (save its
+ *         index and start a new file if a threshold of rotation is reached)
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Header: Pointer to Lead In part and meta data of the segment
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+static TDMS_Result_t
+TDMS_WriterEndSegment(TDMS_Writer_t *Writer, uint8_t *Header)
+{
+  TDMS_Rotation_t *Rotation = (TDMS_Rotation_t *) Writer->Rotation;
+  TDMS_Result_t Result = TDMS_OK;
+
+  Result = TDMS_WriterSaveIndex(Writer, Header);
+  if (Result != TDMS_OK || !Rotation)
+    return Result;
+
+  if ((Rotation->MaxSize && Writer->Offset >= Rotation->MaxSize) ||
+      (Rotation->MaxDuration && Rotation->GetTime &&
+       Rotation->GetTime() - Rotation->FileStartTime >= Rotation->MaxDuration))
+    return TDMS_WriterRotate(Writer);
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Pass generated data in buffer of the Writer to its sink
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Size: Size of data in buffer (Byte)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+static TDMS_Result_t
+TDMS_WriterSave(TDMS_Writer_t *Writer, uint64_t Size)
+{
+  TDMS_Result_t Result = TDMS_OK;
+
+  if (!Size)
+    return TDMS_OK;
+
+  // the segment may not be saved, so the object list of the next raw data
+  // segment must be saved again (e.g. when the write is retried)
+  Result = Writer->Sink.Write(Writer->Sink.Context, Writer->Buffer, Size);
+  if (Result != TDMS_OK)
+  {
+    TDMS_InvalidateLayout(Writer->File);
+    return Result;
+  }
+
+  Writer->Offset += Size;
+
+  return TDMS_WriterEndSegment(Writer, Writer->Buffer);
+}
+
+
+
+
+/**
+ * @brief  Add Property to an object and save it into the sink
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  PathBytes: Object path in meta data format (length followed by path)
+ * @param  PathLen: Length of object path
+ * @param  RawDataIndex: Raw data index of the object
+ * @param  Channel: Pointer to TDMS Channel object structure (Null: File or
+ *                  Group object)
+ * 
+ * @param  Name: Name of Property
+ * @param  DataType: Data type of Property
+ * @param  Value: Pointer to the value of Property
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+static TDMS_Result_t
+TDMS_WriterAddPropertyToObject(TDMS_Writer_t *Writer,
+                               const uint8_t *PathBytes, uint32_t PathLen,
+                               uint32_t RawDataIndex, TDMS_Channel_t *Channel,
+                               char *Name, TDMS_Data_t DataType, void *Value)
+{
+  TDMS_Rotation_t *Rotation = (TDMS_Rotation_t *) Writer->Rotation;
+  TDMS_Result_t Result = TDMS_OK;
+  uint64_t Size = 0;
+
+  // Properties are saved in the first part of next files too
+  if (Rotation && Rotation->Builder)
+  {
+    Result = TDMS_PropertyBuilderAdd(Rotation->Builder, PathBytes, PathLen,
+                                     Channel, Name, DataType, Value);
+    if (Result != TDMS_OK)
+      return Result;
+    Rotation->FirstPartLen = 0;
+  }
+
+  Result = TDMS_AddPropertyToObject(PathBytes, PathLen, RawDataIndex,
+                                    Writer->Buffer, Writer->BufferSize, &Size,
+                                    Name, DataType, Value);
+  if (Result == TDMS_OUT_OF_CAP)
+  {
+    Result = TDMS_WriterReserve(Writer, Size);
+    if (Result == TDMS_OK)
+      Result = TDMS_AddPropertyToObject(PathBytes, PathLen, RawDataIndex,
+                                        Writer->Buffer, Writer->BufferSize,
+                                        &Size,
+                                        Name, DataType, Value);
+  }
+  if (Result != TDMS_OK)
+    return Result;
+
+  return TDMS_WriterSave(Writer, Size);
+}
+
+
+/**
+ * @brief  Generate a raw data segment for some Channels and save it into the
+ *         sink
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Channels: Array of Channels of the segment (ChunkValues and
+ *                   ChunkNumOfValues of each Channel must be set)
+ * @param  NumOfChannels: Number of Channels in array
+ * @param  Interleaved: 1 to generate interleaved raw data
+ * @param  Frames: Pointer to raw data that is already interleaved or Null
+ *                 (like TDMS_GenDataSegment)
+ * 
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_WriterGenDataSegment(TDMS_Writer_t *Writer,
+                          TDMS_Channel_t **Channels, uint32_t NumOfChannels,
+                          uint8_t Interleaved, const void *Frames)
+{
+  TDMS_Result_t Result = TDMS_OK;
+  TDMS_IoVec_t *IoVec = NULL;
+  uint32_t NumOfIoVec = 0;
+  uint32_t IoVecSize = Interleaved ? 2 : (NumOfChannels + 1);
+  uint64_t Size = 0;
+  uint32_t CounterI = 0;
+
+  // raw data of Channels is passed to the sink without copy, if it supports
+  // scatter-gather
+  if (Writer->Sink.Writev)
+  {
+    if (TDMS_WriterReserveIoVec(Writer, IoVecSize) != TDMS_OK)
+      return TDMS_NO_MEMORY;
+    IoVec = Writer->IoVec;
+  }
+
+  Result = TDMS_GenDataSegment(Writer->File, Channels, NumOfChannels,
+                               Interleaved, Frames,
+                               Writer->Buffer, Writer->BufferSize, &Size,
+                               IoVec, &NumOfIoVec);
+  if (Result == TDMS_OUT_OF_CAP)
+  {
+    Result = TDMS_WriterReserve(Writer, Size);
+    if (Result == TDMS_OK)
+      Result = TDMS_GenDataSegment(Writer->File, Channels, NumOfChannels,
+                                   Interleaved, Frames,
+                                   Writer->Buffer, Writer->BufferSize, &Size,
+                                   IoVec, &NumOfIoVec);
+  }
+  if (Result != TDMS_OK)
+    return Result;
+
+  if ((IoVec && !NumOfIoVec) || (!IoVec && !Size))
+    return TDMS_OK;
+
+  if (IoVec)
+    Result = Writer->Sink.Writev(Writer->Sink.Context, IoVec, NumOfIoVec);
+  else
+    Result = Writer->Sink.Write(Writer->Sink.Context, Writer->Buffer, Size);
+  if (Result != TDMS_OK)
+  {
+    TDMS_InvalidateLayout(Writer->File);
+    return Result;
+  }
+
+  if (IoVec)
+    for (CounterI = 0; CounterI < NumOfIoVec; CounterI++)
+      Writer->Offset += IoVec[CounterI].Len;
+  else
+    Writer->Offset += Size;
+
+  // values are counted only once the segment is saved (a failed segment can be
+  // generated again)
+  TDMS_CountWaveformValues(Channels, NumOfChannels);
+
+  return TDMS_WriterEndSegment(Writer, Writer->Buffer);
+}
+
+
+/**
+ * @brief  Generate a raw data segment with the values of a string Channel and
+ *         save it into the sink
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Channel: Pointer to TDMS Channel object structure
+ * @param  Strings: Array of pointers to the strings (Null: Packed is used)
+ * @param  Lengths: Array of lengths of the strings (Null: strings are NULL
+ *                  terminated)
+ * 
+ * @param  Packed: Pointer to the concatenated strings (if Strings is Null)
+ * @param  PackedLen: Length of Packed (Byte)
+ * @param  EndOffsets: Array of end offsets of the strings in Packed (if Strings
+ *                     is Null)
+ * 
+ * @param  NumOfValues: Number of strings
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+static TDMS_Result_t
+TDMS_WriterGenStringSegment(TDMS_Writer_t *Writer, TDMS_Channel_t *Channel,
+                            const char * const *Strings, const uint32_t *Lengths,
+                            const char *Packed, uint64_t PackedLen,
+                            const uint32_t *EndOffsets, uint64_t NumOfValues)
+{
+  TDMS_Result_t Result = TDMS_OK;
+  TDMS_IoVec_t *IoVec = NULL;
+  uint32_t NumOfIoVec = 0;
+  uint64_t Size = 0;
+  uint32_t CounterI = 0;
+
+  if (Writer->File !=
+      (TDMS_File_t *) ((TDMS_Group_t *) Channel->GroupOfChannel)->FileOfGroup)
+    return TDMS_WRONG_ARG;
+
+  // packed strings are passed to the sink without copy, if it supports
+  // scatter-gather
+  if (Writer->Sink.Writev)
+  {
+    if (TDMS_WriterReserveIoVec(Writer, 3) != TDMS_OK)
+      return TDMS_NO_MEMORY;
+    IoVec = Writer->IoVec;
+  }
+
+  Result = TDMS_GenStringSegment(Channel, Strings, Lengths,
+                                 Packed, PackedLen, EndOffsets, NumOfValues,
+                                 Writer->Buffer, Writer->BufferSize, &Size,
+                                 IoVec, &NumOfIoVec);
+  if (Result == TDMS_OUT_OF_CAP)
+  {
+    Result = TDMS_WriterReserve(Writer, Size);
+    if (Result == TDMS_OK)
+      Result = TDMS_GenStringSegment(Channel, Strings, Lengths,
+                                     Packed, PackedLen, EndOffsets, NumOfValues,
+                                     Writer->Buffer, Writer->BufferSize, &Size,
+                                     IoVec, &NumOfIoVec);
+  }
+  if (Result != TDMS_OK)
+    return Result;
+
+  if (!IoVec)
+    return TDMS_WriterSave(Writer, Size);
+
+  Result = Writer->Sink.Writev(Writer->Sink.Context, IoVec, NumOfIoVec);
+  if (Result != TDMS_OK)
+  {
+    TDMS_InvalidateLayout(Writer->File);
+    return Result;
+  }
+
+  for (CounterI = 0; CounterI < NumOfIoVec; CounterI++)
+    Writer->Offset += IoVec[CounterI].Len;
+
+  return TDMS_WriterEndSegment(Writer, Writer->Buffer);
+}
+
+
+#if (TDMS_CONFIG_POSIX == 1)
+/**
+ * @brief  Default time source of Coalescers (monotonic clock)
+ * @retval Current time (ms)
+ */
+static uint64_t
+TDMS_CoalescerClock(void)
+{
+  struct timespec Now;
+
+  if (clock_gettime(CLOCK_MONOTONIC, &Now) != 0)
+    return 0;
+
+  return (uint64_t) Now.tv_sec * 1000 + (uint64_t) Now.tv_nsec / 1000000;
+}
+#endif
+
+
+/**
+ * @brief  Make room for values of a Channel in its staging buffer
+ * @note   Nothing is staged, so a failure does not change the staged values.
+ * 
+ * @param  Coalescer: Pointer to TDMS Coalescer object structure
+ * @param  Channel: Pointer to TDMS Channel object structure
+ * @param  NumOfValues: Number of values
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ */
+static TDMS_Result_t
+TDMS_CoalescerReserve(TDMS_Coalescer_t *Coalescer, TDMS_Channel_t *Channel,
+                      uint64_t NumOfValues)
+{
+  TDMS_Channel_t **Channels = NULL;
+  uint8_t *StageValues = NULL;
+  uint64_t ValueLen = dataTypeLength[Channel->ChannelDataType];
+  uint64_t Len = ValueLen * NumOfValues;
+  uint64_t StageSize = Channel->StageSize;
+
+  if (ValueLen == 0 && NumOfValues)
+    return TDMS_WRONG_ARG;
+  if (Len == 0)
+    return TDMS_OK;
+
+  // staging buffer grows geometrically, and it is kept for next segments
+  if (Channel->StageNumOfValues * ValueLen + Len > StageSize)
+  {
+    if (StageSize == 0)
+      StageSize = Len;
+    while (StageSize < Channel->StageNumOfValues * ValueLen + Len)
+      StageSize *= 2;
+    if (StageSize > SIZE_MAX)
+      return TDMS_NO_MEMORY;
+
+    StageValues = (uint8_t *) realloc(Channel->StageValues, (size_t) StageSize);
+    if (!StageValues)
+      return TDMS_NO_MEMORY;
+
+    // new Channels are saved in order of their first values
+    if (!Channel->StageValues)
+    {
+      if (Coalescer->NumOfChannels >= Coalescer->ChannelsSize)
+      {
+        Channels = (TDMS_Channel_t **) realloc(Coalescer->Channels,
+                                               (Coalescer->ChannelsSize + 8) *
+                                               sizeof(TDMS_Channel_t *));
+        if (!Channels)
+        {
+          free(StageValues);
+          return TDMS_NO_MEMORY;
+        }
+        Coalescer->Channels = Channels;
+        Coalescer->ChannelsSize += 8;
+      }
+      Coalescer->Channels[Coalescer->NumOfChannels] = Channel;
+      Coalescer->NumOfChannels++;
+    }
+
+    Channel->StageValues = StageValues;
+    Channel->StageSize = StageSize;
+  }
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Copy values of a Channel into its staging buffer
+ * @param  Coalescer: Pointer to TDMS Coalescer object structure
+ * @param  Channel: Pointer to TDMS Channel object structure
+ * @param  Values: Pointer to data values
+ * @param  NumOfValues: Number of values
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ */
+static TDMS_Result_t
+TDMS_CoalescerStage(TDMS_Coalescer_t *Coalescer, TDMS_Channel_t *Channel,
+                    const void *Values, uint64_t NumOfValues)
+{
+  TDMS_Result_t Result = TDMS_OK;
+  uint8_t *StageValues = NULL;
+  uint64_t ValueLen = dataTypeLength[Channel->ChannelDataType];
+  uint64_t Len = ValueLen * NumOfValues;
+
+  Result = TDMS_CoalescerReserve(Coalescer, Channel, NumOfValues);
+  if (Result != TDMS_OK || Len == 0)
+    return Result;
+
+  StageValues = &Channel->StageValues[Channel->StageNumOfValues * ValueLen];
+  memcpy(StageValues, Values, (size_t) Len);
+
+  if (Coalescer->StagedBytes == 0 && Coalescer->GetTime)
+    Coalescer->FirstTime = Coalescer->GetTime();
+  Channel->StageNumOfValues += NumOfValues;
+  Coalescer->StagedBytes += Len;
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Save the staged values if a threshold of Coalescer is reached
+ * @param  Coalescer: Pointer to TDMS Coalescer object structure
+ * @param  Channel: Pointer to the Channel that its values are staged or Null
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+static TDMS_Result_t
+TDMS_CoalescerCheck(TDMS_Coalescer_t *Coalescer, TDMS_Channel_t *Channel)
+{
+  if (Coalescer->StagedBytes == 0)
+    return TDMS_OK;
+
+  if ((Coalescer->MaxBytes && Coalescer->StagedBytes >= Coalescer->MaxBytes) ||
+      (Coalescer->MaxValues && Channel &&
+       Channel->StageNumOfValues >= Coalescer->MaxValues) ||
+      (Coalescer->MaxTime && Coalescer->GetTime &&
+       Coalescer->GetTime() - Coalescer->FirstTime >= Coalescer->MaxTime))
+    return TDMS_CoalescerFlush(Coalescer);
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Generate both Lead In parts of a Group Template
+ * @param  Template: Pointer to TDMS Group Template object structure
+ * @retval None
+ */
+static void
+TDMS_GroupTemplateLeadIn(TDMS_GroupTemplate_t *Template)
+{
+  TDMS_GenerateLeadInPart(Template->Header,
+                          kTocRawData | kTocNewObjList | kTocMetaData,
+                          Template->MetaDataLen + Template->RawDataLen,
+                          Template->MetaDataLen);
+  TDMS_GenerateLeadInPart(&Template->Header[LeadInPartLen + Template->MetaDataLen],
+                          kTocRawData,
+                          Template->RawDataLen,
+                          0);
+}
+
+
+/**
+ * @brief  Serialize Lead In parts and meta data of a Group Template from its
+ *         number of values
+ * @param  Template: Pointer to TDMS Group Template object structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ */
+static TDMS_Result_t
+TDMS_BuildGroupTemplate(TDMS_GroupTemplate_t *Template)
+{
+  TDMS_Channel_t **Channels = Template->Group->ChannelArray;
+  TDMS_Channel_t *Channel = NULL;
+  uint8_t *Header = NULL;
+  uint64_t MetaDataLen = 4; // Number of objects
+  uint64_t RawDataLen = 0;
+  uint32_t NumberOfObjects = 0;
+  uint32_t CounterI = 0;
+
+  for (CounterI = 0; CounterI < Template->NumOfChannels; CounterI++)
+  {
+    Channel = Channels[CounterI];
+    if (!Template->NumOfValues[CounterI])
+      continue;
+
+    if (dataTypeLength[Channel->ChannelDataType] == 0 || Channel->DAQmx)
+      return TDMS_WRONG_ARG;
+    RawDataLen += dataTypeLength[Channel->ChannelDataType] *
+                  Template->NumOfValues[CounterI];
+
+    // like TDMS_GenDataSegment
+    MetaDataLen += 28;
+    MetaDataLen += Channel->ChannelPathLen; // Channel path
+    NumberOfObjects++;
+  }
+
+  if (!NumberOfObjects)
+    return TDMS_WRONG_ARG;
+
+  if (LeadInPartLen + MetaDataLen + LeadInPartLen > SIZE_MAX)
+    return TDMS_NO_MEMORY;
+
+  Header = (uint8_t *) malloc((size_t) (LeadInPartLen + MetaDataLen +
+                                        LeadInPartLen));
+  if (!Header)
+    return TDMS_NO_MEMORY;
+
+  // ChunkNumOfValues is only used by TDMS_SaveObjectList here and is set again
+  // before each segment
+  for (CounterI = 0; CounterI < Template->NumOfChannels; CounterI++)
+    Channels[CounterI]->ChunkNumOfValues = Template->NumOfValues[CounterI];
+
+  TDMS_SaveObjectList(&Header[LeadInPartLen],
+                      Channels, Template->NumOfChannels,
+                      NumberOfObjects, Template->NumOfValuesOffset, 0);
+  for (CounterI = 0; CounterI < Template->NumOfChannels; CounterI++)
+    if (Template->NumOfValuesOffset[CounterI])
+      Template->NumOfValuesOffset[CounterI] += LeadInPartLen;
+
+  free(Template->Header);
+  Template->Header = Header;
+  Template->MetaDataLen = MetaDataLen;
+  Template->RawDataLen = RawDataLen;
+  TDMS_GroupTemplateLeadIn(Template);
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Set data values of the Channels of a Group Template and select the
+ *         header of the segment
+ * @note   Layout of the file is not changed. If the returned header is not the
+ *         raw data only Lead In part, TDMS_SaveLayout must be called when the
+ *         segment is saved.
+ * 
+ * @param  Template: Pointer to TDMS Group Template object structure
+ * @param  Values: Array of pointers to data values of each Channel of the Group
+ * @param  HeaderLen: Length of the header of the segment (Byte)
+ * @retval Pointer to the header of the segment or Null if Group is changed
+ */
+static uint8_t *
+TDMS_GroupTemplateHeader(TDMS_GroupTemplate_t *Template,
+                         const void * const *Values, uint64_t *HeaderLen)
+{
+  TDMS_Group_t *Group = Template->Group;
+  uint32_t CounterI = 0;
+
+  if (!Template->Header || Group->NumOfChannels != Template->NumOfChannels)
+    return NULL;
+
+  for (CounterI = 0; CounterI < Template->NumOfChannels; CounterI++)
+  {
+    Group->ChannelArray[CounterI]->ChunkValues = (void *) Values[CounterI];
+    Group->ChannelArray[CounterI]->ChunkNumOfValues = Template->NumOfValues[CounterI];
+  }
+
+  if (TDMS_IsSameLayout((TDMS_File_t *) Group->FileOfGroup,
+                        Group->ChannelArray, Template->NumOfChannels))
+  {
+    *HeaderLen = LeadInPartLen;
+    return &Template->Header[LeadInPartLen + Template->MetaDataLen];
+  }
+
+  *HeaderLen = LeadInPartLen + Template->MetaDataLen;
+  return Template->Header;
+}
+
+
+/**
+ * @brief  Copy data values of the Channels of a Group Template after each
+ *         other
+ * @param  Template: Pointer to TDMS Group Template object structure
+ * @param  Buffer: Pointer to area that raw data save into
+ * @retval None
+ */
+static void
+TDMS_GroupTemplateRawData(TDMS_GroupTemplate_t *Template, uint8_t *Buffer)
+{
+  TDMS_Channel_t *Channel = NULL;
+  uint64_t Len = 0;
+  uint32_t CounterI = 0;
+
+  for (CounterI = 0; CounterI < Template->NumOfChannels; CounterI++)
+  {
+    Channel = Template->Group->ChannelArray[CounterI];
+    Len = dataTypeLength[Channel->ChannelDataType] * Template->NumOfValues[CounterI];
+    if (!Len)
+      continue;
+
+    TDMS_ConvertValues(Buffer, (const uint8_t *) Channel->ChunkValues,
+                       Channel->ChannelDataType, Template->NumOfValues[CounterI]);
+    Buffer += Len;
+  }
+}
+
+/**
+ ==================================================================================
+                            ##### Public Functions #####                           
+ ==================================================================================
+ */
+
+/**
+ * @brief  Initialize File object structure
+ * @param  File: Pointer to File object structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ */
+TDMS_Result_t
+TDMS_InitFile(TDMS_File_t *File)
+{
+  File->NumOfGroups = 0;
+  File->LayoutFirst = NULL;
+#if (TDMS_CONFIG_DYNAMIC_OBJECTS == 1)
+  File->GroupArray = NULL;
+  File->GroupArraySize = 0;
+  File->Arena = NULL;
+  File->ArenaUsed = 0;
+  File->ArenaSize = 0;
+  File->GroupHash = NULL;
+  File->GroupHashSize = 0;
+  File->ChannelHash = NULL;
+  File->ChannelHashSize = 0;
+  File->NumOfChannels = 0;
+#endif
+  
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Release the memory of File object structure (dynamic objects only)
+ * @note   Paths of the Groups and Channels of the File are released too.
+ *
+ * @param  File: Pointer to File object structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ */
+TDMS_Result_t
+TDMS_DeInitFile(TDMS_File_t *File)
+{
+#if (TDMS_CONFIG_DYNAMIC_OBJECTS == 1)
+  uint8_t *Block = NULL;
+  uint32_t CounterI = 0;
+
+  for (CounterI = 0; CounterI < File->NumOfGroups; CounterI++)
+  {
+    free(File->GroupArray[CounterI]->ChannelArray);
+    File->GroupArray[CounterI]->ChannelArray = NULL;
+    File->GroupArray[CounterI]->ChannelArraySize = 0;
+    File->GroupArray[CounterI]->NumOfChannels = 0;
+  }
+
+  while (File->Arena)
+  {
+    Block = File->Arena;
+    memcpy(&File->Arena, Block, sizeof(uint8_t *));
+    free(Block);
+  }
+
+  free(File->GroupArray);
+  free(File->GroupHash);
+  free(File->ChannelHash);
+#endif
+
+  return TDMS_InitFile(File);
+}
+
+
+/**
+ * @brief  Initialize Channel Group object structure
+ * @param  Group: Pointer to TDMS Channel Group object structure
+ * @param  File: Pointer to the File object structure that Channel Group assign
+ *               into
+ * @param  Name: Channel Group name
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_OUT_OF_CAP: The file object capacity is full
+ *         - TDMS_WRONG_ARG: Name is too long or the Group already exists
+ *         - TDMS_NO_MEMORY: Memory allocation failed (dynamic objects)
+ */
+TDMS_Result_t
+TDMS_AddGroupToFile(TDMS_Group_t *Group, TDMS_File_t *File, char *Name)
+{
+#if (TDMS_CONFIG_DYNAMIC_OBJECTS == 1)
+  TDMS_Group_t **GroupArray = NULL;
+  uint32_t GroupArraySize = 0;
+  uint8_t *PathBytes = NULL;
+  uint32_t PathLen = strlen(Name) + 3;
+#endif
+  TDMS_Group_t *Existing = NULL;
+
+#if (TDMS_CONFIG_DYNAMIC_OBJECTS == 1)
+  // room in the Group array before any memory of the Group is allocated
+  if (File->NumOfGroups >= File->GroupArraySize)
+  {
+    GroupArraySize = File->GroupArraySize ? (File->GroupArraySize << 1) : 4;
+    GroupArray = (TDMS_Group_t **) realloc(File->GroupArray,
+                                           GroupArraySize * sizeof(TDMS_Group_t *));
+    if (!GroupArray)
+      return TDMS_NO_MEMORY;
+    File->GroupArray = GroupArray;
+    File->GroupArraySize = GroupArraySize;
+  }
+
+  // Group path with its length (released if the Group is not added)
+  PathBytes = (uint8_t *) TDMS_ArenaAlloc(File, PathLen + 5);
+  if (!PathBytes)
+    return TDMS_NO_MEMORY;
+  TDMS_SaveData32(PathBytes, PathLen);
+  TDMS_GenerateGroupPath((char *) &PathBytes[4], Name);
+  if (TDMS_FindGroup(File, (char *) &PathBytes[4], &Existing) == TDMS_OK)
+  {
+    TDMS_ArenaRelease(File, PathLen + 5);
+    return TDMS_WRONG_ARG;
+  }
+  Group->GroupPathBytes = PathBytes;
+  Group->GroupPath = (char *) &PathBytes[4];
+  Group->GroupPathLen = PathLen;
+
+  // set File pointer
+  Group->FileOfGroup = (void *) File;
+
+  Group->NumOfChannels = 0;
+  Group->ChannelArray = NULL;
+  Group->ChannelArraySize = 0;
+
+  // add group to file obj
+  if (TDMS_HashGroup(File, Group) != TDMS_OK)
+  {
+    TDMS_ArenaRelease(File, PathLen + 5);
+    return TDMS_NO_MEMORY;
+  }
+  File->GroupArray[File->NumOfGroups] = Group;
+  File->NumOfGroups++;
+#else
+  if (strlen(Name) >= TDMS_CONFIG_GROUP_NAME_LEN)
+    return TDMS_WRONG_ARG;
+
+  // Group path with its length
+  Group->GroupPath = (char *) &Group->GroupPathBytes[4];
+  Group->GroupPathLen = TDMS_GenerateGroupPath(Group->GroupPath, Name);
+  TDMS_SaveData32(Group->GroupPathBytes, Group->GroupPathLen);
+  if (TDMS_FindGroup(File, Group->GroupPath, &Existing) == TDMS_OK)
+    return TDMS_WRONG_ARG;
+  
+  // set File pointer
+  Group->FileOfGroup = (void *) File;
+  
+  // add group to file obj
+  if (File->NumOfGroups >= TDMS_CONFIG_MAX_GROUP_OF_FILE)
+    return TDMS_OUT_OF_CAP;
+  File->GroupArray[File->NumOfGroups] = Group;
+  File->NumOfGroups++;
+  
+  Group->NumOfChannels = 0;
+#endif
+  
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Initialize Channel object structure
+ * @param  Channel: Pointer to TDMS Channel object structure
+ * @param  Group: Pointer to the Channel Group object structure that Channel assign
+ *                into
+ * 
+ * @param  Name: Pointer to Name of TDMS Channel object
+ * @param  DataType: Data type of Channel Raw data
+ *         - TDMS_DataType_Void: Data type is unknown
+ *         - TDMS_DataType_I8: signed int 8 bit
+ *         - TDMS_DataType_I16: signed int 16 bit
+ *         - TDMS_DataType_I32: signed int 32 bit
+ *         - TDMS_DataType_I64: signed int 64 bit
+ *         - TDMS_DataType_U8: unsigned int 8 bit
+ *         - TDMS_DataType_U16: unsigned int 16 bit
+ *         - TDMS_DataType_U32: unsigned int 32 bit
+ *         - TDMS_DataType_U64: unsigned int 64 bit
+ *         - TDMS_DataType_SingleFloat: 4 byte floating point number
+ *         - TDMS_DataType_DoubleFloat: 8 byte floating point number
+ *         - TDMS_DataType_String: string, array of characters (values are set
+ *                                 by TDMS_SetChannelStringValues functions)
+ *         - TDMS_DataType_Boolean: boolean data
+ *         - TDMS_DataType_TimeStamp: time stamp data
+ * 
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument or the Channel already exists
+ *         - TDMS_OUT_OF_CAP: The Group object capacity is full
+ *         - TDMS_NO_MEMORY: Memory allocation failed (dynamic objects)
+ */
+TDMS_Result_t
+TDMS_AddChannelToGroup(TDMS_Channel_t *Channel, TDMS_Group_t *Group,
+                       char *Name, TDMS_Data_t DataType)
+{
+#if (TDMS_CONFIG_DYNAMIC_OBJECTS == 1)
+  TDMS_File_t *File = (TDMS_File_t *) Group->FileOfGroup;
+  TDMS_Channel_t **ChannelArray = NULL;
+  uint32_t ChannelArraySize = 0;
+  uint8_t *PathBytes = NULL;
+  uint32_t PathLen = 0;
+#endif
+  TDMS_Channel_t *Existing = NULL;
+
+  if(dataTypeLength[DataType] == 0 && DataType != TDMS_DataType_String)
+    return TDMS_WRONG_ARG;
+  
+  Channel->ChannelDataType = DataType;
+  Channel->ChunkValues = NULL;
+  Channel->ChunkNumOfValues = 0;
+  Channel->LayoutNext = NULL;
+  Channel->LayoutNumOfValues = 0;
+  Channel->StageValues = NULL;
+  Channel->StageNumOfValues = 0;
+  Channel->StageSize = 0;
+  Channel->Waveform = 0;
+  Channel->DAQmx = 0;
+  
+#if (TDMS_CONFIG_DYNAMIC_OBJECTS == 1)
+  // room in the Channel array before any memory of the Channel is allocated
+  if (Group->NumOfChannels >= Group->ChannelArraySize)
+  {
+    ChannelArraySize = Group->ChannelArraySize ?
+                       (Group->ChannelArraySize << 1) : 8;
+    ChannelArray = (TDMS_Channel_t **) realloc(Group->ChannelArray,
+                                               ChannelArraySize * sizeof(TDMS_Channel_t *));
+    if (!ChannelArray)
+      return TDMS_NO_MEMORY;
+    Group->ChannelArray = ChannelArray;
+    Group->ChannelArraySize = ChannelArraySize;
+  }
+
+  // channel path with its length (released if the Channel is not added)
+  PathLen = Group->GroupPathLen + strlen(Name) + 3;
+  PathBytes = (uint8_t *) TDMS_ArenaAlloc(File, PathLen + 5);
+  if (!PathBytes)
+    return TDMS_NO_MEMORY;
+  TDMS_SaveData32(PathBytes, PathLen);
+  TDMS_GenerateChannelPath(Group, (char *) &PathBytes[4], Name);
+  if (TDMS_FindChannel(File, (char *) &PathBytes[4], &Existing) == TDMS_OK)
+  {
+    TDMS_ArenaRelease(File, PathLen + 5);
+    return TDMS_WRONG_ARG;
+  }
+  Channel->ChannelPathBytes = PathBytes;
+  Channel->ChannelPath = (char *) &PathBytes[4];
+  Channel->ChannelPathLen = PathLen;
+
+  // set Group pointer
+  Channel->GroupOfChannel = (void *) Group;
+
+  // add channel to group obj
+  if (TDMS_HashChannel(File, Channel) != TDMS_OK)
+  {
+    TDMS_ArenaRelease(File, PathLen + 5);
+    return TDMS_NO_MEMORY;
+  }
+  Group->ChannelArray[Group->NumOfChannels] = Channel;
+  Group->NumOfChannels++;
+#else
+  if (strlen(Name) >= TDMS_CONFIG_CHANNEL_NAME_LEN)
+    return TDMS_WRONG_ARG;
+
+  // channel path with its length
+  Channel->ChannelPath = (char *) &Channel->ChannelPathBytes[4];
+  Channel->ChannelPathLen = TDMS_GenerateChannelPath(Group, Channel->ChannelPath,
+                                                     Name);
+  TDMS_SaveData32(Channel->ChannelPathBytes, Channel->ChannelPathLen);
+  if (TDMS_FindChannel((TDMS_File_t *) Group->FileOfGroup,
+                       Channel->ChannelPath, &Existing) == TDMS_OK)
+    return TDMS_WRONG_ARG;
+  
+  // set Group pointer
+  Channel->GroupOfChannel = (void *) Group;
+  
+  // add channel to group obj
+  if (Group->NumOfChannels >= TDMS_CONFIG_MAX_CHANNEL_OF_GROUP)
+    return TDMS_OUT_OF_CAP;
+  Group->ChannelArray[Group->NumOfChannels] = Channel;
+  Group->NumOfChannels++;
+#endif
+
+  
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Add a waveform Channel to Channel Group
+ * @note   Time of the samples is saved as wf_start_time, wf_start_offset and
+ *         wf_increment Properties of the Channel in first part of the file, so
+ *         no Timestamp Channel is needed for fixed-rate signals. wf_samples is
+ *         not saved, readers take the number of samples from the raw data.
+ * 
+ * @param  Channel: Pointer to TDMS Channel object structure
+ * @param  Group: Pointer to the Channel Group object structure that Channel assign
+ *                into
+ * 
+ * @param  Name: Pointer to Name of TDMS Channel object
+ * @param  DataType: Data type of Channel Raw data (like TDMS_AddChannelToGroup)
+ * @param  StartTime: Pointer to time of first sample
+ * @param  Increment: Time between two samples (Second, greater than 0)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_OUT_OF_CAP: The Group object capacity is full
+ *         - TDMS_NO_MEMORY: Memory allocation failed (dynamic objects)
+ */
+TDMS_Result_t
+TDMS_AddWaveformChannelToGroup(TDMS_Channel_t *Channel, TDMS_Group_t *Group,
+                               char *Name, TDMS_Data_t DataType,
+                               const TDMS_Timestamp_t *StartTime,
+                               double Increment)
+{
+  TDMS_Result_t Result = TDMS_OK;
+
+  if (!StartTime || !(Increment > 0.0))
+    return TDMS_WRONG_ARG;
+
+  Result = TDMS_AddChannelToGroup(Channel, Group, Name, DataType);
+  if (Result != TDMS_OK)
+    return Result;
+
+  Channel->Waveform = 1;
+  Channel->WfStartTime = *StartTime;
+  Channel->WfIncrement = Increment;
+  Channel->WfNumOfValues = 0;
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Add a DAQmx Channel to Channel Group
+ * @note   Raw values are saved in DAQmx raw data segments and the Scale is saved
+ *         as NI_Scale Properties of the Channel in first part of the file.
+ * 
+ * @param  Channel: Pointer to TDMS Channel object structure
+ * @param  Group: Pointer to the Channel Group object structure that Channel assign
+ *                into
+ * 
+ * @param  Name: Pointer to Name of TDMS Channel object
+ * @param  RawDataType: Data type of raw values (integer or floating point)
+ * @param  Scale: Pointer to the Scale of raw values (it and its coefficients
+ *                are copied)
+ *
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_OUT_OF_CAP: The Group object capacity is full or the Scale
+ *                            has more than TDMS_CONFIG_MAX_SCALE_COEFFICIENTS
+ *                            coefficients (static objects)
+ *         - TDMS_NO_MEMORY: Memory allocation failed (dynamic objects)
+ */
+TDMS_Result_t
+TDMS_AddDAQmxChannelToGroup(TDMS_Channel_t *Channel, TDMS_Group_t *Group,
+                            char *Name, TDMS_Data_t RawDataType,
+                            const TDMS_Scale_t *Scale)
+{
+  TDMS_Result_t Result = TDMS_OK;
+  uint32_t NumOfCoefficients = 0;
+#if (TDMS_CONFIG_DYNAMIC_OBJECTS == 1)
+  TDMS_File_t *File = (TDMS_File_t *) Group->FileOfGroup;
+  uint64_t CoefficientsLen = 0;
+  uint8_t *Coefficients = NULL;
+#endif
+
+  if (!Scale || RawDataType >= TDMS_DataType_MAX ||
+      daqmxDataType[RawDataType] == daqmxTypeNone)
+    return TDMS_WRONG_ARG;
+  if (Scale->Type != TDMS_ScaleType_Linear &&
+      (Scale->Type != TDMS_ScaleType_Polynomial ||
+       !Scale->Coefficients || !Scale->NumOfCoefficients))
+    return TDMS_WRONG_ARG;
+  if (Scale->Type == TDMS_ScaleType_Polynomial)
+    NumOfCoefficients = Scale->NumOfCoefficients;
+
+  // coefficients are copied, so the first part of next files of a rotating
+  // Writer does not read the array of the caller
+#if (TDMS_CONFIG_DYNAMIC_OBJECTS == 1)
+  if (NumOfCoefficients)
+  {
+    // aligned for double (released if the Channel is not added)
+    CoefficientsLen = NumOfCoefficients * sizeof(double) + sizeof(double);
+    Coefficients = (uint8_t *) TDMS_ArenaAlloc(File, CoefficientsLen);
+    if (!Coefficients)
+      return TDMS_NO_MEMORY;
+    Channel->ScaleCoefficients = (double *)
+      &Coefficients[(sizeof(double) -
+                     ((uintptr_t) Coefficients % sizeof(double))) %
+                    sizeof(double)];
+  }
+#else
+  if (NumOfCoefficients > TDMS_CONFIG_MAX_SCALE_COEFFICIENTS)
+    return TDMS_OUT_OF_CAP;
+#endif
+
+  Result = TDMS_AddChannelToGroup(Channel, Group, Name, RawDataType);
+  if (Result != TDMS_OK)
+  {
+#if (TDMS_CONFIG_DYNAMIC_OBJECTS == 1)
+    if (NumOfCoefficients)
+      TDMS_ArenaRelease(File, CoefficientsLen);
+#endif
+    return Result;
+  }
+
+  Channel->DAQmx = 1;
+  Channel->Scale = *Scale;
+  if (NumOfCoefficients)
+  {
+    memcpy(Channel->ScaleCoefficients, Scale->Coefficients,
+           NumOfCoefficients * sizeof(double));
+    Channel->Scale.Coefficients = Channel->ScaleCoefficients;
+  }
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Find a Channel Group of the File by its path
+ * @note   It is O(1) for dynamic objects and a linear search for static ones.
+ *
+ * @param  File: Pointer to TDMS File object structure
+ * @param  Path: Path of the Channel Group (e.g. "/'Group'")
+ * @param  Group: Pointer to save address of the Channel Group
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: The Channel Group does not exist
+ */
+TDMS_Result_t
+TDMS_FindGroup(TDMS_File_t *File, const char *Path, TDMS_Group_t **Group)
+{
+#if (TDMS_CONFIG_DYNAMIC_OBJECTS == 1)
+  uint32_t Slot = 0;
+
+  if (!File->GroupHashSize)
+    return TDMS_WRONG_ARG;
+
+  Slot = TDMS_HashPath(Path) & (File->GroupHashSize - 1);
+  while (File->GroupHash[Slot])
+  {
+    if (strcmp(File->GroupHash[Slot]->GroupPath, Path) == 0)
+    {
+      *Group = File->GroupHash[Slot];
+      return TDMS_OK;
+    }
+    Slot = (Slot + 1) & (File->GroupHashSize - 1);
+  }
+#else
+  uint32_t CounterI = 0;
+
+  for (CounterI = 0; CounterI < File->NumOfGroups; CounterI++)
+  {
+    if (strcmp(File->GroupArray[CounterI]->GroupPath, Path) == 0)
+    {
+      *Group = File->GroupArray[CounterI];
+      return TDMS_OK;
+    }
+  }
+#endif
+
+  return TDMS_WRONG_ARG;
+}
+
+
+/**
+ * @brief  Find a Channel of the File by its path
+ * @note   It is O(1) for dynamic objects and a linear search for static ones.
+ *
+ * @param  File: Pointer to TDMS File object structure
+ * @param  Path: Path of the Channel (e.g. "/'Group'/'Channel'")
+ * @param  Channel: Pointer to save address of the Channel
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: The Channel does not exist
+ */
+TDMS_Result_t
+TDMS_FindChannel(TDMS_File_t *File, const char *Path, TDMS_Channel_t **Channel)
+{
+#if (TDMS_CONFIG_DYNAMIC_OBJECTS == 1)
+  uint32_t Slot = 0;
+
+  if (!File->ChannelHashSize)
+    return TDMS_WRONG_ARG;
+
+  Slot = TDMS_HashPath(Path) & (File->ChannelHashSize - 1);
+  while (File->ChannelHash[Slot])
+  {
+    if (strcmp(File->ChannelHash[Slot]->ChannelPath, Path) == 0)
+    {
+      *Channel = File->ChannelHash[Slot];
+      return TDMS_OK;
+    }
+    Slot = (Slot + 1) & (File->ChannelHashSize - 1);
+  }
+#else
+  TDMS_Group_t *Group = NULL;
+  uint32_t CounterI = 0;
+  uint32_t CounterJ = 0;
+
+  for (CounterI = 0; CounterI < File->NumOfGroups; CounterI++)
+  {
+    Group = File->GroupArray[CounterI];
+    for (CounterJ = 0; CounterJ < Group->NumOfChannels; CounterJ++)
+    {
+      if (strcmp(Group->ChannelArray[CounterJ]->ChannelPath, Path) == 0)
+      {
+        *Channel = Group->ChannelArray[CounterJ];
+        return TDMS_OK;
+      }
+    }
+  }
+#endif
+
+  return TDMS_WRONG_ARG;
+}
+
+
+/**
+ * @brief  Generate First part of TDMS file
+ * @param  File: Pointer to TDMS File object structure
+ * @param  Buffer: Pointer to the buffer that data save in
+ * @param  Size: Size of data in buffer (Byte)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ */
+TDMS_Result_t
+TDMS_GenFirstPart(TDMS_File_t *File,
+                  uint8_t *Buffer,
+                  uint64_t *Size)
+{
+  return TDMS_GenFirstPartSegment(File, NULL, Buffer, UnknownBufferSize, Size);
+}
+
+
+/**
+ * @brief  Add Property to the file object
+ * @note   To use this function, you must first create and initialize the File and
+ *         use TDMS_GenFirstPart
+ * 
+ * @param  Buffer: Pointer to the buffer that data save in
+ * @note   If the buffer address is Null, then function only calculates needed
+ *         buffer size
+ * 
+ * @param  Size: Size of data in buffer (Byte)
+ * @param  Name: Name of Property
+ * @param  DataType: Data type of Property
+ * @param  Value: Pointer to the value of Property
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+TDMS_Result_t
+TDMS_AddPropertyToFile(uint8_t *Buffer, uint64_t *Size,
+                       char *Name, TDMS_Data_t DataType, void *Value)
+{
+  return TDMS_AddPropertyToObject(filePathBytes, 1, 0xFFFFFFFF,
+                                  Buffer, UnknownBufferSize, Size,
+                                  Name, DataType, Value);
+}
+
+
+/**
+ * @brief  Add Property to the group object
+ * @note   To use this function, you must first create and initialize the File and
+ *         use TDMS_GenFirstPart
+ * 
+ * @param  Group: Pointer to TDMS group object structure
+ * @param  Buffer: Pointer to the buffer that data save in
+ * @note   If the buffer address is Null, then function only calculates needed
+ *         buffer size
+ * 
+ * @param  Size: Size of data in buffer (Byte)
+ * @param  Name: Name of Property
+ * @param  DataType: Data type of Property
+ * @param  Value: Pointer to the value of Property
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+TDMS_Result_t
+TDMS_AddPropertyToGroup(TDMS_Group_t *Group,
+                        uint8_t *Buffer, uint64_t *Size,
+                        char *Name, TDMS_Data_t DataType, void *Value)
+{
+  return TDMS_AddPropertyToObject(Group->GroupPathBytes, Group->GroupPathLen,
+                                  0xFFFFFFFF,
+                                  Buffer, UnknownBufferSize, Size,
+                                  Name, DataType, Value);
+}
+
+
+/**
+ * @brief  Add Property to the channel object
+ * @note   To use this function, you must first create and initialize the File and
+ *         use TDMS_GenFirstPart
+ * 
+ * @param  Channel: Pointer to TDMS channel object structure
+ * @param  Buffer: Pointer to the buffer that data save in
+ * @note   If the buffer address is Null, then function only calculates needed
+ *         buffer size
+ * 
+ * @param  Size: Size of data in buffer (Byte)
+ * @param  Name: Name of Property
+ * @param  DataType: Data type of Property
+ * @param  Value: Pointer to the value of Property
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+TDMS_Result_t
+TDMS_AddPropertyToChannel(TDMS_Channel_t *Channel,
+                          uint8_t *Buffer, uint64_t *Size,
+                          char *Name, TDMS_Data_t DataType, void *Value)
+{
+  // Keep the raw data index of the Channel if it is in the object list of
+  // previous raw data segment
+  return TDMS_AddPropertyToObject(Channel->ChannelPathBytes,
+                                  Channel->ChannelPathLen,
+                                  Channel->LayoutNumOfValues ? 0x00000000 : 0xFFFFFFFF,
+                                  Buffer, UnknownBufferSize, Size,
+                                  Name, DataType, Value);
+}
+
+/**
+ * @brief  Set data to a Channel
+ * @note   To use this function, you must first create and initialize the File,
+ *         Channel Group, and Channel objects with their associated functions,
+ *         then generate and save the first part of TDMS file using the
+ *         TDMS_GenFirstPart function, and then use this function to add data to
+ *         the Channels.
+ * @note   If the Channel and number of values are the same as previous raw data
+ *         segment of the file, the segment only contains Lead In part and raw
+ *         data. The buffer must be saved on disk, after each call with a valid
+ *         buffer address.
+ * 
+ * @param  Channel: Pointer to TDMS Channel object structure
+ * @param  Buffer: Pointer to the buffer that data save in
+ * @note   If the buffer address is Null, then function only calculates needed
+ *         buffer size and returns TDMS_OK.
+ * 
+ * @param  Size: Size of data in buffer (Byte)
+ * @param  Values: Pointer to data values (not changed, Boolean values are
+ *                 saved as 0 and 1)
+ * 
+ * @param  NumOfValues: Number of values
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+TDMS_Result_t
+TDMS_SetChannelDataValues(TDMS_Channel_t *Channel,
+                          uint8_t *Buffer,
+                          uint64_t *Size,
+                          const void *Values,
+                          uint64_t NumOfValues)
+{
+  TDMS_Group_t *Group = (TDMS_Group_t *) Channel->GroupOfChannel;
+
+  if (dataTypeLength[Channel->ChannelDataType] * NumOfValues == 0)
+    return TDMS_WRONG_ARG;
+
+
+  Channel->ChunkValues = (void *) Values;
+  Channel->ChunkNumOfValues = NumOfValues;
+
+  return TDMS_GenBufferDataSegment((TDMS_File_t *) Group->FileOfGroup,
+                                   &Channel, 1, 0, NULL,
+                                   Buffer, Size,
+                                   NULL, NULL);
+}
+
+
+/**
+ * @brief  Set data to Channels of a Group
+ * @note   To use this function, you must first create and initialize the File,
+ *         Channel Group, and Channel objects with their associated functions,
+ *         then generate and save the first part of TDMS file using the
+ *         TDMS_GenFirstPart function, and then use this function to add data to
+ *         the Channels of a Groupe.
+ * @note   If the Channels and their number of values are the same as previous
+ *         raw data segment of the file, the segment only contains Lead In part
+ *         and raw data. The buffer must be saved on disk, after each call with a
+ *         valid buffer address.
+ * 
+ * @param  Group: Pointer to TDMS Group object structure
+ * @param  Buffer: Pointer to the buffer that data save in
+ * @note   If the buffer address is Null, then function only calculates needed
+ *         buffer size and returns TDMS_OK.
+ * 
+ * @param  Size: Size of data in buffer (Byte)
+ * @param  ...: Pointer to Channels data values, Number of values (uint64_t).
+ * @note   Number of values must be passed as uint64_t.
+ * @note   This is a example of calling this function for a Group with 2
+ *         Channels:
+ *         uint8_t Ch1Values[3] = {0,1,2}; // Ch1 data type is tdsTypeU8
+ *         float Ch2Values[2] = {10.0,11.1}; // Ch1 data type is tdsTypeSingleFloat
+ *         TDMS_SetGroupDataValues(&Group, Buffer, &Size,
+ *                                 Ch1Values, (uint64_t) 3,
+ *                                 Ch2Values, (uint64_t) 2);
+ * 
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+TDMS_Result_t
+TDMS_SetGroupDataValues(TDMS_Group_t *Group,
+                        uint8_t *Buffer,
+                        uint64_t *Size,
+                        ...
+                        )
+{
+  uint16_t CounterI = 0;
+  va_list valist;
+
+  /* initialize valist for num number of arguments */
+  va_start(valist, Size);
+
+  for(CounterI=0; CounterI<(Group->NumOfChannels); CounterI++)
+  {
+    Group->ChannelArray[CounterI]->ChunkValues = va_arg(valist, void*);
+    Group->ChannelArray[CounterI]->ChunkNumOfValues = va_arg(valist, uint64_t);
+  }
+
+  /* clean memory reserved for valist */
+  va_end(valist);
+
+  return TDMS_GenBufferDataSegment((TDMS_File_t *) Group->FileOfGroup,
+                                   Group->ChannelArray, Group->NumOfChannels, 0, NULL,
+                                   Buffer, Size,
+                                   NULL, NULL);
+}
+
+
+/**
+ * @brief  Set data to a Channel without copying the data values
+ * @note   Like TDMS_SetChannelDataValues, but only Lead In part and meta data
+ *         are generated in the buffer. The segment is described by IoVec array
+ *         that points to the buffer and to the data values, and can be saved
+ *         with a scatter-gather write (e.g. writev).
+ * @note   Boolean values (and values that are saved in other byte order) are
+ *         still converted into the buffer.
+ * 
+ * @param  Channel: Pointer to TDMS Channel object structure
+ * @param  Buffer: Pointer to the buffer that Lead In part and meta data save in
+ * @note   If the buffer address is Null, then function only calculates needed
+ *         buffer size and returns TDMS_OK.
+ * 
+ * @param  Size: Size of data in buffer (Byte)
+ * @param  IoVec: Pointer to an array of at least 2 elements
+ * @param  NumOfIoVec: Number of used elements of IoVec
+ * @param  Values: Pointer to data values (must be valid until the segment is
+ *                 saved)
+ * 
+ * @param  NumOfValues: Number of values
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+TDMS_Result_t
+TDMS_SetChannelDataValuesIoVec(TDMS_Channel_t *Channel,
+                               uint8_t *Buffer,
+                               uint64_t *Size,
+                               TDMS_IoVec_t *IoVec,
+                               uint32_t *NumOfIoVec,
+                               const void *Values,
+                               uint64_t NumOfValues)
+{
+  TDMS_Group_t *Group = (TDMS_Group_t *) Channel->GroupOfChannel;
+
+  if (dataTypeLength[Channel->ChannelDataType] * NumOfValues == 0)
+    return TDMS_WRONG_ARG;
+
+
+  Channel->ChunkValues = (void *) Values;
+  Channel->ChunkNumOfValues = NumOfValues;
+
+  return TDMS_GenBufferDataSegment((TDMS_File_t *) Group->FileOfGroup,
+                                   &Channel, 1, 0, NULL,
+                                   Buffer, Size,
+                                   IoVec, NumOfIoVec);
+}
+
+
+/**
+ * @brief  Set data to Channels of a Group without copying the data values
+ * @note   Like TDMS_SetGroupDataValues, but only Lead In part and meta data
+ *         are generated in the buffer. The segment is described by IoVec array
+ *         that points to the buffer and to the data values, and can be saved
+ *         with a scatter-gather write (e.g. writev).
+ * @note   Boolean values (and values that are saved in other byte order) are
+ *         still converted into the buffer.
+ * 
+ * @param  Group: Pointer to TDMS Group object structure
+ * @param  Buffer: Pointer to the buffer that Lead In part and meta data save in
+ * @note   If the buffer address is Null, then function only calculates needed
+ *         buffer size and returns TDMS_OK.
+ * 
+ * @param  Size: Size of data in buffer (Byte)
+ * @param  IoVec: Pointer to an array of at least (number of Channels of the
+ *                Group + 1) elements
+ * 
+ * @param  NumOfIoVec: Number of used elements of IoVec
+ * @param  ...: Pointer to Channels data values, Number of values (uint64_t).
+ *         (like TDMS_SetGroupDataValues)
+ * 
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+TDMS_Result_t
+TDMS_SetGroupDataValuesIoVec(TDMS_Group_t *Group,
+                             uint8_t *Buffer,
+                             uint64_t *Size,
+                             TDMS_IoVec_t *IoVec,
+                             uint32_t *NumOfIoVec,
+                             ...
+                             )
+{
+  uint16_t CounterI = 0;
+  va_list valist;
+
+  /* initialize valist for num number of arguments */
+  va_start(valist, NumOfIoVec);
+
+  for(CounterI=0; CounterI<(Group->NumOfChannels); CounterI++)
+  {
+    Group->ChannelArray[CounterI]->ChunkValues = va_arg(valist, void*);
+    Group->ChannelArray[CounterI]->ChunkNumOfValues = va_arg(valist, uint64_t);
+  }
+
+  /* clean memory reserved for valist */
+  va_end(valist);
+
+  return TDMS_GenBufferDataSegment((TDMS_File_t *) Group->FileOfGroup,
+                                   Group->ChannelArray, Group->NumOfChannels, 0, NULL,
+                                   Buffer, Size,
+                                   IoVec, NumOfIoVec);
+}
+
+
+/**
+ * @brief  Set data to Channels of a Group as interleaved raw data
+ * @note   Like TDMS_SetGroupDataValues, but all of the Channels have the same
+ *         number of values and the values are interleaved (one value of each
+ *         Channel per row) in the buffer (kTocInterleavedData segment).
+ * 
+ * @param  Group: Pointer to TDMS Group object structure
+ * @param  Buffer: Pointer to the buffer that data save in
+ * @note   If the buffer address is Null, then function only calculates needed
+ *         buffer size and returns TDMS_OK.
+ * 
+ * @param  Size: Size of data in buffer (Byte)
+ * @param  NumOfValues: Number of values of each Channel
+ * @param  ...: Pointer to data values of each Channel.
+ * @note   This is a example of calling this function for a Group with 2
+ *         Channels:
+ *         uint16_t Ch1Values[3] = {0,1,2}; // Ch1 data type is tdsTypeU16
+ *         float Ch2Values[3] = {10.0,11.1,12.2}; // Ch2 data type is tdsTypeSingleFloat
+ *         TDMS_SetGroupInterleavedDataValues(&Group, Buffer, &Size, 3,
+ *                                            Ch1Values, Ch2Values);
+ * 
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+TDMS_Result_t
+TDMS_SetGroupInterleavedDataValues(TDMS_Group_t *Group,
+                                   uint8_t *Buffer,
+                                   uint64_t *Size,
+                                   uint64_t NumOfValues,
+                                   ...
+                                   )
+{
+  uint16_t CounterI = 0;
+  va_list valist;
+
+  if (NumOfValues == 0)
+    return TDMS_WRONG_ARG;
+
+  /* initialize valist for num number of arguments */
+  va_start(valist, NumOfValues);
+
+  for(CounterI=0; CounterI<(Group->NumOfChannels); CounterI++)
+  {
+    Group->ChannelArray[CounterI]->ChunkValues = va_arg(valist, void*);
+    Group->ChannelArray[CounterI]->ChunkNumOfValues = NumOfValues;
+  }
+
+  /* clean memory reserved for valist */
+  va_end(valist);
+
+  return TDMS_GenBufferDataSegment((TDMS_File_t *) Group->FileOfGroup,
+                                   Group->ChannelArray, Group->NumOfChannels, 1, NULL,
+                                   Buffer, Size,
+                                   NULL, NULL);
+}
+
+
+/**
+ * @brief  Set data to Channels of a Group from interleaved frames
+ * @note   Each frame contains one value of each Channel of the Group in order
+ *         of the Channels (e.g. a sample of a DAQ device), so the frames are
+ *         saved as interleaved raw data (kTocInterleavedData segment) without
+ *         any conversion.
+ * 
+ * @param  Group: Pointer to TDMS Group object structure
+ * @param  Buffer: Pointer to the buffer that data save in
+ * @note   If the buffer address is Null, then function only calculates needed
+ *         buffer size and returns TDMS_OK.
+ * 
+ * @param  Size: Size of data in buffer (Byte)
+ * @param  Frames: Pointer to the frames
+ * @param  NumOfFrames: Number of frames
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+TDMS_Result_t
+TDMS_SetGroupInterleavedFrames(TDMS_Group_t *Group,
+                               uint8_t *Buffer,
+                               uint64_t *Size,
+                               const void *Frames,
+                               uint64_t NumOfFrames)
+{
+  uint16_t CounterI = 0;
+
+  if (NumOfFrames == 0)
+    return TDMS_WRONG_ARG;
+
+  for(CounterI=0; CounterI<(Group->NumOfChannels); CounterI++)
+  {
+    Group->ChannelArray[CounterI]->ChunkValues = NULL;
+    Group->ChannelArray[CounterI]->ChunkNumOfValues = NumOfFrames;
+  }
+
+  return TDMS_GenBufferDataSegment((TDMS_File_t *) Group->FileOfGroup,
+                                   Group->ChannelArray, Group->NumOfChannels, 1, Frames,
+                                   Buffer, Size,
+                                   NULL, NULL);
+}
+
+
+/**
+ * @brief  Set data to Channels of a Group from interleaved frames without
+ *         copying the frames
+ * @note   Like TDMS_SetGroupInterleavedFrames, but only Lead In part and meta
+ *         data are generated in the buffer. The segment is described by IoVec
+ *         array that points to the buffer and to the frames, and can be saved
+ *         with a scatter-gather write (e.g. writev).
+ * 
+ * @param  Group: Pointer to TDMS Group object structure
+ * @param  Buffer: Pointer to the buffer that Lead In part and meta data save in
+ * @note   If the buffer address is Null, then function only calculates needed
+ *         buffer size and returns TDMS_OK.
+ * 
+ * @param  Size: Size of data in buffer (Byte)
+ * @param  IoVec: Pointer to an array of at least 2 elements
+ * @param  NumOfIoVec: Number of used elements of IoVec
+ * @param  Frames: Pointer to the frames (must be valid until the segment is
+ *                 saved)
+ * 
+ * @param  NumOfFrames: Number of frames
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+TDMS_Result_t
+TDMS_SetGroupInterleavedFramesIoVec(TDMS_Group_t *Group,
+                                    uint8_t *Buffer,
+                                    uint64_t *Size,
+                                    TDMS_IoVec_t *IoVec,
+                                    uint32_t *NumOfIoVec,
+                                    const void *Frames,
+                                    uint64_t NumOfFrames)
+{
+  uint16_t CounterI = 0;
+
+  if (NumOfFrames == 0)
+    return TDMS_WRONG_ARG;
+
+  for(CounterI=0; CounterI<(Group->NumOfChannels); CounterI++)
+  {
+    Group->ChannelArray[CounterI]->ChunkValues = NULL;
+    Group->ChannelArray[CounterI]->ChunkNumOfValues = NumOfFrames;
+  }
+
+  return TDMS_GenBufferDataSegment((TDMS_File_t *) Group->FileOfGroup,
+                                   Group->ChannelArray, Group->NumOfChannels, 1, Frames,
+                                   Buffer, Size,
+                                   IoVec, NumOfIoVec);
+}
+
+
+/**
+ * @brief  Set strings to a string Channel
+ * @note   The end offsets and the concatenated strings are generated in one
+ *         pass, without allocation. String Channels are always saved in a
+ *         segment with a new object list. The buffer must be saved on disk,
+ *         after each call with a valid buffer address.
+ * 
+ * @param  Channel: Pointer to TDMS Channel object structure (TDMS_DataType_String)
+ * @param  Buffer: Pointer to the buffer that data save in
+ * @note   If the buffer address is Null, then function only calculates needed
+ *         buffer size and returns TDMS_OK.
+ * 
+ * @param  Size: Size of data in buffer (Byte)
+ * @param  Strings: Array of pointers to the strings
+ * @param  Lengths: Array of lengths of the strings (Byte). If it is Null, the
+ *                  strings must be NULL terminated.
+ * 
+ * @param  NumOfValues: Number of strings
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+TDMS_Result_t
+TDMS_SetChannelStringValues(TDMS_Channel_t *Channel,
+                            uint8_t *Buffer,
+                            uint64_t *Size,
+                            const char * const *Strings,
+                            const uint32_t *Lengths,
+                            uint64_t NumOfValues)
+{
+  if (!Strings)
+    return TDMS_WRONG_ARG;
+
+  return TDMS_GenStringSegment(Channel, Strings, Lengths, NULL, 0, NULL,
+                               NumOfValues,
+                               Buffer, UnknownBufferSize, Size,
+                               NULL, NULL);
+}
+
+
+/**
+ * @brief  Set packed strings to a string Channel
+ * @note   This is the layout of string raw data in TDMS files, so the strings
+ *         are saved as they are (with a Writer that its sink has Writev
+ *         function, they are not copied).
+ * 
+ * @param  Channel: Pointer to TDMS Channel object structure (TDMS_DataType_String)
+ * @param  Buffer: Pointer to the buffer that data save in
+ * @note   If the buffer address is Null, then function only calculates needed
+ *         buffer size and returns TDMS_OK.
+ * 
+ * @param  Size: Size of data in buffer (Byte)
+ * @param  Packed: Pointer to the concatenated strings (without NULL characters)
+ * @param  PackedLen: Length of Packed (Byte)
+ * @param  EndOffsets: Array of end offsets of the strings in Packed (Byte, not
+ *                     decreasing and not more than PackedLen)
+ * 
+ * @param  NumOfValues: Number of strings
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument (e.g. end offsets out of order or
+ *           out of Packed)
+ */
+TDMS_Result_t
+TDMS_SetChannelPackedStringValues(TDMS_Channel_t *Channel,
+                                  uint8_t *Buffer,
+                                  uint64_t *Size,
+                                  const char *Packed,
+                                  uint64_t PackedLen,
+                                  const uint32_t *EndOffsets,
+                                  uint64_t NumOfValues)
+{
+  if (!Packed || !EndOffsets)
+    return TDMS_WRONG_ARG;
+
+  return TDMS_GenStringSegment(Channel, NULL, NULL, Packed, PackedLen,
+                               EndOffsets, NumOfValues,
+                               Buffer, UnknownBufferSize, Size,
+                               NULL, NULL);
+}
+
+
+/**
+ * @brief  Calculate second part of TDMS Timestamp from normal time and date
+ * @param  Year: Normal Year (1904 to ...)
+ * @param  Month: Normal Month (1 to 12)
+ * @param  Day: Normal Day (1 to 31)
+ * @param  Hour: Normal Hour (0 to 23)
+ * @param  Minute: Normal Minute (0 to 59)
+ * @param  Second: Normal Second (0 to 59)
+ * @retval Second part of TDMS Timestamp
+ */
+int64_t
+TDMS_TimeSecond(uint16_t Year, uint8_t Month, uint8_t Day,
+                uint8_t Hour, uint8_t Minute, uint8_t Second)
+{
+  uint32_t DiffDay;
+  int64_t DiffSecond;
+
+  DiffDay = TDMS_DateDef(Day, Month, Year);
+  DiffSecond  = (int64_t) (DiffDay * 86400ul);
+  DiffSecond += (int64_t) (Hour * 3600); 
+  DiffSecond += (int64_t) (Minute * 60);
+  DiffSecond += (int64_t) (Second);
+
+  return DiffSecond;
+}
+
+
+/**
+ * @brief  Convert nanoseconds since Unix epoch (1970-01-01 UTC) to TDMS
+ *         Timestamps
+ * @note   Timestamps and Ns can not overlap.
+ * 
+ * @param  Timestamps: Pointer to save TDMS Timestamps
+ * @param  Ns: Pointer to nanoseconds since Unix epoch (negative before it)
+ * @param  NumOfValues: Number of values
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ */
+TDMS_Result_t
+TDMS_TimestampFromUnixNs(TDMS_Timestamp_t *Timestamps,
+                         const int64_t *Ns,
+                         uint64_t NumOfValues)
+{
+  uint64_t CounterI = 0;
+
+  for (CounterI = 0; CounterI < NumOfValues; CounterI++)
+  {
+    Timestamps[CounterI].Fraction =
+        TDMS_NsToFraction(TDMS_SplitUnixNs(Ns[CounterI],
+                                           &Timestamps[CounterI].Second));
+  }
+
+  return TDMS_OK;
+}
+
+
+#if (TDMS_CONFIG_POSIX == 1)
+/**
+ * @brief  Convert timespec values since Unix epoch (e.g. from clock_gettime
+ *         with CLOCK_REALTIME) to TDMS Timestamps
+ * @param  Timestamps: Pointer to save TDMS Timestamps
+ * @param  Times: Pointer to timespec values (tv_nsec: 0 to 999999999)
+ * @param  NumOfValues: Number of values
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ */
+TDMS_Result_t
+TDMS_TimestampFromTimespec(TDMS_Timestamp_t *Timestamps,
+                           const struct timespec *Times,
+                           uint64_t NumOfValues)
+{
+  uint64_t CounterI = 0;
+
+  for (CounterI = 0; CounterI < NumOfValues; CounterI++)
+  {
+    Timestamps[CounterI].Second = (int64_t) Times[CounterI].tv_sec + UnixEpochSecond;
+    Timestamps[CounterI].Fraction =
+        TDMS_NsToFraction((uint32_t) Times[CounterI].tv_nsec);
+  }
+
+  return TDMS_OK;
+}
+#endif
+
+
+
+/**
+ ==================================================================================
+                          ##### Writer Functions #####                             
+ ==================================================================================
+ */
+
+/**
+ * @brief  Initialize Writer object structure
+ * @note   The Writer generates each part of the TDMS file in a buffer that it
+ *         owns and passes it to the sink. The buffer is reused and only grows
+ *         when a part does not fit in it.
+ * @note   If the sink has Writev function, raw data of Channels is not copied
+ *         into the buffer and only Lead In part and meta data are generated in
+ *         it.
+ * 
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  File: Pointer to TDMS File object structure
+ * @param  Sink: Pointer to the sink that generated data save into (copied)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ */
+TDMS_Result_t
+TDMS_InitWriter(TDMS_Writer_t *Writer, TDMS_File_t *File,
+                const TDMS_Sink_t *Sink)
+{
+  if (!Sink || !Sink->Write)
+    return TDMS_WRONG_ARG;
+
+  Writer->File = File;
+  Writer->Sink = *Sink;
+  Writer->Offset = 0;
+  Writer->IoVec = NULL;
+  Writer->IoVecSize = 0;
+  Writer->IndexSink.Context = NULL;
+  Writer->IndexSink.Write = NULL;
+  Writer->IndexSink.Writev = NULL;
+  Writer->IndexSink.WriteAt = NULL;
+  Writer->Rotation = NULL;
+
+  Writer->Buffer = (uint8_t *) malloc(TDMS_CONFIG_WRITER_BUFFER_SIZE);
+  if (!Writer->Buffer)
+    return TDMS_NO_MEMORY;
+  Writer->BufferSize = TDMS_CONFIG_WRITER_BUFFER_SIZE;
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Initialize Writer object structure that saves data into a stdio
+ *         stream
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  File: Pointer to TDMS File object structure
+ * @param  Stream: Pointer to FILE object of the stream (opened in binary mode)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ */
+TDMS_Result_t
+TDMS_InitWriterStream(TDMS_Writer_t *Writer, TDMS_File_t *File, FILE *Stream)
+{
+  TDMS_Sink_t Sink = {.Context = (void *) Stream,
+                      .Write = TDMS_StreamSinkWrite,
+                      .WriteAt = TDMS_StreamSinkWriteAt};
+
+  if (!Stream)
+    return TDMS_WRONG_ARG;
+
+  return TDMS_InitWriter(Writer, File, &Sink);
+}
+
+
+/**
+ * @brief  Set the sink of TDMS index file (.tdms_index) of the Writer
+ * @note   When the Writer has an index sink, Lead In part and meta data of each
+ *         segment are saved into it too. NI readers use the index file to open
+ *         large TDMS files faster.
+ * @note   Must be called before TDMS_WriterGenFirstPart
+ * 
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Sink: Pointer to the sink that index data save into (copied). Null
+ *               disables TDMS index file generation.
+ * 
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+TDMS_Result_t
+TDMS_WriterSetIndexSink(TDMS_Writer_t *Writer, const TDMS_Sink_t *Sink)
+{
+  if (!Sink)
+  {
+    Writer->IndexSink.Context = NULL;
+    Writer->IndexSink.Write = NULL;
+    Writer->IndexSink.Writev = NULL;
+    Writer->IndexSink.WriteAt = NULL;
+
+    return TDMS_OK;
+  }
+
+  if (!Sink->Write)
+    return TDMS_WRONG_ARG;
+
+  Writer->IndexSink = *Sink;
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Set a stdio stream as the sink of TDMS index file (.tdms_index) of
+ *         the Writer
+ * @note   Must be called before TDMS_WriterGenFirstPart
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Stream: Pointer to FILE object of the stream (opened in binary mode)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+TDMS_Result_t
+TDMS_WriterSetIndexStream(TDMS_Writer_t *Writer, FILE *Stream)
+{
+  TDMS_Sink_t Sink = {.Context = (void *) Stream,
+                      .Write = TDMS_StreamSinkWrite};
+
+  if (!Stream)
+    return TDMS_WRONG_ARG;
+
+  return TDMS_WriterSetIndexSink(Writer, &Sink);
+}
+
+
+/**
+ * @brief  De-initialize Writer object structure and free its buffer
+ * @note   The sink is not closed (for a rotating Writer, neither are the sinks
+ *         of its last file)
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ */
+TDMS_Result_t
+TDMS_DeInitWriter(TDMS_Writer_t *Writer)
+{
+  TDMS_Rotation_t *Rotation = NULL;
+
+  free(Writer->Buffer);
+  Writer->Buffer = NULL;
+  Writer->BufferSize = 0;
+
+  free(Writer->IoVec);
+  Writer->IoVec = NULL;
+  Writer->IoVecSize = 0;
+
+  if (Writer->Rotation)
+  {
+    Rotation = (TDMS_Rotation_t *) Writer->Rotation;
+    free(Rotation->FirstPart);
+    Rotation->FirstPart = NULL;
+    Rotation->FirstPartLen = 0;
+    Rotation->FirstPartSize = 0;
+    Writer->Rotation = NULL;
+  }
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Generate First part of TDMS file and save it into the sink
+ * @note   To use this function, you must first create the File, and add
+ *         Groups and Channels.
+ * 
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_WriterGenFirstPart(TDMS_Writer_t *Writer)
+{
+  TDMS_Result_t Result = TDMS_OK;
+  uint64_t Size = 0;
+
+  Result = TDMS_GenFirstPartSegment(Writer->File, NULL,
+                                    Writer->Buffer, Writer->BufferSize, &Size);
+  if (Result == TDMS_OUT_OF_CAP)
+  {
+    Result = TDMS_WriterReserve(Writer, Size);
+    if (Result == TDMS_OK)
+      Result = TDMS_GenFirstPartSegment(Writer->File, NULL,
+                                        Writer->Buffer, Writer->BufferSize,
+                                        &Size);
+  }
+  if (Result != TDMS_OK)
+    return Result;
+
+  return TDMS_WriterSave(Writer, Size);
+}
+
+
+/**
+ * @brief  Add Property to the file object and save it into the sink
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Name: Name of Property
+ * @param  DataType: Data type of Property
+ * @param  Value: Pointer to the value of Property
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_WriterAddPropertyToFile(TDMS_Writer_t *Writer,
+                             char *Name, TDMS_Data_t DataType, void *Value)
+{
+  return TDMS_WriterAddPropertyToObject(Writer, filePathBytes, 1, 0xFFFFFFFF,
+                                        NULL, Name, DataType, Value);
+}
+
+
+/**
+ * @brief  Add Property to the group object and save it into the sink
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Group: Pointer to TDMS group object structure
+ * @param  Name: Name of Property
+ * @param  DataType: Data type of Property
+ * @param  Value: Pointer to the value of Property
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_WriterAddPropertyToGroup(TDMS_Writer_t *Writer, TDMS_Group_t *Group,
+                              char *Name, TDMS_Data_t DataType, void *Value)
+{
+  return TDMS_WriterAddPropertyToObject(Writer,
+                                        Group->GroupPathBytes, Group->GroupPathLen,
+                                        0xFFFFFFFF, NULL,
+                                        Name, DataType, Value);
+}
+
+
+/**
+ * @brief  Add Property to the channel object and save it into the sink
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Channel: Pointer to TDMS channel object structure
+ * @param  Name: Name of Property
+ * @param  DataType: Data type of Property
+ * @param  Value: Pointer to the value of Property
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_WriterAddPropertyToChannel(TDMS_Writer_t *Writer, TDMS_Channel_t *Channel,
+                                char *Name, TDMS_Data_t DataType, void *Value)
+{
+  return TDMS_WriterAddPropertyToObject(Writer,
+                                        Channel->ChannelPathBytes,
+                                        Channel->ChannelPathLen,
+                                        Channel->LayoutNumOfValues ? 0x00000000 : 0xFFFFFFFF,
+                                        Channel, Name, DataType, Value);
+}
+
+
+/**
+ * @brief  Set data to a Channel and save it into the sink
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Channel: Pointer to TDMS Channel object structure
+ * @param  Values: Pointer to data values
+ * @param  NumOfValues: Number of values
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_WriterSetChannelDataValues(TDMS_Writer_t *Writer,
+                                TDMS_Channel_t *Channel,
+                                const void *Values,
+                                uint64_t NumOfValues)
+{
+  if (dataTypeLength[Channel->ChannelDataType] * NumOfValues == 0)
+    return TDMS_WRONG_ARG;
+
+
+  Channel->ChunkValues = (void *) Values;
+  Channel->ChunkNumOfValues = NumOfValues;
+
+  return TDMS_WriterGenDataSegment(Writer, &Channel, 1, 0, NULL);
+}
+
+
+/**
+ * @brief  Set data to Channels of a Group and save it into the sink
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Group: Pointer to TDMS Group object structure
+ * @param  ...: Pointer to Channels data values, Number of values (uint64_t).
+ *         (like TDMS_SetGroupDataValues)
+ * 
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_WriterSetGroupDataValues(TDMS_Writer_t *Writer,
+                              TDMS_Group_t *Group,
+                              ...
+                              )
+{
+  uint16_t CounterI = 0;
+  va_list valist;
+
+  /* initialize valist for num number of arguments */
+  va_start(valist, Group);
+
+  for(CounterI=0; CounterI<(Group->NumOfChannels); CounterI++)
+  {
+    Group->ChannelArray[CounterI]->ChunkValues = va_arg(valist, void*);
+    Group->ChannelArray[CounterI]->ChunkNumOfValues = va_arg(valist, uint64_t);
+  }
+
+  /* clean memory reserved for valist */
+  va_end(valist);
+
+  return TDMS_WriterGenDataSegment(Writer,
+                                   Group->ChannelArray, Group->NumOfChannels,
+                                   0, NULL);
+}
+
+
+/**
+ * @brief  Set data to Channels of a Group as interleaved raw data and save it
+ *         into the sink
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Group: Pointer to TDMS Group object structure
+ * @param  NumOfValues: Number of values of each Channel
+ * @param  ...: Pointer to data values of each Channel.
+ *         (like TDMS_SetGroupInterleavedDataValues)
+ * 
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_WriterSetGroupInterleavedDataValues(TDMS_Writer_t *Writer,
+                                         TDMS_Group_t *Group,
+                                         uint64_t NumOfValues,
+                                         ...
+                                         )
+{
+  uint16_t CounterI = 0;
+  va_list valist;
+
+  if (NumOfValues == 0)
+    return TDMS_WRONG_ARG;
+
+  /* initialize valist for num number of arguments */
+  va_start(valist, NumOfValues);
+
+  for(CounterI=0; CounterI<(Group->NumOfChannels); CounterI++)
+  {
+    Group->ChannelArray[CounterI]->ChunkValues = va_arg(valist, void*);
+    Group->ChannelArray[CounterI]->ChunkNumOfValues = NumOfValues;
+  }
+
+  /* clean memory reserved for valist */
+  va_end(valist);
+
+  return TDMS_WriterGenDataSegment(Writer,
+                                   Group->ChannelArray, Group->NumOfChannels,
+                                   1, NULL);
+}
+
+
+/**
+ * @brief  Set data to Channels of a Group from interleaved frames and save it
+ *         into the sink
+ * @note   If the sink supports scatter-gather write, the frames are not copied.
+ * 
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Group: Pointer to TDMS Group object structure
+ * @param  Frames: Pointer to the frames (like TDMS_SetGroupInterleavedFrames)
+ * @param  NumOfFrames: Number of frames
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_WriterSetGroupInterleavedFrames(TDMS_Writer_t *Writer,
+                                     TDMS_Group_t *Group,
+                                     const void *Frames,
+                                     uint64_t NumOfFrames)
+{
+  uint16_t CounterI = 0;
+
+  if (NumOfFrames == 0)
+    return TDMS_WRONG_ARG;
+
+  for(CounterI=0; CounterI<(Group->NumOfChannels); CounterI++)
+  {
+    Group->ChannelArray[CounterI]->ChunkValues = NULL;
+    Group->ChannelArray[CounterI]->ChunkNumOfValues = NumOfFrames;
+  }
+
+  return TDMS_WriterGenDataSegment(Writer,
+                                   Group->ChannelArray, Group->NumOfChannels,
+                                   1, Frames);
+}
+
+
+/**
+ * @brief  Set strings to a string Channel and save it into the sink
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Channel: Pointer to TDMS Channel object structure (TDMS_DataType_String)
+ * @param  Strings: Array of pointers to the strings
+ * @param  Lengths: Array of lengths of the strings (Byte). If it is Null, the
+ *                  strings must be NULL terminated.
+ * 
+ * @param  NumOfValues: Number of strings
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_WriterSetChannelStringValues(TDMS_Writer_t *Writer,
+                                  TDMS_Channel_t *Channel,
+                                  const char * const *Strings,
+                                  const uint32_t *Lengths,
+                                  uint64_t NumOfValues)
+{
+  if (!Strings)
+    return TDMS_WRONG_ARG;
+
+  return TDMS_WriterGenStringSegment(Writer, Channel, Strings, Lengths,
+                                     NULL, 0, NULL, NumOfValues);
+}
+
+
+/**
+ * @brief  Set packed strings to a string Channel and save it into the sink
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Channel: Pointer to TDMS Channel object structure (TDMS_DataType_String)
+ * @param  Packed: Pointer to the concatenated strings (without NULL characters)
+ * @param  PackedLen: Length of Packed (Byte)
+ * @param  EndOffsets: Array of end offsets of the strings in Packed (Byte, not
+ *                     decreasing and not more than PackedLen)
+ * 
+ * @param  NumOfValues: Number of strings
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_WriterSetChannelPackedStringValues(TDMS_Writer_t *Writer,
+                                        TDMS_Channel_t *Channel,
+                                        const char *Packed,
+                                        uint64_t PackedLen,
+                                        const uint32_t *EndOffsets,
+                                        uint64_t NumOfValues)
+{
+  if (!Packed || !EndOffsets)
+    return TDMS_WRONG_ARG;
+
+  return TDMS_WriterGenStringSegment(Writer, Channel, NULL, NULL,
+                                     Packed, PackedLen, EndOffsets, NumOfValues);
+}
+
+
+/**
+ ==================================================================================
+                         ##### Coalescer Functions #####
+ ==================================================================================
+ */
+
+/**
+ * @brief  Initialize Coalescer object structure
+ * @note   A Coalescer stages values of Channels and saves them as one raw data
+ *         segment by a Writer when a threshold is reached or
+ *         TDMS_CoalescerFlush is called.
+ * @note   On POSIX systems, time is measured by a monotonic clock in ms. On the
+ *         others, MaxTime is disabled until TDMS_CoalescerSetClock is called.
+ * 
+ * @param  Coalescer: Pointer to TDMS Coalescer object structure
+ * @param  Writer: Pointer to initialized TDMS Writer object structure
+ * @param  MaxBytes: Staged raw data (Byte) of all Channels that is saved
+ *                   (0: disabled)
+ * 
+ * @param  MaxValues: Staged values of a Channel that are saved (0: disabled)
+ * @param  MaxTime: Time (ms) after the first staged value that staged values
+ *                  are saved (0: disabled)
+ * 
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+TDMS_Result_t
+TDMS_InitCoalescer(TDMS_Coalescer_t *Coalescer, TDMS_Writer_t *Writer,
+                   uint64_t MaxBytes, uint64_t MaxValues, uint64_t MaxTime)
+{
+  if (!Writer)
+    return TDMS_WRONG_ARG;
+
+  Coalescer->Writer = Writer;
+  Coalescer->MaxBytes = MaxBytes;
+  Coalescer->MaxValues = MaxValues;
+  Coalescer->MaxTime = MaxTime;
+#if (TDMS_CONFIG_POSIX == 1)
+  Coalescer->GetTime = TDMS_CoalescerClock;
+#else
+  Coalescer->GetTime = NULL;
+#endif
+  Coalescer->Channels = NULL;
+  Coalescer->NumOfChannels = 0;
+  Coalescer->ChannelsSize = 0;
+  Coalescer->StagedBytes = 0;
+  Coalescer->FirstTime = 0;
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Set the time source of a Coalescer
+ * @param  Coalescer: Pointer to TDMS Coalescer object structure
+ * @param  GetTime: Function that returns current time in ms (Null disables
+ *                  MaxTime)
+ * 
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ */
+TDMS_Result_t
+TDMS_CoalescerSetClock(TDMS_Coalescer_t *Coalescer, uint64_t (*GetTime)(void))
+{
+  Coalescer->GetTime = GetTime;
+  if (GetTime && Coalescer->StagedBytes)
+    Coalescer->FirstTime = GetTime();
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Save the staged values and release the staging buffers
+ * @param  Coalescer: Pointer to TDMS Coalescer object structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_DeInitCoalescer(TDMS_Coalescer_t *Coalescer)
+{
+  TDMS_Result_t Result = TDMS_OK;
+  uint32_t CounterI = 0;
+
+  Result = TDMS_CoalescerFlush(Coalescer);
+
+  for (CounterI = 0; CounterI < Coalescer->NumOfChannels; CounterI++)
+  {
+    free(Coalescer->Channels[CounterI]->StageValues);
+    Coalescer->Channels[CounterI]->StageValues = NULL;
+    Coalescer->Channels[CounterI]->StageNumOfValues = 0;
+    Coalescer->Channels[CounterI]->StageSize = 0;
+  }
+
+  free(Coalescer->Channels);
+  Coalescer->Channels = NULL;
+  Coalescer->NumOfChannels = 0;
+  Coalescer->ChannelsSize = 0;
+  Coalescer->StagedBytes = 0;
+
+  return Result;
+}
+
+
+/**
+ * @brief  Stage data values of a Channel
+ * @note   Values are copied, so the buffer of values can be reused after the
+ *         call.
+ * 
+ * @param  Coalescer: Pointer to TDMS Coalescer object structure
+ * @param  Channel: Pointer to TDMS Channel object structure
+ * @param  Values: Pointer to data values
+ * @param  NumOfValues: Number of values
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_CoalescerSetChannelDataValues(TDMS_Coalescer_t *Coalescer,
+                                   TDMS_Channel_t *Channel,
+                                   const void *Values,
+                                   uint64_t NumOfValues)
+{
+  TDMS_Result_t Result = TDMS_OK;
+
+  if (dataTypeLength[Channel->ChannelDataType] * NumOfValues == 0)
+    return TDMS_WRONG_ARG;
+
+  Result = TDMS_CoalescerStage(Coalescer, Channel, Values, NumOfValues);
+  if (Result != TDMS_OK)
+    return Result;
+
+  return TDMS_CoalescerCheck(Coalescer, Channel);
+}
+
+
+/**
+ * @brief  Stage data values of Channels of a Group
+ * @param  Coalescer: Pointer to TDMS Coalescer object structure
+ * @param  Group: Pointer to TDMS Group object structure
+ * @param  ...: Pointer to Channels data values, Number of values (uint64_t).
+ *         (like TDMS_SetGroupDataValues)
+ * 
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_CoalescerSetGroupDataValues(TDMS_Coalescer_t *Coalescer,
+                                 TDMS_Group_t *Group,
+                                 ...
+                                 )
+{
+  TDMS_Result_t Result = TDMS_OK;
+  TDMS_Channel_t *Channel = NULL;
+  uint8_t Reached = 0;
+  uint16_t CounterI = 0;
+  const void *Values = NULL;
+  uint64_t NumOfValues = 0;
+  va_list valist;
+
+  // room is made for the values of all of the Channels first, so a failure
+  // stages none of them
+  va_start(valist, Group);
+
+  for(CounterI=0; CounterI<(Group->NumOfChannels); CounterI++)
+  {
+    Channel = Group->ChannelArray[CounterI];
+    Values = va_arg(valist, const void*);
+    NumOfValues = va_arg(valist, uint64_t);
+
+    if (Result == TDMS_OK)
+      Result = TDMS_CoalescerReserve(Coalescer, Channel, NumOfValues);
+  }
+
+  va_end(valist);
+
+  if (Result != TDMS_OK)
+    return Result;
+
+  /* initialize valist for num number of arguments */
+  va_start(valist, Group);
+
+  for(CounterI=0; CounterI<(Group->NumOfChannels); CounterI++)
+  {
+    Channel = Group->ChannelArray[CounterI];
+    Values = va_arg(valist, const void*);
+    NumOfValues = va_arg(valist, uint64_t);
+
+    TDMS_CoalescerStage(Coalescer, Channel, Values, NumOfValues);
+    if (Coalescer->MaxValues && Channel->StageNumOfValues >= Coalescer->MaxValues)
+      Reached = 1;
+  }
+
+  /* clean memory reserved for valist */
+  va_end(valist);
+
+  // all of the values of the Group are staged before saving them
+  if (Reached)
+    return TDMS_CoalescerFlush(Coalescer);
+
+  return TDMS_CoalescerCheck(Coalescer, NULL);
+}
+
+
+/**
+ * @brief  Save the staged values if MaxTime of Coalescer is elapsed
+ * @note   Thresholds are checked when values are staged. This function can be
+ *         called periodically to save the values of idle Channels in time.
+ * 
+ * @param  Coalescer: Pointer to TDMS Coalescer object structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_CoalescerPoll(TDMS_Coalescer_t *Coalescer)
+{
+  return TDMS_CoalescerCheck(Coalescer, NULL);
+}
+
+
+/**
+ * @brief  Save the staged values of all Channels as one raw data segment
+ * @note   If saving the segment fails, the values stay staged, so the flush can
+ *         be called again.
+ *
+ * @param  Coalescer: Pointer to TDMS Coalescer object structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_CoalescerFlush(TDMS_Coalescer_t *Coalescer)
+{
+  TDMS_Result_t Result = TDMS_OK;
+  TDMS_Channel_t *Channel = NULL;
+  uint32_t CounterI = 0;
+
+  if (Coalescer->StagedBytes == 0)
+    return TDMS_OK;
+
+  for (CounterI = 0; CounterI < Coalescer->NumOfChannels; CounterI++)
+  {
+    Channel = Coalescer->Channels[CounterI];
+    Channel->ChunkValues = Channel->StageValues;
+    Channel->ChunkNumOfValues = Channel->StageNumOfValues;
+  }
+
+  Result = TDMS_WriterGenDataSegment(Coalescer->Writer,
+                                     Coalescer->Channels,
+                                     Coalescer->NumOfChannels,
+                                     0, NULL);
+  if (Result != TDMS_OK)
+    return Result;
+
+  for (CounterI = 0; CounterI < Coalescer->NumOfChannels; CounterI++)
+    Coalescer->Channels[CounterI]->StageNumOfValues = 0;
+  Coalescer->StagedBytes = 0;
+
+  return TDMS_OK;
+}
+
+
+
+/**
+ ==================================================================================
+                       ##### Group Template Functions #####
+ ==================================================================================
+ */
+
+/**
+ * @brief  Initialize Group Template object structure
+ * @note   A Group Template holds the serialized Lead In part and meta data of
+ *         the raw data segments of a Group with fixed number of values of each
+ *         Channel, so the segments are generated without walking the Channels
+ *         and only the data values are copied (or passed to a scatter-gather
+ *         sink).
+ * @note   The Template must be initialized again if Channels are added to the
+ *         Group.
+ * 
+ * @param  Template: Pointer to TDMS Group Template object structure
+ * @param  Group: Pointer to TDMS Group object structure
+ * @param  NumOfValues: Array of number of values of each Channel of the Group
+ *                      (0: Channel is not in the segments)
+ * 
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ */
+TDMS_Result_t
+TDMS_InitGroupTemplate(TDMS_GroupTemplate_t *Template, TDMS_Group_t *Group,
+                       const uint64_t *NumOfValues)
+{
+  TDMS_Result_t Result = TDMS_OK;
+
+  Template->Group = Group;
+  Template->NumOfChannels = 0;
+  Template->NumOfValues = NULL;
+  Template->NumOfValuesOffset = NULL;
+  Template->Header = NULL;
+  Template->MetaDataLen = 0;
+  Template->RawDataLen = 0;
+
+  if (!Group || !NumOfValues || !Group->NumOfChannels)
+    return TDMS_WRONG_ARG;
+
+  Template->NumOfValues =
+      (uint64_t *) malloc(Group->NumOfChannels * sizeof(uint64_t));
+  Template->NumOfValuesOffset =
+      (uint64_t *) malloc(Group->NumOfChannels * sizeof(uint64_t));
+  if (!Template->NumOfValues || !Template->NumOfValuesOffset)
+  {
+    TDMS_DeInitGroupTemplate(Template);
+    return TDMS_NO_MEMORY;
+  }
+
+  Template->NumOfChannels = Group->NumOfChannels;
+  memcpy(Template->NumOfValues, NumOfValues,
+         Group->NumOfChannels * sizeof(uint64_t));
+
+  Result = TDMS_BuildGroupTemplate(Template);
+  if (Result != TDMS_OK)
+    TDMS_DeInitGroupTemplate(Template);
+
+  return Result;
+}
+
+
+/**
+ * @brief  Change number of values of the Channels of a Group Template
+ * @note   Numbers of values are patched in place, unless a Channel is added to
+ *         or removed from the segments (its number of values becomes or was 0).
+ * 
+ * @param  Template: Pointer to TDMS Group Template object structure
+ * @param  NumOfValues: Array of number of values of each Channel of the Group
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ */
+TDMS_Result_t
+TDMS_GroupTemplateSetNumOfValues(TDMS_GroupTemplate_t *Template,
+                                 const uint64_t *NumOfValues)
+{
+  TDMS_Result_t Result = TDMS_OK;
+  TDMS_Channel_t *Channel = NULL;
+  uint64_t *Previous = NULL;
+  uint64_t RawDataLen = 0;
+  uint32_t CounterI = 0;
+  uint8_t SameObjects = 1;
+
+  if (!Template->Header || !NumOfValues)
+    return TDMS_WRONG_ARG;
+
+  for (CounterI = 0; CounterI < Template->NumOfChannels; CounterI++)
+  {
+    if (!NumOfValues[CounterI] != !Template->NumOfValues[CounterI])
+      SameObjects = 0;
+  }
+
+  if (!SameObjects)
+  {
+    // object list is changed, keep the old Template if the new one is wrong
+    Previous = (uint64_t *) malloc(Template->NumOfChannels * sizeof(uint64_t));
+    if (!Previous)
+      return TDMS_NO_MEMORY;
+    memcpy(Previous, Template->NumOfValues,
+           Template->NumOfChannels * sizeof(uint64_t));
+    memcpy(Template->NumOfValues, NumOfValues,
+           Template->NumOfChannels * sizeof(uint64_t));
+
+    Result = TDMS_BuildGroupTemplate(Template);
+    if (Result != TDMS_OK)
+    {
+      memcpy(Template->NumOfValues, Previous,
+             Template->NumOfChannels * sizeof(uint64_t));
+      for (CounterI = 0; CounterI < Template->NumOfChannels; CounterI++)
+        Template->Group->ChannelArray[CounterI]->ChunkNumOfValues = Previous[CounterI];
+    }
+
+    free(Previous);
+    return Result;
+  }
+
+  for (CounterI = 0; CounterI < Template->NumOfChannels; CounterI++)
+  {
+    if (!NumOfValues[CounterI])
+      continue;
+
+    Channel = Template->Group->ChannelArray[CounterI];
+    RawDataLen += dataTypeLength[Channel->ChannelDataType] * NumOfValues[CounterI];
+    Template->NumOfValues[CounterI] = NumOfValues[CounterI];
+    TDMS_SaveData64(&Template->Header[Template->NumOfValuesOffset[CounterI]],
+                    NumOfValues[CounterI]);
+  }
+
+  Template->RawDataLen = RawDataLen;
+  TDMS_GroupTemplateLeadIn(Template);
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Release the memory of a Group Template
+ * @param  Template: Pointer to TDMS Group Template object structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ */
+TDMS_Result_t
+TDMS_DeInitGroupTemplate(TDMS_GroupTemplate_t *Template)
+{
+  free(Template->NumOfValues);
+  free(Template->NumOfValuesOffset);
+  free(Template->Header);
+  Template->NumOfValues = NULL;
+  Template->NumOfValuesOffset = NULL;
+  Template->Header = NULL;
+  Template->NumOfChannels = 0;
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Set data to Channels of a Group by its Template
+ * @note   Like TDMS_SetGroupDataValues with the number of values of the
+ *         Template. The buffer must be saved on disk, after each call with a
+ *         valid buffer address.
+ * 
+ * @param  Template: Pointer to TDMS Group Template object structure
+ * @param  Buffer: Pointer to the buffer that data save in
+ * @note   If the buffer address is Null, then function only calculates needed
+ *         buffer size and returns TDMS_OK.
+ * 
+ * @param  Size: Size of data in buffer (Byte)
+ * @param  Values: Array of pointers to data values of each Channel of the Group
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+TDMS_Result_t
+TDMS_SetGroupTemplateDataValues(TDMS_GroupTemplate_t *Template,
+                                uint8_t *Buffer,
+                                uint64_t *Size,
+                                const void * const *Values)
+{
+  uint8_t *Header = NULL;
+  uint64_t HeaderLen = 0;
+
+  Header = TDMS_GroupTemplateHeader(Template, Values, &HeaderLen);
+  if (!Header)
+    return TDMS_WRONG_ARG;
+
+  *Size = HeaderLen + Template->RawDataLen;
+  if (Buffer == NULL)
+    return TDMS_OK;
+
+  if (Header == Template->Header)
+    TDMS_SaveLayout((TDMS_File_t *) Template->Group->FileOfGroup,
+                    Template->Group->ChannelArray, Template->NumOfChannels);
+  TDMS_CountWaveformValues(Template->Group->ChannelArray,
+                           Template->NumOfChannels);
+
+  memcpy(Buffer, Header, (size_t) HeaderLen);
+  TDMS_GroupTemplateRawData(Template, &Buffer[HeaderLen]);
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Save a header and the raw data of a Group Template into the sink of a
+ *         Writer
+ * @note   Data values must be set to ChunkValues of the Channels. If the sink
+ *         supports scatter-gather write, the data values are not copied.
+ * 
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Template: Pointer to TDMS Group Template object structure
+ * @param  Header: Pointer to Lead In part and meta data (Null: only raw data)
+ * @param  HeaderLen: Length of the header (Byte)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+static TDMS_Result_t
+TDMS_WriterSaveTemplateData(TDMS_Writer_t *Writer,
+                            TDMS_GroupTemplate_t *Template,
+                            const uint8_t *Header, uint64_t HeaderLen)
+{
+  TDMS_Result_t Result = TDMS_OK;
+  TDMS_Channel_t *Channel = NULL;
+  uint64_t ConvertLen = 0;
+  uint64_t Len = 0;
+  uint32_t NumOfIoVec = 0;
+  uint32_t CounterI = 0;
+
+  if (!Writer->Sink.Writev)
+  {
+    Result = TDMS_WriterReserve(Writer, HeaderLen + Template->RawDataLen);
+    if (Result != TDMS_OK)
+      return Result;
+
+    if (HeaderLen)
+      memcpy(Writer->Buffer, Header, (size_t) HeaderLen);
+    TDMS_GroupTemplateRawData(Template, &Writer->Buffer[HeaderLen]);
+
+    Result = Writer->Sink.Write(Writer->Sink.Context, Writer->Buffer,
+                                HeaderLen + Template->RawDataLen);
+    if (Result != TDMS_OK)
+      return Result;
+
+    Writer->Offset += HeaderLen + Template->RawDataLen;
+
+    return TDMS_OK;
+  }
+
+  Result = TDMS_WriterReserveIoVec(Writer, Template->NumOfChannels + 1);
+  if (Result != TDMS_OK)
+    return Result;
+
+  // values that must be converted to output Endianness or to 0 and 1 are
+  // generated in the buffer of the Writer
+  for (CounterI = 0; CounterI < Template->NumOfChannels; CounterI++)
+  {
+    Channel = Template->Group->ChannelArray[CounterI];
+    if (!TDMS_IsNativeRawData(Channel->ChannelDataType))
+      ConvertLen += dataTypeLength[Channel->ChannelDataType] *
+                    Template->NumOfValues[CounterI];
+  }
+  Result = TDMS_WriterReserve(Writer, ConvertLen);
+  if (Result != TDMS_OK)
+    return Result;
+
+  if (HeaderLen)
+  {
+    Writer->IoVec[NumOfIoVec].Base = Header;
+    Writer->IoVec[NumOfIoVec].Len = HeaderLen;
+    NumOfIoVec++;
+  }
+  ConvertLen = 0;
+  for (CounterI = 0; CounterI < Template->NumOfChannels; CounterI++)
+  {
+    Channel = Template->Group->ChannelArray[CounterI];
+    if (!Template->NumOfValues[CounterI])
+      continue;
+
+    Len = dataTypeLength[Channel->ChannelDataType] *
+          Template->NumOfValues[CounterI];
+    Writer->IoVec[NumOfIoVec].Base = Channel->ChunkValues;
+    Writer->IoVec[NumOfIoVec].Len = Len;
+    if (!TDMS_IsNativeRawData(Channel->ChannelDataType))
+    {
+      TDMS_ConvertValues(&Writer->Buffer[ConvertLen],
+                         (const uint8_t *) Channel->ChunkValues,
+                         Channel->ChannelDataType,
+                         Template->NumOfValues[CounterI]);
+      Writer->IoVec[NumOfIoVec].Base = &Writer->Buffer[ConvertLen];
+      ConvertLen += Len;
+    }
+    NumOfIoVec++;
+  }
+
+  Result = Writer->Sink.Writev(Writer->Sink.Context, Writer->IoVec, NumOfIoVec);
+  if (Result != TDMS_OK)
+    return Result;
+
+  for (CounterI = 0; CounterI < NumOfIoVec; CounterI++)
+    Writer->Offset += Writer->IoVec[CounterI].Len;
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Set data to Channels of a Group by its Template and save it into the
+ *         sink of a Writer
+ * @note   If the sink supports scatter-gather write, the data values are not
+ *         copied.
+ * 
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Template: Pointer to TDMS Group Template object structure
+ * @param  Values: Array of pointers to data values of each Channel of the Group
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_WriterSetGroupTemplateDataValues(TDMS_Writer_t *Writer,
+                                      TDMS_GroupTemplate_t *Template,
+                                      const void * const *Values)
+{
+  TDMS_Result_t Result = TDMS_OK;
+  uint8_t *Header = NULL;
+  uint64_t HeaderLen = 0;
+
+  if (Writer->File != (TDMS_File_t *) Template->Group->FileOfGroup)
+    return TDMS_WRONG_ARG;
+
+  Header = TDMS_GroupTemplateHeader(Template, Values, &HeaderLen);
+  if (!Header)
+    return TDMS_WRONG_ARG;
+
+  Result = TDMS_WriterSaveTemplateData(Writer, Template, Header, HeaderLen);
+  if (Result != TDMS_OK)
+    return Result;
+
+  if (Header == Template->Header)
+    TDMS_SaveLayout(Writer->File,
+                    Template->Group->ChannelArray, Template->NumOfChannels);
+  TDMS_CountWaveformValues(Template->Group->ChannelArray,
+                           Template->NumOfChannels);
+
+  return TDMS_WriterEndSegment(Writer, Header);
+}
+
+
+
+/**
+ ==================================================================================
+                     ##### Streaming Segment Functions #####
+ ==================================================================================
+ */
+
+/**
+ * @brief  Start a raw data segment of a Group Template that stays open, so the
+ *         raw data of next writes is appended to it without any Lead In part
+ *         or meta data
+ * @note   NextSegmentOffset of the segment is 0xFFFFFFFFFFFFFFFF until
+ *         TDMS_EndStreamSegment patches it, so a file that is not closed (e.g.
+ *         after a crash) can still be read (readers use the end of file and
+ *         whole chunks).
+ * @note   The Writer must not save other data until TDMS_EndStreamSegment is
+ *         called, and its sink must support WriteAt and save from the start of
+ *         the file.
+ * 
+ * @param  Segment: Pointer to TDMS Streaming Segment structure
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Template: Pointer to TDMS Group Template object structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument (e.g. sink has no WriteAt)
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_BeginStreamSegment(TDMS_StreamSegment_t *Segment, TDMS_Writer_t *Writer,
+                        TDMS_GroupTemplate_t *Template)
+{
+  TDMS_Result_t Result = TDMS_OK;
+  TDMS_Group_t *Group = Template->Group;
+  uint32_t ToC = 0;
+  uint32_t CounterI = 0;
 
-  /*** ***/
-  /*** generate meta data ***/
-  /*** ***/
-  DataSize += TDMS_SaveDataLittleEndian32(&Buffer[DataSize], 1); // Number of objects
+  if (!Writer->Sink.WriteAt || !Template->Header ||
+      Writer->File != (TDMS_File_t *) Group->FileOfGroup ||
+      Group->NumOfChannels != Template->NumOfChannels)
+    return TDMS_WRONG_ARG;
 
-  /*** File meta data ***/
-  DataSize += TDMS_SaveStrToMetaDataPart(&Buffer[DataSize],
-                                         Path); // Object path
-  DataSize += TDMS_SaveDataLittleEndian32(&Buffer[DataSize],
-                                          0xFFFFFFFF); // Raw data index = 0xFFFFFFFF
-  DataSize += TDMS_SaveDataLittleEndian32(&Buffer[DataSize],
-                                          0x01); // Number of properties
-
-  DataSize += TDMS_SaveStrToMetaDataPart(&Buffer[DataSize],
-                                         Name); // first Property name
-  DataSize += TDMS_SaveDataLittleEndian32(&Buffer[DataSize],
-                                          dataTypeBinary[DataType]); // Data type of the property value
-  
-  if (DataType == TDMS_DataType_String)
+  Segment->HeaderLen = LeadInPartLen + Template->MetaDataLen;
+  Segment->Header = (uint8_t *) malloc((size_t) Segment->HeaderLen);
+  if (!Segment->Header)
+    return TDMS_NO_MEMORY;
+
+  // the segment has the object list of the Template and unknown length
+  memcpy(Segment->Header, Template->Header, (size_t) Segment->HeaderLen);
+  ToC = TDMS_LoadLeadInToC(Template->Header);
+  TDMS_GenerateLeadInPart(Segment->Header, ToC,
+                          0xFFFFFFFFFFFFFFFF, Template->MetaDataLen);
+
+  Result = Writer->Sink.Write(Writer->Sink.Context,
+                              Segment->Header, Segment->HeaderLen);
+  if (Result != TDMS_OK)
   {
-    DataSize += TDMS_SaveStrToMetaDataPart(&Buffer[DataSize],
-                                           (char *)Value); // Value of the property
+    free(Segment->Header);
+    Segment->Header = NULL;
+    return Result;
   }
-  else
+
+  Segment->Writer = Writer;
+  Segment->Template = Template;
+  Segment->Start = Writer->Offset;
+  Segment->RawDataLen = 0;
+  Writer->Offset += Segment->HeaderLen;
+
+  for (CounterI = 0; CounterI < Template->NumOfChannels; CounterI++)
+    Group->ChannelArray[CounterI]->ChunkNumOfValues = Template->NumOfValues[CounterI];
+  TDMS_SaveLayout(Writer->File, Group->ChannelArray, Template->NumOfChannels);
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Append data values of Channels of the Group (a chunk with the number
+ *         of values of the Template) to a Streaming Segment
+ * @note   If the sink supports scatter-gather write, the data values are not
+ *         copied.
+ * 
+ * @param  Segment: Pointer to TDMS Streaming Segment structure
+ * @param  Values: Array of pointers to data values of each Channel of the Group
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_StreamSegmentSetDataValues(TDMS_StreamSegment_t *Segment,
+                                const void * const *Values)
+{
+  TDMS_Result_t Result = TDMS_OK;
+  TDMS_GroupTemplate_t *Template = Segment->Template;
+  TDMS_Group_t *Group = NULL;
+  uint32_t CounterI = 0;
+
+  if (!Segment->Header)
+    return TDMS_WRONG_ARG;
+
+  Group = Template->Group;
+  if (Group->NumOfChannels != Template->NumOfChannels)
+    return TDMS_WRONG_ARG;
+
+  for (CounterI = 0; CounterI < Template->NumOfChannels; CounterI++)
   {
-    memcpy(&Buffer[DataSize], Value, PropertyDataLen);
-    DataSize += PropertyDataLen;
+    Group->ChannelArray[CounterI]->ChunkValues = (void *) Values[CounterI];
+    Group->ChannelArray[CounterI]->ChunkNumOfValues = Template->NumOfValues[CounterI];
   }
-  
-  *Size = DataSize;
-  
+
+  Result = TDMS_WriterSaveTemplateData(Segment->Writer, Template, NULL, 0);
+  if (Result != TDMS_OK)
+    return Result;
+
+  Segment->RawDataLen += Template->RawDataLen;
+  TDMS_CountWaveformValues(Group->ChannelArray, Template->NumOfChannels);
+
   return TDMS_OK;
 }
 
 
+/**
+ * @brief  Close a Streaming Segment (patch the offsets of its Lead In part and
+ *         save it into the index sink)
+ * @param  Segment: Pointer to TDMS Streaming Segment structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_EndStreamSegment(TDMS_StreamSegment_t *Segment)
+{
+  TDMS_Writer_t *Writer = Segment->Writer;
+  TDMS_Result_t Result = TDMS_OK;
+  uint32_t ToC = 0;
+
+  if (!Segment->Header)
+    return TDMS_OK;
+
+  ToC = TDMS_LoadLeadInToC(Segment->Header);
+  TDMS_GenerateLeadInPart(Segment->Header, ToC,
+                          Segment->Template->MetaDataLen + Segment->RawDataLen,
+                          Segment->Template->MetaDataLen);
+
+  Result = Writer->Sink.WriteAt(Writer->Sink.Context,
+                                Segment->Header, LeadInPartLen, Segment->Start);
+  if (Result == TDMS_OK)
+    Result = TDMS_WriterEndSegment(Writer, Segment->Header);
+
+  free(Segment->Header);
+  Segment->Header = NULL;
+
+  return Result;
+}
+
+
 
 /**
  ==================================================================================
-                            ##### Public Functions #####                           
+                      ##### Property Builder Functions #####
  ==================================================================================
  */
 
 /**
- * @brief  Initialize File object structure
- * @param  File: Pointer to File object structure
+ * @brief  Initialize Property Builder object structure
+ * @note   A Property Builder collects Properties of any number of objects of a
+ *         File and generates all of them in one meta data segment (or in first
+ *         part of the file), instead of a segment for each Property.
+ * 
+ * @param  Builder: Pointer to TDMS Property Builder object structure
+ * @param  File: Pointer to TDMS File object structure
  * @retval TDMS_Result_t
  *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
  */
 TDMS_Result_t
-TDMS_InitFile(TDMS_File_t *File)
+TDMS_InitPropertyBuilder(TDMS_PropertyBuilder_t *Builder, TDMS_File_t *File)
 {
-  File->NumOfGroups = 0;
-  
+  if (!File)
+    return TDMS_WRONG_ARG;
+
+  Builder->File = File;
+  Builder->Objects = NULL;
+  Builder->NumOfObjects = 0;
+  Builder->ObjectsSize = 0;
+  Builder->ObjectHash = NULL;
+  Builder->ObjectHashSize = 0;
+  Builder->Properties = NULL;
+  Builder->PropertiesLen = 0;
+  Builder->PropertiesSize = 0;
+
   return TDMS_OK;
 }
 
 
 /**
- * @brief  Initialize Channel Group object structure
- * @param  Group: Pointer to TDMS Channel Group object structure
- * @param  File: Pointer to the File object structure that Channel Group assign
- *               into
- * @param  Name: Channel Group name
+ * @brief  Remove all Properties of a Property Builder (its memory is reused)
+ * @param  Builder: Pointer to TDMS Property Builder object structure
  * @retval TDMS_Result_t
  *         - TDMS_OK: Operation was successful
- *         - TDMS_OUT_OF_CAP: The file object capacity is full
  */
 TDMS_Result_t
-TDMS_AddGroupToFile(TDMS_Group_t *Group, TDMS_File_t *File, char *Name)
+TDMS_ClearPropertyBuilder(TDMS_PropertyBuilder_t *Builder)
 {
-  // Group path
-  TDMS_GenerateGroupPath(Group->GroupPath, Name);
-  
-  // set File pointer
-  Group->FileOfGroup = (void *) File;
-  
-  // add group to file obj
-  if (File->NumOfGroups >= TDMS_CONFIG_MAX_GROUP_OF_FILE)
-    return TDMS_OUT_OF_CAP;
-  File->GroupArray[File->NumOfGroups] = Group;
-  File->NumOfGroups++;
-  
-  Group->NumOfChannels = 0;
-  
+  if (Builder->ObjectHash)
+    memset(Builder->ObjectHash, 0,
+           Builder->ObjectHashSize * sizeof(uint32_t));
+  Builder->NumOfObjects = 0;
+  Builder->PropertiesLen = 0;
+
   return TDMS_OK;
 }
 
 
 /**
- * @brief  Initialize Channel object structure
- * @param  Channel: Pointer to TDMS Channel object structure
- * @param  Group: Pointer to the Channel Group object structure that Channel assign
- *                into
+ * @brief  Release the memory of a Property Builder
+ * @param  Builder: Pointer to TDMS Property Builder object structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ */
+TDMS_Result_t
+TDMS_DeInitPropertyBuilder(TDMS_PropertyBuilder_t *Builder)
+{
+  free(Builder->Objects);
+  free(Builder->ObjectHash);
+  free(Builder->Properties);
+
+  return TDMS_InitPropertyBuilder(Builder, Builder->File);
+}
+
+
+/**
+ * @brief  Add Property to the file object of a Property Builder
+ * @note   The value is copied into the Builder.
  * 
- * @param  Name: Pointer to Name of TDMS Channel object
- * @param  DataType: Data type of Channel Raw data
- *         - TDMS_DataType_Void: Data type is unknown
- *         - TDMS_DataType_I8: signed int 8 bit
- *         - TDMS_DataType_I16: signed int 16 bit
- *         - TDMS_DataType_I32: signed int 32 bit
- *         - TDMS_DataType_I64: signed int 64 bit
- *         - TDMS_DataType_U8: unsigned int 8 bit
- *         - TDMS_DataType_U16: unsigned int 16 bit
- *         - TDMS_DataType_U32: unsigned int 32 bit
- *         - TDMS_DataType_U64: unsigned int 64 bit
- *         - TDMS_DataType_SingleFloat: 4 byte floating point number
- *         - TDMS_DataType_DoubleFloat: 8 byte floating point number
- *         - TDMS_DataType_String: string, array of characters
- *         - TDMS_DataType_Boolean: boolean data
- *         - TDMS_DataType_TimeStamp: time stamp data
+ * @param  Builder: Pointer to TDMS Property Builder object structure
+ * @param  Name: Name of Property
+ * @param  DataType: Data type of Property
+ * @param  Value: Pointer to the value of Property (NULL terminated string for
+ *                TDMS_DataType_String)
  * 
  * @retval TDMS_Result_t
  *         - TDMS_OK: Operation was successful
  *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
  */
 TDMS_Result_t
-TDMS_AddChannelToGroup(TDMS_Channel_t *Channel, TDMS_Group_t *Group,
-                       char *Name, TDMS_Data_t DataType)
+TDMS_PropertyBuilderAddToFile(TDMS_PropertyBuilder_t *Builder,
+                              const char *Name, TDMS_Data_t DataType,
+                              const void *Value)
 {
-  if(dataTypeLength[DataType] == 0)
-    return TDMS_WRONG_ARG;
-  
-  Channel->ChannelDataType = DataType;
-  
-  // channel path
-  TDMS_GenerateChannelPath(Group, Channel->ChannelPath, Name);
-  
-  // set Group pointer
-  Channel->GroupOfChannel = (void *) Group;
-  
-  // add channel to group obj
-  if (Group->NumOfChannels >= TDMS_CONFIG_MAX_CHANNEL_OF_GROUP)
-    return TDMS_OUT_OF_CAP;
-  Group->ChannelArray[Group->NumOfChannels] = Channel;
-  Group->NumOfChannels++;
-
-  
-  return TDMS_OK;
+  return TDMS_PropertyBuilderAdd(Builder, filePathBytes, 1, NULL,
+                                 Name, DataType, Value);
 }
 
 
 /**
- * @brief  Generate First part of TDMS file
- * @param  File: Pointer to TDMS File object structure
- * @param  Buffer: Pointer to the buffer that data save in
- * @param  Size: Size of data in buffer (Byte)
+ * @brief  Add Property to a Group of a Property Builder
+ * @param  Builder: Pointer to TDMS Property Builder object structure
+ * @param  Group: Pointer to TDMS Group object structure
+ * @param  Name: Name of Property
+ * @param  DataType: Data type of Property
+ * @param  Value: Pointer to the value of Property
  * @retval TDMS_Result_t
  *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
  */
 TDMS_Result_t
-TDMS_GenFirstPart(TDMS_File_t *File,
-                  uint8_t *Buffer,
-                  uint32_t *Size)
+TDMS_PropertyBuilderAddToGroup(TDMS_PropertyBuilder_t *Builder,
+                               TDMS_Group_t *Group,
+                               const char *Name, TDMS_Data_t DataType,
+                               const void *Value)
 {
-  uint32_t CounterI = 0;
-  uint32_t CounterJ = 0;
-  uint32_t CounterK = 0;
-  uint32_t nog = 0; // Number Of Groups
-  uint32_t noc[TDMS_CONFIG_MAX_CHANNEL_OF_GROUP] = {0}; // Number Of Channel of each Group
-  uint32_t tnoc = 0; //  Total Number Of Channel
-  uint32_t noo = 0; //  Number Of Objects
-  uint32_t MetaDataLen = 0;
-  uint32_t DataSize = 0;
-  
-  #define RawDataLen	0
-  
-  /*** ***/
-  /*** calculate number of objects ***/
-  /*** ***/
-  nog = File->NumOfGroups;
-  for(CounterI=0; CounterI<nog; CounterI++)
-  {
-    noc[CounterI] = File->GroupArray[CounterI]->NumOfChannels;
-    tnoc += noc[CounterI];
-  }
-  noo = nog + tnoc + 1; // Groups number + total number of Channels + File object
+  if (!Group || Group->FileOfGroup != (void *) Builder->File)
+    return TDMS_WRONG_ARG;
 
-  
-  MetaDataLen = 0;
+  return TDMS_PropertyBuilderAdd(Builder,
+                                 Group->GroupPathBytes, Group->GroupPathLen,
+                                 NULL, Name, DataType, Value);
+}
 
-  /*** File meta data ***/
-  // (4B number of objects) +
-  // (4B file path length) + (1B file path) +
-  // (4B raw data index) + (4B number of properties)
-  MetaDataLen += 17;
-  
-  /*** Groups meta data ***/
-  for(CounterI=0; CounterI<nog; CounterI++)
-  {
-    // (4B gorup path length) + (4B raw data index) + (4B number of properties)
-    MetaDataLen += 12;
-    MetaDataLen += strlen(File->GroupArray[CounterI]->GroupPath); // Groups path length
-    
-    /*** Channels meta data ***/
-    for(CounterJ=0; CounterJ<noc[CounterI]; CounterJ++)
-    {
-      // (4B channel path length) + (4B raw data index) + (4B number of properties)
-      MetaDataLen += 12;
-      MetaDataLen += strlen(File->GroupArray[CounterI]->ChannelArray[CounterJ]->ChannelPath); //Channels path
-    }//for(CounterJ=0; CounterJ<noc[CounterI]; CounterJ++)
-  }//for(CounterI=0; CounterI<nog; CounterI++)
-  
 
-  /*** ***/
-  /*** if Buffer address is NULL, return back. ***/
-  /*** ***/
-  if(Buffer == NULL)
-  {
-    DataSize = LeadInPartLen + MetaDataLen + RawDataLen;
-    *Size = DataSize;
-    
-    return TDMS_OK;
-  }
-  
-  /*** ***/
-  /*** generate lead in part ***/
-  /*** ***/
-  TDMS_GenerateLeadInPart(&Buffer[DataSize],
-                          kTocMetaData | kTocNewObjList,
-                          MetaDataLen + RawDataLen,
-                          MetaDataLen);
-  DataSize += LeadInPartLen;
-  
-  
-  /*** ***/
-  /*** generate meta data ***/
-  /*** ***/
-  DataSize += TDMS_SaveDataLittleEndian32(&Buffer[DataSize],
-                                          noo); // Number of objects
+/**
+ * @brief  Add Property to a Channel of a Property Builder
+ * @param  Builder: Pointer to TDMS Property Builder object structure
+ * @param  Channel: Pointer to TDMS Channel object structure
+ * @param  Name: Name of Property
+ * @param  DataType: Data type of Property
+ * @param  Value: Pointer to the value of Property
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ */
+TDMS_Result_t
+TDMS_PropertyBuilderAddToChannel(TDMS_PropertyBuilder_t *Builder,
+                                 TDMS_Channel_t *Channel,
+                                 const char *Name, TDMS_Data_t DataType,
+                                 const void *Value)
+{
+  TDMS_Group_t *Group = NULL;
 
-  /*** File meta data ***/
-  DataSize += TDMS_SaveStrToMetaDataPart(&Buffer[DataSize],
-                                         "/"); // File path
-  DataSize += TDMS_SaveDataLittleEndian32(&Buffer[DataSize],
-                                          0xFFFFFFFF); // Raw data index = 0xFFFFFFFF
-  DataSize += TDMS_SaveDataLittleEndian32(&Buffer[DataSize],
-                                          0x00); // Number of properties
+  if (!Channel)
+    return TDMS_WRONG_ARG;
 
-  /*** Goups meta data ***/
-  for (CounterI = 0; CounterI < nog; CounterI++)
-  {
-    CounterK = strlen(File->GroupArray[CounterI]->GroupPath);
-    DataSize += TDMS_SaveDataLittleEndian32(&Buffer[DataSize],
-                                            CounterK); // Length of Groups path
-    strcpy((char *)&Buffer[DataSize],
-           (const char *)File->GroupArray[CounterI]->GroupPath); // Groups path
-    DataSize += CounterK;
-    DataSize += TDMS_SaveDataLittleEndian32(&Buffer[DataSize],
-                                            0xFFFFFFFF); // Raw data index = 0xFFFFFFFF
-    DataSize += TDMS_SaveDataLittleEndian32(&Buffer[DataSize],
-                                            0x00); // Number of properties
+  Group = (TDMS_Group_t *) Channel->GroupOfChannel;
+  if (!Group || Group->FileOfGroup != (void *) Builder->File)
+    return TDMS_WRONG_ARG;
 
-    /*** Channels meta data ***/
-    for(CounterJ=0; CounterJ<noc[CounterI]; CounterJ++)
-    {
-      CounterK = strlen(File->GroupArray[CounterI]->ChannelArray[CounterJ]->ChannelPath);
-      DataSize += TDMS_SaveDataLittleEndian32(&Buffer[DataSize],
-                                              CounterK); // Length of Channels path
-      strcpy((char *)&Buffer[DataSize],
-             (const char *)File->GroupArray[CounterI]->ChannelArray[CounterJ]->ChannelPath); // Channels path
-      DataSize += CounterK;
-
-      DataSize += TDMS_SaveDataLittleEndian32(&Buffer[DataSize],
-                                              0xFFFFFFFF); // Raw data index = 0xFFFFFFFF
-
-      DataSize += TDMS_SaveDataLittleEndian32(&Buffer[DataSize],
-                                              0x00); // Number of properties
-    }//for(CounterJ=0; CounterJ<noc[CounterI]; CounterJ++)
-  }  //for(CounterI=0; CounterI<nog; CounterI++)
+  return TDMS_PropertyBuilderAdd(Builder,
+                                 Channel->ChannelPathBytes,
+                                 Channel->ChannelPathLen,
+                                 Channel, Name, DataType, Value);
+}
 
-  *Size = DataSize;
-  
-  #undef RawDataLen
-  
-  return TDMS_OK;
+
+/**
+ * @brief  Generate one meta data segment with all Properties of a Property
+ *         Builder
+ * @note   The segment does not contain a new object list, so the object list
+ *         of previous raw data segment stays valid for next segments.
+ *         Properties stay in the Builder until TDMS_ClearPropertyBuilder is
+ *         called.
+ * 
+ * @param  Builder: Pointer to TDMS Property Builder object structure
+ * @param  Buffer: Pointer to the buffer that data save in
+ * @note   If the buffer address is Null, then function only calculates needed
+ *         buffer size and returns TDMS_OK.
+ * 
+ * @param  Size: Size of data in buffer (Byte, 0 if Builder is empty)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ */
+TDMS_Result_t
+TDMS_GenPropertySegment(TDMS_PropertyBuilder_t *Builder,
+                        uint8_t *Buffer,
+                        uint64_t *Size)
+{
+  return TDMS_GenBuilderSegment(Builder, Buffer, UnknownBufferSize, Size);
 }
 
 
 /**
- * @brief  Add Property to the file object
- * @note   To use this function, you must first create and initialize the File and
- *         use TDMS_GenFirstPart
+ * @brief  Generate First part of TDMS file with the Properties of a Property
+ *         Builder
+ * @note   Like TDMS_GenFirstPart, but Properties of the objects are saved in
+ *         their entries of the object list.
  * 
+ * @param  Builder: Pointer to TDMS Property Builder object structure
  * @param  Buffer: Pointer to the buffer that data save in
  * @note   If the buffer address is Null, then function only calculates needed
- *         buffer size
+ *         buffer size and returns TDMS_OK.
  * 
  * @param  Size: Size of data in buffer (Byte)
- * @param  Name: Name of Property
- * @param  DataType: Data type of Property
- * @param  Value: Pointer to the value of Property
  * @retval TDMS_Result_t
  *         - TDMS_OK: Operation was successful
- *         - TDMS_WRONG_ARG: Wrong argument
  */
 TDMS_Result_t
-TDMS_AddPropertyToFile(uint8_t *Buffer, uint32_t *Size,
-                       char *Name, TDMS_Data_t DataType, void *Value)
+TDMS_GenFirstPartWithProperties(TDMS_PropertyBuilder_t *Builder,
+                                uint8_t *Buffer,
+                                uint64_t *Size)
 {
-  return TDMS_AddPropertyToObject("/", Buffer, Size, Name, DataType, Value);
+  return TDMS_GenFirstPartSegment(Builder->File, Builder,
+                                  Buffer, UnknownBufferSize, Size);
 }
 
 
 /**
- * @brief  Add Property to the group object
- * @note   To use this function, you must first create and initialize the File and
- *         use TDMS_GenFirstPart
- * 
- * @param  Group: Pointer to TDMS group object structure
- * @param  Buffer: Pointer to the buffer that data save in
- * @note   If the buffer address is Null, then function only calculates needed
- *         buffer size
- * 
- * @param  Size: Size of data in buffer (Byte)
- * @param  Name: Name of Property
- * @param  DataType: Data type of Property
- * @param  Value: Pointer to the value of Property
+ * @brief  Generate one meta data segment with all Properties of a Property
+ *         Builder and save it into the sink
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Builder: Pointer to TDMS Property Builder object structure
  * @retval TDMS_Result_t
  *         - TDMS_OK: Operation was successful
  *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
  */
 TDMS_Result_t
-TDMS_AddPropertyToGroup(TDMS_Group_t *Group,
-                        uint8_t *Buffer, uint32_t *Size,
-                        char *Name, TDMS_Data_t DataType, void *Value)
+TDMS_WriterSaveProperties(TDMS_Writer_t *Writer,
+                          TDMS_PropertyBuilder_t *Builder)
 {
-  return TDMS_AddPropertyToObject(Group->GroupPath, Buffer, Size, Name, DataType, Value);
+  TDMS_Result_t Result = TDMS_OK;
+  uint64_t Size = 0;
+
+  if (Writer->File != Builder->File)
+    return TDMS_WRONG_ARG;
+
+  Result = TDMS_GenBuilderSegment(Builder,
+                                  Writer->Buffer, Writer->BufferSize, &Size);
+  if (Result == TDMS_OUT_OF_CAP)
+  {
+    Result = TDMS_WriterReserve(Writer, Size);
+    if (Result == TDMS_OK)
+      Result = TDMS_GenBuilderSegment(Builder,
+                                      Writer->Buffer, Writer->BufferSize,
+                                      &Size);
+  }
+  if (Result != TDMS_OK)
+    return Result;
+
+  return TDMS_WriterSave(Writer, Size);
 }
 
 
 /**
- * @brief  Add Property to the channel object
- * @note   To use this function, you must first create and initialize the File and
- *         use TDMS_GenFirstPart
- * 
- * @param  Channel: Pointer to TDMS channel object structure
- * @param  Buffer: Pointer to the buffer that data save in
- * @note   If the buffer address is Null, then function only calculates needed
- *         buffer size
- * 
- * @param  Size: Size of data in buffer (Byte)
- * @param  Name: Name of Property
- * @param  DataType: Data type of Property
- * @param  Value: Pointer to the value of Property
+ * @brief  Generate First part of TDMS file with the Properties of a Property
+ *         Builder and save it into the sink
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Builder: Pointer to TDMS Property Builder object structure
  * @retval TDMS_Result_t
  *         - TDMS_OK: Operation was successful
  *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
  */
 TDMS_Result_t
-TDMS_AddPropertyToChannel(TDMS_Channel_t *Channel,
-                          uint8_t *Buffer, uint32_t *Size,
-                          char *Name, TDMS_Data_t DataType, void *Value)
+TDMS_WriterGenFirstPartWithProperties(TDMS_Writer_t *Writer,
+                                      TDMS_PropertyBuilder_t *Builder)
 {
-  return TDMS_AddPropertyToObject(Channel->ChannelPath, Buffer, Size, Name, DataType, Value);
+  TDMS_Result_t Result = TDMS_OK;
+  uint64_t Size = 0;
+
+  if (Writer->File != Builder->File)
+    return TDMS_WRONG_ARG;
+
+  Result = TDMS_GenFirstPartSegment(Writer->File, Builder,
+                                    Writer->Buffer, Writer->BufferSize, &Size);
+  if (Result == TDMS_OUT_OF_CAP)
+  {
+    Result = TDMS_WriterReserve(Writer, Size);
+    if (Result == TDMS_OK)
+      Result = TDMS_GenFirstPartSegment(Writer->File, Builder,
+                                        Writer->Buffer, Writer->BufferSize,
+                                        &Size);
+  }
+  if (Result != TDMS_OK)
+    return Result;
+
+  return TDMS_WriterSave(Writer, Size);
 }
 
+
+
 /**
- * @brief  Set data to a Channel
- * @note   To use this function, you must first create and initialize the File,
- *         Channel Group, and Channel objects with their associated functions,
- *         then generate and save the first part of TDMS file using the
- *         TDMS_GenFirstPart function, and then use this function to add data to
- *         the Channels.
- * 
- * @param  Channel: Pointer to TDMS Channel object structure
- * @param  Buffer: Pointer to the buffer that data save in
- * @note   If the buffer address is Null, then function only calculates needed
- *         buffer size and returns TDMS_OK.
+ ==================================================================================
+                      ##### Rotating Writer Functions #####
+ ==================================================================================
+ */
+
+/**
+ * @brief  Check if a File has waveform Channels
+ * @param  File: Pointer to TDMS File object structure
+ * @retval 1: has waveform Channels, 0: has not
+ */
+static uint8_t
+TDMS_FileHasWaveform(TDMS_File_t *File)
+{
+  TDMS_Group_t *Group = NULL;
+  uint32_t CounterI = 0;
+  uint32_t CounterJ = 0;
+
+  for (CounterI = 0; CounterI < File->NumOfGroups; CounterI++)
+  {
+    Group = File->GroupArray[CounterI];
+    for (CounterJ = 0; CounterJ < Group->NumOfChannels; CounterJ++)
+      if (Group->ChannelArray[CounterJ]->Waveform)
+        return 1;
+  }
+
+  return 0;
+}
+
+
+/**
+ * @brief  Save the first part of a new file of a rotating Writer into the sink
+ * @note   The first part is generated once and saved again from the cache of
+ *         Rotation. It is generated again only when a Property is added or the
+ *         File has waveform Channels (wf_start_time is moved).
  * 
- * @param  Size: Size of data in buffer (Byte)
- * @param  Values: Pointer to data values
- * @param  NumOfValues: Number of values
+ * @param  Writer: Pointer to TDMS Writer object structure
  * @retval TDMS_Result_t
  *         - TDMS_OK: Operation was successful
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
  */
-TDMS_Result_t
-TDMS_SetChannelDataValues(TDMS_Channel_t *Channel,
-                          uint8_t *Buffer,
-                          uint32_t *Size,
-                          void *Values,
-                          uint32_t NumOfValues)
+static TDMS_Result_t
+TDMS_WriterSaveFirstPart(TDMS_Writer_t *Writer)
 {
-  uint32_t DataSize = 0;
-  uint32_t RawDataLen = 0; // Bytes
-  uint32_t MetaDataLen = 0;	
-  uint16_t CounterI = 0;
-  
-  /*** ***/
-  /*** Raw Data len calculation ***/
-  /*** ***/
-  RawDataLen = dataTypeLength[Channel->ChannelDataType] * NumOfValues;
-  if (RawDataLen == 0)
-    return TDMS_WRONG_ARG;
+  TDMS_Rotation_t *Rotation = (TDMS_Rotation_t *) Writer->Rotation;
+  TDMS_Result_t Result = TDMS_OK;
+  uint8_t *FirstPart = NULL;
+  uint64_t Size = 0;
 
-  if(Channel->ChannelDataType == TDMS_DataType_Boolean)
+  if (!Rotation->FirstPartLen || TDMS_FileHasWaveform(Writer->File))
   {
-    uint8_t *ValuesBoolean = (uint8_t *) Values;
-    for(CounterI=0; CounterI<NumOfValues; CounterI++)
-      ValuesBoolean[CounterI] = (ValuesBoolean[CounterI]) ? 1:0; 
+    Result = TDMS_GenFirstPartSegment(Writer->File, Rotation->Builder,
+                                      Rotation->FirstPart,
+                                      Rotation->FirstPartSize, &Size);
+    if (Result == TDMS_OUT_OF_CAP || !Rotation->FirstPart)
+    {
+      if (Size > SIZE_MAX)
+        return TDMS_NO_MEMORY;
+      FirstPart = (uint8_t *) realloc(Rotation->FirstPart, (size_t) Size);
+      if (!FirstPart)
+        return TDMS_NO_MEMORY;
+      Rotation->FirstPart = FirstPart;
+      Rotation->FirstPartSize = Size;
+      Result = TDMS_GenFirstPartSegment(Writer->File, Rotation->Builder,
+                                        Rotation->FirstPart,
+                                        Rotation->FirstPartSize, &Size);
+    }
+    if (Result != TDMS_OK)
+      return Result;
+    Rotation->FirstPartLen = Size;
   }
-
-  
-  /*** ***/
-  /*** Meta Data len calculation ***/
-  /*** ***/
-  MetaDataLen = 0;
-  MetaDataLen += 32;
-  if(Channel->ChannelDataType == TDMS_DataType_String)
-    MetaDataLen += 8; // Total Size in bytes (only stored for variable length data types, e.g. strings)
-  MetaDataLen += strlen(Channel->ChannelPath); //Channel path
-  
-  
-  
-  /*** ***/
-  /*** if Buffer address is NULL, return back. ***/
-  /*** ***/
-  if(Buffer == NULL)
+  else
   {
-    DataSize = LeadInPartLen + MetaDataLen + RawDataLen;
-    *Size = DataSize;
-    
-    return TDMS_OK;
+    // the cached first part has no object list of raw data, so the next raw
+    // data segment must have one
+    TDMS_InvalidateLayout(Writer->File);
   }
-  
-  
-  /*** ***/
-  /*** generate lead in part ***/
-  /*** ***/
-  TDMS_GenerateLeadInPart(&Buffer[DataSize],
-                          kTocRawData | kTocNewObjList | kTocMetaData,
-                          MetaDataLen + RawDataLen,
-                          MetaDataLen);
-  DataSize += LeadInPartLen;
 
-  /*** ***/
-  /*** generate meta data ***/
-  /*** ***/
-  DataSize += TDMS_SaveDataLittleEndian32(&Buffer[DataSize],
-                                          1); // Number of objects = 1 -> the object is the Channel
-
-  DataSize += TDMS_SaveStrToMetaDataPart(&Buffer[DataSize],
-                                         Channel->ChannelPath); // Channel path
-
-  DataSize += TDMS_SaveDataLittleEndian32(&Buffer[DataSize],
-                                          0x14); // Length of index information
-  DataSize += TDMS_SaveDataLittleEndian32(&Buffer[DataSize],
-                                          dataTypeBinary[Channel->ChannelDataType]); // Data type of the raw data assigned to this object
-  DataSize += TDMS_SaveDataLittleEndian32(&Buffer[DataSize],
-                                          0x01); // Dimension of the raw data array (must be 1)
-  DataSize += TDMS_SaveDataLittleEndian64(&Buffer[DataSize],
-                                          NumOfValues); // Number of raw data Values
-  if (Channel->ChannelDataType == TDMS_DataType_String)
-    DataSize += TDMS_SaveDataLittleEndian64(&Buffer[DataSize],
-                                            strlen(Values)); // Total Size in bytes
-
-  DataSize += TDMS_SaveDataLittleEndian32(&Buffer[DataSize],
-                                          0); // Number of properties
+  Result = Writer->Sink.Write(Writer->Sink.Context,
+                              Rotation->FirstPart, Rotation->FirstPartLen);
+  if (Result != TDMS_OK)
+    return Result;
 
-  /*** ***/
-  /*** write RAW data ***/
-  /*** ***/
-  memcpy(&Buffer[DataSize], Values, RawDataLen);
-  DataSize += RawDataLen;
-  
-  *Size = DataSize;
-  
-  return TDMS_OK;
+  Writer->Offset += Rotation->FirstPartLen;
+  Rotation->NumOfFiles++;
+  if (Rotation->GetTime)
+    Rotation->FileStartTime = Rotation->GetTime();
+
+  return TDMS_WriterSaveIndex(Writer, Rotation->FirstPart);
 }
 
 
 /**
- * @brief  Set data to Channels of a Group
- * @note   To use this function, you must first create and initialize the File,
- *         Channel Group, and Channel objects with their associated functions,
- *         then generate and save the first part of TDMS file using the
- *         TDMS_GenFirstPart function, and then use this function to add data to
- *         the Channels of a Groupe.
+ * @brief  Initialize a Writer that saves data into a sequence of files and
+ *         starts a new file by size or duration
+ * @note   The first part of the files (with the Properties of the Builder of
+ *         Rotation) is generated once, saved into the first file and saved
+ *         again at the start of each new file. Files are switched after a
+ *         segment is saved, so no value is lost or saved twice, and the first
+ *         raw data segment of each file has a new object list.
+ * @note   wf_start_time of waveform Channels in next files is moved by the
+ *         number of values that are saved before.
  * 
- * @param  Group: Pointer to TDMS Group object structure
- * @param  Buffer: Pointer to the buffer that data save in
- * @note   If the buffer address is Null, then function only calculates needed
- *         buffer size and returns TDMS_OK.
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  File: Pointer to TDMS File object structure (Groups and Channels must
+ *               be added before)
  * 
- * @param  Size: Size of data in buffer (Byte)
- * @param  ...: Pointer to Channels data values, Number of values.
- * @note   This is a example of calling this function for a Group with 2
- *         Channels:
- *         uint8_t Ch1Values[3] = {0,1,2}; // Ch1 data type is tdsTypeU8
- *         float Ch2Values[2] = {10.0,11.1}; // Ch1 data type is tdsTypeSingleFloat
- *         TDMS_SetGroupDataValues(&Group, Buffer, &Size,
- *                                 Ch1Values, 3, Ch2Values , 2);
+ * @param  Rotation: Pointer to TDMS Rotation structure (MaxSize, MaxDuration,
+ *                   GetTime, NextFile, Context and Builder must be set). It
+ *                   must be valid until TDMS_DeInitWriter is called. If
+ *                   GetTime is Null, the monotonic clock is used (POSIX).
  * 
  * @retval TDMS_Result_t
  *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - Others: Error of NextFile or sink
  */
 TDMS_Result_t
-TDMS_SetGroupDataValues(TDMS_Group_t *Group,
-                        uint8_t *Buffer,
-                        uint32_t *Size,
-                        ...
-                        )
+TDMS_InitRotatingWriter(TDMS_Writer_t *Writer, TDMS_File_t *File,
+                        TDMS_Rotation_t *Rotation)
 {
-  uint32_t DataSize = 0;
-  uint32_t RawDataLenCh[TDMS_CONFIG_MAX_CHANNEL_OF_GROUP] = {0}; // Raw Data for each channel
-  uint32_t RawDataLen = 0; // Bytes
-  uint32_t MetaDataLen = 0;
-  uint32_t NumberOfObjects = 0;
-  uint16_t CounterI = 0;
+  TDMS_Result_t Result = TDMS_OK;
+  TDMS_Sink_t Sink = {0};
+  TDMS_Sink_t IndexSink = {0};
 
-  void* Values[TDMS_CONFIG_MAX_CHANNEL_OF_GROUP];
-  uint32_t NumOfValues[TDMS_CONFIG_MAX_CHANNEL_OF_GROUP];
-  
-  va_list valist;
+  if (!Rotation || !Rotation->NextFile ||
+      (Rotation->Builder && Rotation->Builder->File != File))
+    return TDMS_WRONG_ARG;
 
-  /* initialize valist for num number of arguments */
-  va_start(valist, Size);
+#if (TDMS_CONFIG_POSIX == 1)
+  if (!Rotation->GetTime)
+    Rotation->GetTime = TDMS_CoalescerClock;
+#endif
+  if (Rotation->MaxDuration && !Rotation->GetTime)
+    return TDMS_WRONG_ARG;
 
-  for(CounterI=0; CounterI<(Group->NumOfChannels); CounterI++)
-  {
-    Values[CounterI] = va_arg(valist, void*);
-    NumOfValues[CounterI] = va_arg(valist, uint32_t);
-    if(NumOfValues[CounterI])
-      NumberOfObjects++;
-  }
+  Rotation->FirstPart = NULL;
+  Rotation->FirstPartLen = 0;
+  Rotation->FirstPartSize = 0;
+  Rotation->FileStartTime = 0;
+  Rotation->NumOfFiles = 0;
 
-  /* clean memory reserved for valist */
-  va_end(valist);
+  Result = Rotation->NextFile(Rotation->Context, &Sink, &IndexSink);
+  if (Result != TDMS_OK)
+    return Result;
 
-  
-  if(!NumberOfObjects)
-  {
-    *Size = 0;
-    return TDMS_OK;
-  }
-  
-  
-  /*** ***/
-  /*** Raw Data & Meta Data len calculation ***/
-  /*** ***/
-  RawDataLen = 0;
-  MetaDataLen = 4; // Number of objects 
-  for(CounterI=0; CounterI<(Group->NumOfChannels); CounterI++)
-  {
-    if(NumOfValues[CounterI])
-    {
-      // Raw Data for each channel
-      RawDataLenCh[CounterI] = dataTypeLength[Group->ChannelArray[CounterI]->ChannelDataType] * NumOfValues[CounterI];
-      if (RawDataLenCh[CounterI] == 0)
-        return TDMS_WRONG_ARG;
-      
-      // Meta Data
-      MetaDataLen += 28;
-      if(Group->ChannelArray[CounterI]->ChannelDataType == TDMS_DataType_String)
-        MetaDataLen += 4; // Total Size in bytes (only stored for variable length data types, e.g. strings)
-      MetaDataLen += strlen(Group->ChannelArray[CounterI]->ChannelPath); //Channel path
-    }
-    else
-    {
-      RawDataLenCh[CounterI] = 0;
-    }
-    
-    RawDataLen += RawDataLenCh[CounterI];
-  } //for(CounterI=0; CounterI<noc; CounterI++)
-  
-  
-  /*** ***/
-  /*** if Buffer address is NULL, return back. ***/
-  /*** ***/
-  if(Buffer == NULL)
-  {
-    *Size = LeadInPartLen + MetaDataLen + RawDataLen;
-    
-    return TDMS_OK;
-  }
-  
-  DataSize = 0;
-  
-  
-  /*** ***/
-  /*** generate lead in part ***/
-  /*** ***/
-  TDMS_GenerateLeadInPart(&Buffer[DataSize],
-                          kTocRawData | kTocNewObjList | kTocMetaData,
-                          MetaDataLen + RawDataLen,
-                          MetaDataLen);
-  DataSize += LeadInPartLen;
+  Result = TDMS_InitWriter(Writer, File, &Sink);
+  if (Result != TDMS_OK)
+    return Result;
 
-  /*** ***/
-  /*** generate meta data ***/
-  /*** ***/
-  DataSize += TDMS_SaveDataLittleEndian32(&Buffer[DataSize],
-                                          NumberOfObjects); // Number of objects
-  for (CounterI = 0; CounterI < (Group->NumOfChannels); CounterI++)
-  {
-    if (NumOfValues[CounterI])
-    {
-      DataSize += TDMS_SaveStrToMetaDataPart(&Buffer[DataSize],
-                                             Group->ChannelArray[CounterI]->ChannelPath); // Channel path
-
-      DataSize += TDMS_SaveDataLittleEndian32(&Buffer[DataSize],
-                                              0x14); // Length of index information
-      DataSize += TDMS_SaveDataLittleEndian32(&Buffer[DataSize],
-                                              dataTypeBinary[Group->ChannelArray[CounterI]->ChannelDataType]); // Data type of the raw data assigned to this object
-      DataSize += TDMS_SaveDataLittleEndian32(&Buffer[DataSize],
-                                              0x01); // Dimension of the raw data array (must be 1)
-      DataSize += TDMS_SaveDataLittleEndian64(&Buffer[DataSize],
-                                              NumOfValues[CounterI]); // Number of raw data Values
-      if (Group->ChannelArray[CounterI]->ChannelDataType == TDMS_DataType_String)
-        DataSize += TDMS_SaveDataLittleEndian64(&Buffer[DataSize],
-                                                strlen((const char *)*(Values + CounterI))); // Total Size in bytes
-
-      DataSize += TDMS_SaveDataLittleEndian32(&Buffer[DataSize],
-                                              0); // Number of properties
-    }
-  }
+  TDMS_WriterSetIndexSink(Writer, IndexSink.Write ? &IndexSink : NULL);
+  Writer->Rotation = (void *) Rotation;
 
-  /*** ***/
-  /*** generate RAW data ***/
-  /*** ***/
-  for(CounterI=0; CounterI<(Group->NumOfChannels); CounterI++)
-  {
-    if(NumOfValues[CounterI])
-    {
-      memcpy(&Buffer[DataSize],
-             Values[CounterI],
-             RawDataLenCh[CounterI]);
-      DataSize += RawDataLenCh[CounterI];
-    }
-  }
-  
-  *Size = DataSize;
-  
-  return TDMS_OK;
+  return TDMS_WriterSaveFirstPart(Writer);
 }
 
 
 /**
- * @brief  Calculate second part of TDMS Timestamp from normal time and date
- * @param  Year: Normal Year (1904 to ...)
- * @param  Month: Normal Month (1 to 12)
- * @param  Day: Normal Day (1 to 31)
- * @param  Hour: Normal Hour (0 to 23)
- * @param  Minute: Normal Minute (0 to 59)
- * @param  Second: Normal Second (0 to 59)
- * @retval Second part of TDMS Timestamp
+ * @brief  Start a new file of a rotating Writer now
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Writer is not a rotating Writer
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - Others: Error of NextFile or sink
  */
-int64_t
-TDMS_TimeSecond(uint16_t Year, uint8_t Month, uint8_t Day,
-                uint8_t Hour, uint8_t Minute, uint8_t Second)
+TDMS_Result_t
+TDMS_WriterRotate(TDMS_Writer_t *Writer)
 {
-  uint32_t DiffDay;
-  int64_t DiffSecond;
+  TDMS_Rotation_t *Rotation = (TDMS_Rotation_t *) Writer->Rotation;
+  TDMS_Result_t Result = TDMS_OK;
+  TDMS_Sink_t Sink = {0};
+  TDMS_Sink_t IndexSink = {0};
 
-  DiffDay = TDMS_DateDef(Day, Month, Year);
-  DiffSecond  = (int64_t) (DiffDay * 86400ul);
-  DiffSecond += (int64_t) (Hour * 3600); 
-  DiffSecond += (int64_t) (Minute * 60);
-  DiffSecond += (int64_t) (Second);
+  if (!Rotation)
+    return TDMS_WRONG_ARG;
 
-  return DiffSecond;
+  Result = Rotation->NextFile(Rotation->Context, &Sink, &IndexSink);
+  if (Result != TDMS_OK)
+    return Result;
+
+  Writer->Sink = Sink;
+  TDMS_WriterSetIndexSink(Writer, IndexSink.Write ? &IndexSink : NULL);
+  Writer->Offset = 0;
+
+  return TDMS_WriterSaveFirstPart(Writer);
 }
@@ -0,0 +1,932 @@
+/**
+ **********************************************************************************
+ * @file   TDMS_Async.c
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  Asynchronous TDMS Writer for POSIX systems
+ * @note   Data values are copied into a lock-free single producer, single
+ *         consumer ring and a background thread generates the segments and
+ *         saves them by a TDMS Writer, so disk stalls do not block the thread
+ *         that produces the data.
+ **********************************************************************************
+ */
+
+/* Includes ---------------------------------------------------------------------*/
+// posix_memalign is not in ISO C
+#if !defined(_POSIX_C_SOURCE) && !defined(_GNU_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+#include "TDMS_Async.h"
+
+#if (TDMS_CONFIG_POSIX == 1)
+#include "TDMS_Private.h"
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <errno.h>
+
+
+/* Private Constants ------------------------------------------------------------*/
+/**
+ * @brief  Kinds of the records of the ring
+ */
+#define AsyncRecordPadding    0
+#define AsyncRecordChannel    1
+#define AsyncRecordGroup      2
+
+/**
+ * @brief  Min size of the ring (Byte)
+ */
+#define AsyncMinRingSize      4096
+
+/**
+ * @brief  Size of cache lines (the producer and consumer indexes are kept in
+ *         separate lines)
+ */
+#define AsyncCacheLineSize    64
+
+
+/* Private Macro ----------------------------------------------------------------*/
+/**
+ * @brief  Round up a size to multiple of 8 Bytes
+ */
+#define AsyncAlign(Len)   (((Len) + 7) & ~((uint64_t) 7))
+
+
+/* Private Data Types -----------------------------------------------------------*/
+/**
+ * @brief  Header of each record of the ring
+ * @note   A Channel record is followed by the values. A Group record is
+ *         followed by the number of values of each Channel (uint64_t) and the
+ *         values of each Channel (aligned to 8 Bytes).
+ */
+typedef struct
+{
+  // Size of the record with header and padding (Byte)
+  uint64_t Len;
+  // Channel or Group of the record
+  void *Object;
+  // Channel: number of values, Group: number of Channels
+  uint64_t NumOfValues;
+  uint32_t Kind;
+  uint32_t Reserved;
+} TDMS_AsyncRecord_t;
+
+/**
+ * @brief  Ring of a producer thread
+ */
+typedef struct
+{
+  // Written by the producer
+  _Alignas(AsyncCacheLineSize) _Atomic uint64_t Head;
+  // Written by the consumer. Records between Tail and Read are in the
+  // segment that is being generated.
+  _Alignas(AsyncCacheLineSize) _Atomic uint64_t Tail;
+  uint64_t Read;
+
+  _Alignas(AsyncCacheLineSize) _Atomic uint32_t ProducerWaiting;
+  uint8_t *Ring;
+  uint64_t Mask;
+  sem_t Space;
+} TDMS_AsyncLane_t;
+
+/**
+ * @brief  Lanes and state of the background thread
+ */
+typedef struct
+{
+  _Alignas(AsyncCacheLineSize) _Atomic uint32_t ConsumerWaiting;
+  _Atomic uint32_t Closing;
+  _Atomic int32_t Result;
+  _Atomic uint64_t Dropped;
+  sem_t Items;
+  pthread_t Thread;
+
+  TDMS_AsyncLane_t *Lanes;
+  uint32_t NumOfLanes;
+
+  // Channels of the segment that is being generated (used by the background
+  // thread)
+  TDMS_Channel_t **Channels;
+  uint32_t NumOfChannels;
+  uint32_t ChannelsSize;
+} TDMS_AsyncState_t;
+
+
+
+/**
+ ==================================================================================
+                           ##### Private Functions #####
+ ==================================================================================
+ */
+
+/**
+ * @brief  Wait on a semaphore (restart if it is interrupted)
+ * @param  Sem: Pointer to the semaphore
+ * @retval None
+ */
+static void
+TDMS_AsyncWait(sem_t *Sem)
+{
+  while (sem_wait(Sem) != 0 && errno == EINTR)
+    ;
+}
+
+
+/**
+ * @brief  Wake the other thread, if it waits
+ * @param  Waiting: Pointer to waiting flag of the other thread
+ * @param  Sem: Pointer to semaphore of the other thread
+ * @retval None
+ */
+static void
+TDMS_AsyncWake(_Atomic uint32_t *Waiting, sem_t *Sem)
+{
+  // the flag is only written when it is set, so the producers do not share a
+  // modified cache line on each record
+  if (atomic_load(Waiting) && atomic_exchange(Waiting, 0))
+    sem_post(Sem);
+}
+
+
+/**
+ * @brief  Release ring and semaphore of the lanes
+ * @param  State: Pointer to state of the background thread
+ * @param  NumOfLanes: Number of initialized lanes
+ * @retval None
+ */
+static void
+TDMS_AsyncFreeLanes(TDMS_AsyncState_t *State, uint32_t NumOfLanes)
+{
+  uint32_t CounterI = 0;
+
+  for (CounterI = 0; CounterI < NumOfLanes; CounterI++)
+  {
+    sem_destroy(&State->Lanes[CounterI].Space);
+    free(State->Lanes[CounterI].Ring);
+  }
+  free(State->Lanes);
+  free(State->Channels);
+}
+
+
+/**
+ * @brief  Check if a lane has records that are not read by the background
+ *         thread
+ * @param  State: Pointer to state of the background thread
+ * @retval 1 if any lane has records, 0 otherwise
+ */
+static uint8_t
+TDMS_AsyncPending(TDMS_AsyncState_t *State)
+{
+  uint32_t CounterI = 0;
+
+  for (CounterI = 0; CounterI < State->NumOfLanes; CounterI++)
+  {
+    if (State->Lanes[CounterI].Read != atomic_load(&State->Lanes[CounterI].Head))
+      return 1;
+  }
+
+  return 0;
+}
+
+
+/**
+ * @brief  Generate a segment from Channels of the read records and release
+ *         the records
+ * @note   The first error is kept and the next segments are not generated, but
+ *         the records are still released, so the producers never wait forever.
+ *
+ * @param  Async: Pointer to TDMS Asynchronous Writer object structure
+ * @retval None
+ */
+static void
+TDMS_AsyncFlush(TDMS_AsyncWriter_t *Async)
+{
+  TDMS_AsyncState_t *State = (TDMS_AsyncState_t *) Async->State;
+  TDMS_AsyncLane_t *Lane = NULL;
+  TDMS_Result_t Result = TDMS_OK;
+  uint32_t CounterI = 0;
+
+  if (State->NumOfChannels)
+  {
+    if (atomic_load_explicit(&State->Result, memory_order_relaxed) == TDMS_OK)
+    {
+      Result = TDMS_WriterGenDataSegment(Async->Writer,
+                                         State->Channels, State->NumOfChannels,
+                                         0, NULL);
+      if (Result != TDMS_OK)
+        atomic_store(&State->Result, Result);
+    }
+
+    // ChunkValues marks the Channels of the segment
+    for (CounterI = 0; CounterI < State->NumOfChannels; CounterI++)
+    {
+      State->Channels[CounterI]->ChunkValues = NULL;
+      State->Channels[CounterI]->ChunkNumOfValues = 0;
+    }
+    State->NumOfChannels = 0;
+  }
+
+  for (CounterI = 0; CounterI < State->NumOfLanes; CounterI++)
+  {
+    Lane = &State->Lanes[CounterI];
+    if (atomic_load_explicit(&Lane->Tail, memory_order_relaxed) == Lane->Read)
+      continue;
+    atomic_store(&Lane->Tail, Lane->Read);
+    TDMS_AsyncWake(&Lane->ProducerWaiting, &Lane->Space);
+  }
+}
+
+
+/**
+ * @brief  Add Channels of a record to the segment that is being generated
+ * @note   If a Channel is already in the segment, the segment is generated
+ *         first, so values of each Channel keep their order. Channels of a
+ *         Group record that have no values are not added.
+ *
+ * @param  Async: Pointer to TDMS Asynchronous Writer object structure
+ * @param  Record: Pointer to the record
+ * @retval None
+ */
+static void
+TDMS_AsyncAdd(TDMS_AsyncWriter_t *Async, TDMS_AsyncRecord_t *Record)
+{
+  TDMS_AsyncState_t *State = (TDMS_AsyncState_t *) Async->State;
+  TDMS_Channel_t **Channels = NULL;
+  TDMS_Channel_t *Channel = NULL;
+  TDMS_Group_t *Group = NULL;
+  uint64_t *NumOfValues = NULL;
+  uint8_t *Values = NULL;
+  uint32_t NumOfChannels = 1;
+  uint32_t ChannelsSize = 0;
+  uint32_t CounterI = 0;
+
+  if (Record->Kind == AsyncRecordGroup)
+  {
+    Group = (TDMS_Group_t *) Record->Object;
+    NumOfChannels = Group->NumOfChannels;
+    NumOfValues = (uint64_t *) (Record + 1);
+    for (CounterI = 0; CounterI < NumOfChannels; CounterI++)
+    {
+      if (NumOfValues[CounterI] && Group->ChannelArray[CounterI]->ChunkValues)
+        break;
+    }
+    if (CounterI < NumOfChannels)
+      TDMS_AsyncFlush(Async);
+  }
+  else if (((TDMS_Channel_t *) Record->Object)->ChunkValues)
+  {
+    TDMS_AsyncFlush(Async);
+  }
+
+  if (State->NumOfChannels + NumOfChannels > State->ChannelsSize)
+  {
+    ChannelsSize = State->ChannelsSize ? State->ChannelsSize : 8;
+    while (ChannelsSize < State->NumOfChannels + NumOfChannels)
+      ChannelsSize <<= 1;
+    Channels = (TDMS_Channel_t **) realloc(State->Channels,
+                                           ChannelsSize * sizeof(TDMS_Channel_t *));
+    if (!Channels)
+    {
+      atomic_store(&State->Result, TDMS_NO_MEMORY);
+      return;
+    }
+    State->Channels = Channels;
+    State->ChannelsSize = ChannelsSize;
+  }
+
+  if (Record->Kind == AsyncRecordChannel)
+  {
+    Channel = (TDMS_Channel_t *) Record->Object;
+    Channel->ChunkValues = (uint8_t *) (Record + 1);
+    Channel->ChunkNumOfValues = Record->NumOfValues;
+    State->Channels[State->NumOfChannels++] = Channel;
+    return;
+  }
+
+  Values = (uint8_t *) (NumOfValues + Record->NumOfValues);
+  for (CounterI = 0; CounterI < NumOfChannels; CounterI++)
+  {
+    // a Channel without values is not in the segment (its values can be in
+    // the next records)
+    if (!NumOfValues[CounterI])
+      continue;
+    Channel = Group->ChannelArray[CounterI];
+    Channel->ChunkValues = Values;
+    Channel->ChunkNumOfValues = NumOfValues[CounterI];
+    State->Channels[State->NumOfChannels++] = Channel;
+    Values += AsyncAlign(dataTypeLength[Channel->ChannelDataType] *
+                         NumOfValues[CounterI]);
+  }
+}
+
+
+/**
+ * @brief  Background thread that saves the records of the lanes
+ * @note   All of the records that are in the lanes are merged into one segment
+ *         (a Channel that is in more than one record starts a new segment).
+ *
+ * @param  Arg: Pointer to TDMS Asynchronous Writer object structure
+ * @retval Null
+ */
+static void *
+TDMS_AsyncThread(void *Arg)
+{
+  TDMS_AsyncWriter_t *Async = (TDMS_AsyncWriter_t *) Arg;
+  TDMS_AsyncState_t *State = (TDMS_AsyncState_t *) Async->State;
+  TDMS_AsyncLane_t *Lane = NULL;
+  TDMS_AsyncRecord_t *Record = NULL;
+  uint64_t Head = 0;
+  uint64_t Pos = 0;
+  uint8_t Progress = 0;
+  uint32_t CounterI = 0;
+
+  for (;;)
+  {
+    Progress = 0;
+    for (CounterI = 0; CounterI < State->NumOfLanes; CounterI++)
+    {
+      Lane = &State->Lanes[CounterI];
+      Head = atomic_load_explicit(&Lane->Head, memory_order_acquire);
+      while (Lane->Read != Head)
+      {
+        Progress = 1;
+        Pos = Lane->Read & Lane->Mask;
+        if (Lane->Mask + 1 - Pos < sizeof(TDMS_AsyncRecord_t))
+        {
+          // end of the ring is smaller than a record header
+          Lane->Read += Lane->Mask + 1 - Pos;
+          continue;
+        }
+
+        Record = (TDMS_AsyncRecord_t *) &Lane->Ring[Pos];
+        if (Record->Kind != AsyncRecordPadding)
+          TDMS_AsyncAdd(Async, Record);
+        Lane->Read += Record->Len;
+      }
+    }
+
+    if (Progress)
+    {
+      TDMS_AsyncFlush(Async);
+      continue;
+    }
+
+    // the lanes are empty: the thread ends after they are closed, and the
+    // lanes are checked once more, since records may be added before closing
+    if (atomic_load(&State->Closing))
+    {
+      if (TDMS_AsyncPending(State))
+        continue;
+      break;
+    }
+
+    atomic_store(&State->ConsumerWaiting, 1);
+    if (TDMS_AsyncPending(State) || atomic_load(&State->Closing))
+    {
+      atomic_store(&State->ConsumerWaiting, 0);
+      continue;
+    }
+    TDMS_AsyncWait(&State->Items);
+  }
+
+  return NULL;
+}
+
+
+/**
+ * @brief  Reserve a record in a lane
+ * @param  Async: Pointer to TDMS Asynchronous Writer object structure
+ * @param  Lane: Pointer to the lane
+ * @param  Len: Size of the record with header (Byte, multiple of 8)
+ * @param  Head: Pointer to save position of the end of the record (passed to
+ *               TDMS_AsyncCommit)
+ *
+ * @retval Pointer to the record or Null if it is dropped
+ */
+static TDMS_AsyncRecord_t *
+TDMS_AsyncReserve(TDMS_AsyncWriter_t *Async, TDMS_AsyncLane_t *Lane,
+                  uint64_t Len, uint64_t *Head)
+{
+  TDMS_AsyncRecord_t *Padding = NULL;
+  uint64_t Size = Lane->Mask + 1;
+  uint64_t Start = atomic_load_explicit(&Lane->Head, memory_order_relaxed);
+  uint64_t Tail = 0;
+  uint64_t Skip = 0;
+
+  // records do not wrap around the end of the ring
+  if (Size - (Start & Lane->Mask) < Len)
+    Skip = Size - (Start & Lane->Mask);
+  if (Len + Skip > Size)
+    return NULL;
+
+  for (;;)
+  {
+    Tail = atomic_load_explicit(&Lane->Tail, memory_order_acquire);
+    if (Size - (Start - Tail) >= Len + Skip)
+      break;
+
+    if (Async->Policy == TDMS_AsyncPolicy_Drop)
+      return NULL;
+
+    atomic_store(&Lane->ProducerWaiting, 1);
+    if (atomic_load(&Lane->Tail) != Tail)
+    {
+      atomic_store(&Lane->ProducerWaiting, 0);
+      continue;
+    }
+    TDMS_AsyncWait(&Lane->Space);
+  }
+
+  if (Skip >= sizeof(TDMS_AsyncRecord_t))
+  {
+    Padding = (TDMS_AsyncRecord_t *) &Lane->Ring[Start & Lane->Mask];
+    Padding->Len = Skip;
+    Padding->Kind = AsyncRecordPadding;
+  }
+
+  *Head = Start + Skip + Len;
+
+  return (TDMS_AsyncRecord_t *) &Lane->Ring[(Start + Skip) & Lane->Mask];
+}
+
+
+/**
+ * @brief  Pass a reserved record to the background thread
+ * @param  Async: Pointer to TDMS Asynchronous Writer object structure
+ * @param  Lane: Pointer to the lane
+ * @param  Head: Position of the end of the record
+ * @retval None
+ */
+static void
+TDMS_AsyncCommit(TDMS_AsyncWriter_t *Async, TDMS_AsyncLane_t *Lane,
+                 uint64_t Head)
+{
+  TDMS_AsyncState_t *State = (TDMS_AsyncState_t *) Async->State;
+
+  atomic_store(&Lane->Head, Head);
+  TDMS_AsyncWake(&State->ConsumerWaiting, &State->Items);
+}
+
+
+/**
+ * @brief  Copy values of a Channel into a lane
+ * @param  Async: Pointer to TDMS Asynchronous Writer object structure
+ * @param  Lane: Index of the lane
+ * @param  Channel: Pointer to TDMS Channel object structure
+ * @param  Values: Pointer to data values
+ * @param  NumOfValues: Number of values
+ * @retval TDMS_Result_t
+ */
+static TDMS_Result_t
+TDMS_AsyncPushChannel(TDMS_AsyncWriter_t *Async, uint32_t Lane,
+                      TDMS_Channel_t *Channel,
+                      const void *Values, uint64_t NumOfValues)
+{
+  TDMS_AsyncState_t *State = (TDMS_AsyncState_t *) Async->State;
+  TDMS_AsyncRecord_t *Record = NULL;
+  TDMS_Result_t Result = TDMS_OK;
+  uint64_t Len = dataTypeLength[Channel->ChannelDataType] * NumOfValues;
+  uint64_t Head = 0;
+
+  if (Len == 0 || Lane >= State->NumOfLanes)
+    return TDMS_WRONG_ARG;
+
+  Result = (TDMS_Result_t) atomic_load_explicit(&State->Result,
+                                                memory_order_relaxed);
+  if (Result != TDMS_OK)
+    return Result;
+
+  Record = TDMS_AsyncReserve(Async, &State->Lanes[Lane],
+                             sizeof(TDMS_AsyncRecord_t) + AsyncAlign(Len),
+                             &Head);
+  if (!Record)
+  {
+    atomic_fetch_add_explicit(&State->Dropped, NumOfValues,
+                              memory_order_relaxed);
+    return TDMS_OUT_OF_CAP;
+  }
+
+  Record->Len = sizeof(TDMS_AsyncRecord_t) + AsyncAlign(Len);
+  Record->Object = Channel;
+  Record->NumOfValues = NumOfValues;
+  Record->Kind = AsyncRecordChannel;
+  memcpy(Record + 1, Values, (size_t) Len);
+
+  TDMS_AsyncCommit(Async, &State->Lanes[Lane], Head);
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Copy values of Channels of a Group into a lane
+ * @param  Async: Pointer to TDMS Asynchronous Writer object structure
+ * @param  Lane: Index of the lane
+ * @param  Group: Pointer to TDMS Group object structure
+ * @param  Args: Pointer to Channels data values, Number of values (uint64_t)
+ * @retval TDMS_Result_t
+ */
+static TDMS_Result_t
+TDMS_AsyncPushGroup(TDMS_AsyncWriter_t *Async, uint32_t Lane,
+                    TDMS_Group_t *Group, va_list Args)
+{
+  TDMS_AsyncState_t *State = (TDMS_AsyncState_t *) Async->State;
+  TDMS_AsyncRecord_t *Record = NULL;
+  TDMS_Result_t Result = TDMS_OK;
+  TDMS_Channel_t *Channel = NULL;
+  uint64_t *NumOfValues = NULL;
+  uint8_t *Values = NULL;
+  const void *ChannelValues = NULL;
+  uint64_t ChannelNumOfValues = 0;
+  uint64_t TotalNumOfValues = 0;
+  uint64_t Len = 0;
+  uint64_t Head = 0;
+  uint16_t CounterI = 0;
+  va_list valist;
+
+  if (Lane >= State->NumOfLanes)
+    return TDMS_WRONG_ARG;
+
+  Result = (TDMS_Result_t) atomic_load_explicit(&State->Result,
+                                                memory_order_relaxed);
+  if (Result != TDMS_OK)
+    return Result;
+
+  /* size of the record */
+  va_copy(valist, Args);
+  Len = sizeof(TDMS_AsyncRecord_t) + Group->NumOfChannels * sizeof(uint64_t);
+  for(CounterI=0; CounterI<(Group->NumOfChannels); CounterI++)
+  {
+    Channel = Group->ChannelArray[CounterI];
+    (void) va_arg(valist, const void*);
+    ChannelNumOfValues = va_arg(valist, uint64_t);
+    // string Channels can not be saved with other Channels of the Group
+    if (dataTypeLength[Channel->ChannelDataType] == 0 && ChannelNumOfValues)
+    {
+      va_end(valist);
+      return TDMS_WRONG_ARG;
+    }
+    Len += AsyncAlign(dataTypeLength[Channel->ChannelDataType] *
+                      ChannelNumOfValues);
+    TotalNumOfValues += ChannelNumOfValues;
+  }
+  va_end(valist);
+
+  Record = TDMS_AsyncReserve(Async, &State->Lanes[Lane], Len, &Head);
+  if (!Record)
+  {
+    atomic_fetch_add_explicit(&State->Dropped, TotalNumOfValues,
+                              memory_order_relaxed);
+    return TDMS_OUT_OF_CAP;
+  }
+
+  Record->Len = Len;
+  Record->Object = Group;
+  Record->NumOfValues = Group->NumOfChannels;
+  Record->Kind = AsyncRecordGroup;
+  NumOfValues = (uint64_t *) (Record + 1);
+  Values = (uint8_t *) (NumOfValues + Group->NumOfChannels);
+
+  /* copy the values */
+  for(CounterI=0; CounterI<(Group->NumOfChannels); CounterI++)
+  {
+    Channel = Group->ChannelArray[CounterI];
+    ChannelValues = va_arg(Args, const void*);
+    ChannelNumOfValues = va_arg(Args, uint64_t);
+    Len = dataTypeLength[Channel->ChannelDataType] * ChannelNumOfValues;
+
+    NumOfValues[CounterI] = ChannelNumOfValues;
+    if (Len)
+      memcpy(Values, ChannelValues, (size_t) Len);
+    Values += AsyncAlign(Len);
+  }
+
+  TDMS_AsyncCommit(Async, &State->Lanes[Lane], Head);
+
+  return TDMS_OK;
+}
+
+
+
+/**
+ ==================================================================================
+                            ##### Public Functions #####
+ ==================================================================================
+ */
+
+/**
+ * @brief  Initialize Asynchronous Writer object structure with one lane and
+ *         start its background thread
+ * @note   Only one thread can set data values to this Asynchronous Writer, and
+ *         the Writer must not be used by other functions until
+ *         TDMS_DeInitAsyncWriter is called (e.g. first part of the file and
+ *         properties must be saved before).
+ *
+ * @param  Async: Pointer to TDMS Asynchronous Writer object structure
+ * @param  Writer: Pointer to initialized TDMS Writer object structure
+ * @param  RingSize: Size of the ring (Byte). It is rounded up to a power of 2
+ *                   and limits the memory of the data values that are not
+ *                   saved yet.
+ *
+ * @param  Policy: What happens when the ring is full
+ *         - TDMS_AsyncPolicy_Block: Wait for space
+ *         - TDMS_AsyncPolicy_Drop: Drop the values
+ *
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Starting the thread failed
+ */
+TDMS_Result_t
+TDMS_InitAsyncWriter(TDMS_AsyncWriter_t *Async, TDMS_Writer_t *Writer,
+                     uint64_t RingSize, TDMS_AsyncPolicy_t Policy)
+{
+  return TDMS_InitAsyncWriterLanes(Async, Writer, 1, RingSize, Policy);
+}
+
+
+/**
+ * @brief  Initialize Asynchronous Writer object structure with a lane for each
+ *         producer thread and start its background thread
+ * @note   Each lane must be used by only one thread at a time, and a Channel
+ *         should be set by only one lane (values of a Channel that is set by
+ *         more than one lane are saved in the order that the background thread
+ *         reads them). The Writer must not be used by other functions until
+ *         TDMS_DeInitAsyncWriter is called.
+ *
+ * @param  Async: Pointer to TDMS Asynchronous Writer object structure
+ * @param  Writer: Pointer to initialized TDMS Writer object structure
+ * @param  NumOfLanes: Number of lanes (producer threads)
+ * @param  RingSize: Size of the ring of each lane (Byte). It is rounded up to a
+ *                   power of 2.
+ *
+ * @param  Policy: What happens when the ring of a lane is full
+ *         - TDMS_AsyncPolicy_Block: Wait for space
+ *         - TDMS_AsyncPolicy_Drop: Drop the values
+ *
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Starting the thread failed
+ */
+TDMS_Result_t
+TDMS_InitAsyncWriterLanes(TDMS_AsyncWriter_t *Async, TDMS_Writer_t *Writer,
+                          uint32_t NumOfLanes, uint64_t RingSize,
+                          TDMS_AsyncPolicy_t Policy)
+{
+  TDMS_AsyncState_t *State = NULL;
+  TDMS_AsyncLane_t *Lane = NULL;
+  TDMS_Group_t *Group = NULL;
+  uint64_t Size = AsyncMinRingSize;
+  uint32_t CounterI = 0;
+  uint32_t CounterJ = 0;
+
+  if (!Writer || !NumOfLanes || RingSize > ((uint64_t) SIZE_MAX >> 1))
+    return TDMS_WRONG_ARG;
+
+  while (Size < RingSize)
+    Size <<= 1;
+
+  if (posix_memalign((void **) &State, AsyncCacheLineSize,
+                     sizeof(TDMS_AsyncState_t)) != 0)
+    return TDMS_NO_MEMORY;
+  memset(State, 0, sizeof(TDMS_AsyncState_t));
+
+  if (posix_memalign((void **) &State->Lanes, AsyncCacheLineSize,
+                     NumOfLanes * sizeof(TDMS_AsyncLane_t)) != 0)
+  {
+    free(State);
+    return TDMS_NO_MEMORY;
+  }
+  memset(State->Lanes, 0, NumOfLanes * sizeof(TDMS_AsyncLane_t));
+
+  for (CounterI = 0; CounterI < NumOfLanes; CounterI++)
+  {
+    Lane = &State->Lanes[CounterI];
+    Lane->Ring = (uint8_t *) malloc((size_t) Size);
+    if (!Lane->Ring)
+    {
+      TDMS_AsyncFreeLanes(State, CounterI);
+      free(State);
+      return TDMS_NO_MEMORY;
+    }
+    Lane->Mask = Size - 1;
+    Lane->Read = 0;
+    atomic_init(&Lane->Head, 0);
+    atomic_init(&Lane->Tail, 0);
+    atomic_init(&Lane->ProducerWaiting, 0);
+    sem_init(&Lane->Space, 0, 0);
+  }
+  State->NumOfLanes = NumOfLanes;
+  atomic_init(&State->ConsumerWaiting, 0);
+  atomic_init(&State->Closing, 0);
+  atomic_init(&State->Result, TDMS_OK);
+  atomic_init(&State->Dropped, 0);
+  sem_init(&State->Items, 0, 0);
+
+  // ChunkValues marks the Channels of the segment that is being generated
+  for (CounterI = 0; CounterI < Writer->File->NumOfGroups; CounterI++)
+  {
+    Group = Writer->File->GroupArray[CounterI];
+    for (CounterJ = 0; CounterJ < Group->NumOfChannels; CounterJ++)
+    {
+      Group->ChannelArray[CounterJ]->ChunkValues = NULL;
+      Group->ChannelArray[CounterJ]->ChunkNumOfValues = 0;
+    }
+  }
+
+  Async->Writer = Writer;
+  Async->Policy = Policy;
+  Async->RingSize = Size;
+  Async->NumOfLanes = NumOfLanes;
+  Async->State = State;
+
+  if (pthread_create(&State->Thread, NULL, TDMS_AsyncThread, Async) != 0)
+  {
+    sem_destroy(&State->Items);
+    TDMS_AsyncFreeLanes(State, NumOfLanes);
+    free(State);
+    Async->State = NULL;
+    return TDMS_IO_ERROR;
+  }
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Save all of the data values in the lanes, stop the background thread
+ *         and release the lanes
+ * @note   Producer threads must not set data values during or after this call.
+ *
+ * @param  Async: Pointer to TDMS Asynchronous Writer object structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - Others: First error of the background thread
+ */
+TDMS_Result_t
+TDMS_DeInitAsyncWriter(TDMS_AsyncWriter_t *Async)
+{
+  TDMS_AsyncState_t *State = (TDMS_AsyncState_t *) Async->State;
+  TDMS_Result_t Result = TDMS_OK;
+
+  if (!State)
+    return TDMS_OK;
+
+  atomic_store(&State->Closing, 1);
+  sem_post(&State->Items);
+  pthread_join(State->Thread, NULL);
+
+  Result = (TDMS_Result_t) atomic_load(&State->Result);
+  sem_destroy(&State->Items);
+  TDMS_AsyncFreeLanes(State, State->NumOfLanes);
+  free(State);
+  Async->State = NULL;
+
+  return Result;
+}
+
+
+/**
+ * @brief  Set data to a Channel (saved by the background thread) by the first
+ *         lane
+ * @note   Values are copied, so the buffer of values can be reused after the
+ *         call.
+ *
+ * @param  Async: Pointer to TDMS Asynchronous Writer object structure
+ * @param  Channel: Pointer to TDMS Channel object structure
+ * @param  Values: Pointer to data values
+ * @param  NumOfValues: Number of values
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_OUT_OF_CAP: The values are dropped (ring is full or smaller
+ *                            than the values)
+ *         - Others: Error of the background thread
+ */
+TDMS_Result_t
+TDMS_AsyncWriterSetChannelDataValues(TDMS_AsyncWriter_t *Async,
+                                     TDMS_Channel_t *Channel,
+                                     const void *Values,
+                                     uint64_t NumOfValues)
+{
+  return TDMS_AsyncPushChannel(Async, 0, Channel, Values, NumOfValues);
+}
+
+
+/**
+ * @brief  Set data to Channels of a Group (saved by the background thread) by
+ *         the first lane
+ * @param  Async: Pointer to TDMS Asynchronous Writer object structure
+ * @param  Group: Pointer to TDMS Group object structure
+ * @param  ...: Pointer to Channels data values, Number of values (uint64_t).
+ *         (like TDMS_SetGroupDataValues)
+ *
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_OUT_OF_CAP: The values are dropped (ring is full or smaller
+ *                            than the values)
+ *         - Others: Error of the background thread
+ */
+TDMS_Result_t
+TDMS_AsyncWriterSetGroupDataValues(TDMS_AsyncWriter_t *Async,
+                                   TDMS_Group_t *Group,
+                                   ...
+                                   )
+{
+  TDMS_Result_t Result = TDMS_OK;
+  va_list valist;
+
+  va_start(valist, Group);
+  Result = TDMS_AsyncPushGroup(Async, 0, Group, valist);
+  va_end(valist);
+
+  return Result;
+}
+
+
+/**
+ * @brief  Set data to a Channel (saved by the background thread) by a lane
+ * @param  Async: Pointer to TDMS Asynchronous Writer object structure
+ * @param  Lane: Index of the lane of the calling thread
+ * @param  Channel: Pointer to TDMS Channel object structure
+ * @param  Values: Pointer to data values
+ * @param  NumOfValues: Number of values
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_OUT_OF_CAP: The values are dropped (ring is full or smaller
+ *                            than the values)
+ *         - Others: Error of the background thread
+ */
+TDMS_Result_t
+TDMS_AsyncWriterLaneSetChannelDataValues(TDMS_AsyncWriter_t *Async,
+                                         uint32_t Lane,
+                                         TDMS_Channel_t *Channel,
+                                         const void *Values,
+                                         uint64_t NumOfValues)
+{
+  return TDMS_AsyncPushChannel(Async, Lane, Channel, Values, NumOfValues);
+}
+
+
+/**
+ * @brief  Set data to Channels of a Group (saved by the background thread) by
+ *         a lane
+ * @param  Async: Pointer to TDMS Asynchronous Writer object structure
+ * @param  Lane: Index of the lane of the calling thread
+ * @param  Group: Pointer to TDMS Group object structure
+ * @param  ...: Pointer to Channels data values, Number of values (uint64_t).
+ *         (like TDMS_SetGroupDataValues)
+ *
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_OUT_OF_CAP: The values are dropped (ring is full or smaller
+ *                            than the values)
+ *         - Others: Error of the background thread
+ */
+TDMS_Result_t
+TDMS_AsyncWriterLaneSetGroupDataValues(TDMS_AsyncWriter_t *Async,
+                                       uint32_t Lane,
+                                       TDMS_Group_t *Group,
+                                       ...
+                                       )
+{
+  TDMS_Result_t Result = TDMS_OK;
+  va_list valist;
+
+  va_start(valist, Group);
+  Result = TDMS_AsyncPushGroup(Async, Lane, Group, valist);
+  va_end(valist);
+
+  return Result;
+}
+
+
+/**
+ * @brief  Get number of data values that are dropped because a ring was full
+ * @param  Async: Pointer to TDMS Asynchronous Writer object structure
+ * @param  NumOfValues: Pointer to save number of dropped values
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ */
+TDMS_Result_t
+TDMS_AsyncWriterDropped(TDMS_AsyncWriter_t *Async, uint64_t *NumOfValues)
+{
+  TDMS_AsyncState_t *State = (TDMS_AsyncState_t *) Async->State;
+
+  *NumOfValues = State ? atomic_load(&State->Dropped) : 0;
+
+  return TDMS_OK;
+}
+
+#endif //! TDMS_CONFIG_POSIX
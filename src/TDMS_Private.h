@@ -0,0 +1,128 @@
+/**
+ **********************************************************************************
+ * @file   TDMS_Private.h
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  Constants of TDMS file format that are shared between the modules of
+ *         the library (not a part of the public API)
+ **********************************************************************************
+ */
+
+/* Define to prevent recursive inclusion ----------------------------------------*/
+#ifndef _TDMS_PRIVATE_H_
+#define _TDMS_PRIVATE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* Includes ---------------------------------------------------------------------*/
+#include "TDMS.h"
+#include <stdint.h>
+
+
+/* Private Constants ------------------------------------------------------------*/
+/**
+ * @brief  Lead in part constants
+ */ 
+#define LeadInPartLen         28
+#define TAG_TDSm_Num          0x5444536D
+#define TAG_TDSh_Num          0x54445368
+#define Version_Number4713    4713
+
+/**
+ * @brief  ToC mask constants
+ */ 
+#define kTocMetaData          0x00000002
+#define kTocRawData           0x00000008
+#define kTocNewObjList        0x00000004
+#define kTocInterleavedData   0x00000020
+#define kTocBigEndian         0x00000040
+#define kTocDAQmxRawData      0x00000080
+
+/**
+ * @brief  Data type constants
+ */
+#define tdsTypeVoid                   0x00000000
+#define tdsTypeI8                     0x00000001
+#define tdsTypeI16                    0x00000002
+#define tdsTypeI32                    0x00000003
+#define tdsTypeI64                    0x00000004
+#define tdsTypeU8                     0x00000005
+#define tdsTypeU16                    0x00000006
+#define tdsTypeU32                    0x00000007
+#define tdsTypeU64                    0x00000008
+#define tdsTypeSingleFloat            0x00000009
+#define tdsTypeDoubleFloat            0x0000000A
+#define tdsTypeExtendedFloat          0x0000000B
+#define tdsTypeSingleFloatWithUnit    0x00000019
+#define tdsTypeDoubleFloatWithUnit    0x0000001A
+#define tdsTypeExtendedFloatWithUnit  0x0000001B
+#define tdsTypeString                 0x00000020
+#define tdsTypeBoolean                0x00000021
+#define tdsTypeTimeStamp              0x00000044
+#define tdsTypeFixedPoint             0x0000004F
+#define tdsTypeComplexSingleFloat     0x0008000C
+#define tdsTypeComplexDoubleFloat     0x0010000D
+#define tdsTypeDAQmxRawData           0xFFFFFFFF
+
+/**
+ * @brief  DAQmx raw data index constants
+ */
+#define DAQmxFormatChangingScaler     0x00001269
+#define DAQmxDigitalLineScaler        0x0000126A
+
+/**
+ * @brief  DAQmx data type constants (data type of format changing scalers)
+ */
+#define daqmxTypeU8                   0x00000000
+#define daqmxTypeI8                   0x00000001
+#define daqmxTypeU16                  0x00000002
+#define daqmxTypeI16                  0x00000003
+#define daqmxTypeU32                  0x00000004
+#define daqmxTypeI32                  0x00000005
+#define daqmxTypeU64                  0x00000006
+#define daqmxTypeI64                  0x00000007
+#define daqmxTypeSingleFloat          0x00000008
+#define daqmxTypeDoubleFloat          0x00000009
+#define daqmxTypeNone                 0xFFFFFFFF
+
+
+/* Private Variables ------------------------------------------------------------*/
+/**
+ * @brief  Binary code and size (Byte) of each data type (defined in TDMS.c)
+ */
+extern const uint32_t dataTypeBinary[TDMS_DataType_MAX];
+extern const uint8_t dataTypeLength[TDMS_DataType_MAX];
+
+/**
+ * @brief  DAQmx data type code of each data type (daqmxTypeNone: not
+ *         supported in DAQmx raw data) (defined in TDMS.c)
+ */
+extern const uint32_t daqmxDataType[TDMS_DataType_MAX];
+
+
+/* Private Functions ------------------------------------------------------------*/
+/**
+ * @brief  Generate a raw data segment for some Channels and save it into the
+ *         sink of a Writer (defined in TDMS.c)
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Channels: Array of Channels of the segment (ChunkValues and
+ *                   ChunkNumOfValues of each Channel must be set)
+ * @param  NumOfChannels: Number of Channels in array
+ * @param  Interleaved: 1 to generate interleaved raw data
+ * @param  Frames: Pointer to raw data that is already interleaved or Null
+ * @retval TDMS_Result_t
+ */
+TDMS_Result_t
+TDMS_WriterGenDataSegment(TDMS_Writer_t *Writer,
+                          TDMS_Channel_t **Channels, uint32_t NumOfChannels,
+                          uint8_t Interleaved, const void *Frames);
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //! _TDMS_PRIVATE_H_
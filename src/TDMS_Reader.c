@@ -0,0 +1,1647 @@
+/**
+ **********************************************************************************
+ * @file   TDMS_Reader.c
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  Read NI TDMS file (.TDMS)
+ * @note   The file is mapped into memory (or loaded if mmap is not available)
+ *         and an index of its segments and objects is built by walking the lead
+ *         in parts. Raw data is not touched until a chunk is requested, and the
+ *         chunks point into the mapped file (zero-copy).
+ * @note   DAQmx raw data is supported with one format changing scaler for
+ *         each object and one raw buffer for each segment.
+ **********************************************************************************
+ */
+
+/* Includes ---------------------------------------------------------------------*/
+#include "TDMS_Reader.h"
+#include "TDMS_Private.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#if (TDMS_CONFIG_POSIX == 1)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+
+/* Private Constants ------------------------------------------------------------*/
+/**
+ * @brief  Lead in part constants
+ */
+#define Version4712               4712
+#define Version4713               4713
+#define UnknownSegmentLength      0xFFFFFFFFFFFFFFFF
+
+/**
+ * @brief  Raw data index constants
+ */
+#define NoRawData                 0xFFFFFFFF
+#define SameRawDataIndex          0x00000000
+
+/**
+ * @brief  Size of a DAQmx format changing scaler (Byte)
+ */
+#define DAQmxScalerLen            20
+
+/**
+ * @brief  Index of nothing in the arrays of Reader
+ */
+#define NoIndex                   0xFFFFFFFF
+
+/**
+ * @brief  Size of the arrays of Reader when they are allocated for the first
+ *         time
+ */
+#define ReaderInitialSize         16
+
+/**
+ * @brief  Owner of the content of the file
+ */
+#define OwnerUser                 0
+#define OwnerMapped               1
+#define OwnerAllocated            2
+
+
+
+/**
+ ==================================================================================
+                           ##### Private Functions #####
+ ==================================================================================
+ */
+
+/**
+ * @brief  Load a 32 bit unsigned integer
+ * @param  Data: Pointer to the integer
+ * @param  BigEndian: 1 if the integer is big-endian
+ * @retval The integer
+ */
+static uint32_t
+TDMS_ReaderLoad32(const uint8_t *Data, uint8_t BigEndian)
+{
+  if (BigEndian)
+    return ((uint32_t) Data[0] << 24) | ((uint32_t) Data[1] << 16) |
+           ((uint32_t) Data[2] << 8) | (uint32_t) Data[3];
+
+  return ((uint32_t) Data[3] << 24) | ((uint32_t) Data[2] << 16) |
+         ((uint32_t) Data[1] << 8) | (uint32_t) Data[0];
+}
+
+
+/**
+ * @brief  Load a 64 bit unsigned integer
+ * @param  Data: Pointer to the integer
+ * @param  BigEndian: 1 if the integer is big-endian
+ * @retval The integer
+ */
+static uint64_t
+TDMS_ReaderLoad64(const uint8_t *Data, uint8_t BigEndian)
+{
+  if (BigEndian)
+    return ((uint64_t) TDMS_ReaderLoad32(Data, 1) << 32) |
+           TDMS_ReaderLoad32(Data + 4, 1);
+
+  return ((uint64_t) TDMS_ReaderLoad32(Data + 4, 0) << 32) |
+         TDMS_ReaderLoad32(Data, 0);
+}
+
+
+/**
+ * @brief  Store a 32 bit unsigned integer
+ * @param  Data: Pointer to area that the integer save into
+ * @param  Value: The integer
+ * @param  BigEndian: 1 to store the integer big-endian
+ * @retval None
+ */
+static void
+TDMS_ReaderStore32(uint8_t *Data, uint32_t Value, uint8_t BigEndian)
+{
+  uint32_t CounterI = 0;
+
+  for (CounterI = 0; CounterI < 4; CounterI++)
+    Data[BigEndian ? (3 - CounterI) : CounterI] = (uint8_t) (Value >> (CounterI * 8));
+}
+
+
+/**
+ * @brief  Store a 64 bit unsigned integer (little-endian)
+ * @param  Data: Pointer to area that the integer save into
+ * @param  Value: The integer
+ * @retval None
+ */
+static void
+TDMS_ReaderStore64(uint8_t *Data, uint64_t Value)
+{
+  TDMS_ReaderStore32(Data, (uint32_t) Value, 0);
+  TDMS_ReaderStore32(Data + 4, (uint32_t) (Value >> 32), 0);
+}
+
+
+/**
+ * @brief  Make sure an array of Reader has room for one more element
+ * @param  Array: Pointer to the array
+ * @param  Size: Pointer to capacity of the array (number of elements)
+ * @param  Len: Number of elements in the array
+ * @param  ElementSize: Size of each element (Byte)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ */
+static TDMS_Result_t
+TDMS_ReaderGrow(void **Array, uint32_t *Size, uint32_t Len, size_t ElementSize)
+{
+  uint32_t NewSize = 0;
+  void *NewArray = NULL;
+
+  if (Len < *Size)
+    return TDMS_OK;
+
+  if (*Size >= (NoIndex >> 1))
+    return TDMS_NO_MEMORY;
+
+  NewSize = *Size ? (*Size << 1) : ReaderInitialSize;
+  NewArray = realloc(*Array, (size_t) NewSize * ElementSize);
+  if (!NewArray)
+    return TDMS_NO_MEMORY;
+
+  *Array = NewArray;
+  *Size = NewSize;
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Convert binary code of a data type to TDMS_Data_t
+ * @param  Code: Binary code of the data type
+ * @param  DataType: Pointer to save the data type
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: The data type is not supported
+ */
+static TDMS_Result_t
+TDMS_ReaderDataType(uint32_t Code, TDMS_Data_t *DataType)
+{
+  uint32_t CounterI = 0;
+
+  for (CounterI = 0; CounterI < TDMS_DataType_MAX; CounterI++)
+  {
+    if (dataTypeBinary[CounterI] == Code)
+    {
+      *DataType = (TDMS_Data_t) CounterI;
+      return TDMS_OK;
+    }
+  }
+
+  return TDMS_WRONG_ARG;
+}
+
+
+/**
+ * @brief  Convert DAQmx data type code of a scaler to TDMS_Data_t
+ * @param  Code: DAQmx data type code
+ * @param  DataType: Pointer to save the data type
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: The data type is not supported
+ */
+static TDMS_Result_t
+TDMS_ReaderDAQmxDataType(uint32_t Code, TDMS_Data_t *DataType)
+{
+  uint32_t CounterI = 0;
+
+  if (Code == daqmxTypeNone)
+    return TDMS_WRONG_ARG;
+
+  for (CounterI = 0; CounterI < TDMS_DataType_MAX; CounterI++)
+  {
+    if (daqmxDataType[CounterI] == Code)
+    {
+      *DataType = (TDMS_Data_t) CounterI;
+      return TDMS_OK;
+    }
+  }
+
+  return TDMS_WRONG_ARG;
+}
+
+
+/**
+ * @brief  Hash of path of an object (FNV-1a)
+ * @param  Path: Pointer to the path
+ * @param  PathLen: Length of the path
+ * @retval Hash of the path
+ */
+static uint32_t
+TDMS_ReaderHash(const char *Path, uint32_t PathLen)
+{
+  uint32_t Hash = 2166136261u;
+  uint32_t CounterI = 0;
+
+  for (CounterI = 0; CounterI < PathLen; CounterI++)
+  {
+    Hash ^= (uint8_t) Path[CounterI];
+    Hash *= 16777619u;
+  }
+
+  return Hash;
+}
+
+
+/**
+ * @brief  Put an object into the hash table of the objects
+ * @note   The hash table must have an empty slot.
+ *
+ * @param  Reader: Pointer to TDMS Reader structure
+ * @param  Object: Index of the object in Reader->Objects
+ * @retval None
+ */
+static void
+TDMS_ReaderHashInsert(TDMS_Reader_t *Reader, uint32_t Object)
+{
+  uint32_t Mask = Reader->ObjectHashSize - 1;
+  uint32_t Slot = TDMS_ReaderHash(Reader->Objects[Object].Path,
+                                  Reader->Objects[Object].PathLen) & Mask;
+
+  while (Reader->ObjectHash[Slot])
+    Slot = (Slot + 1) & Mask;
+
+  Reader->ObjectHash[Slot] = Object + 1;
+}
+
+
+/**
+ * @brief  Find an object by its path and add it if it does not exist
+ * @param  Reader: Pointer to TDMS Reader structure
+ * @param  Path: Pointer to the path
+ * @param  PathLen: Length of the path
+ * @param  Create: 1 to add the object if it does not exist
+ * @param  Object: Pointer to save index of the object in Reader->Objects
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: The object does not exist (Create is 0)
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ */
+static TDMS_Result_t
+TDMS_ReaderGetObject(TDMS_Reader_t *Reader, const char *Path, uint32_t PathLen,
+                     uint8_t Create, uint32_t *Object)
+{
+  TDMS_ReaderObject_t *Obj = NULL;
+  uint32_t *NewHash = NULL;
+  uint32_t NewHashSize = 0;
+  uint32_t Mask = 0;
+  uint32_t Slot = 0;
+  uint32_t CounterI = 0;
+
+  if (Reader->ObjectHashSize)
+  {
+    Mask = Reader->ObjectHashSize - 1;
+    Slot = TDMS_ReaderHash(Path, PathLen) & Mask;
+    while (Reader->ObjectHash[Slot])
+    {
+      Obj = &Reader->Objects[Reader->ObjectHash[Slot] - 1];
+      if (Obj->PathLen == PathLen && memcmp(Obj->Path, Path, PathLen) == 0)
+      {
+        *Object = Reader->ObjectHash[Slot] - 1;
+        return TDMS_OK;
+      }
+      Slot = (Slot + 1) & Mask;
+    }
+  }
+
+  if (!Create)
+    return TDMS_WRONG_ARG;
+
+  // keep the hash table at most half full
+  if (((uint64_t) Reader->NumOfObjects + 1) * 2 > Reader->ObjectHashSize)
+  {
+    if (Reader->ObjectHashSize >= (NoIndex >> 1))
+      return TDMS_NO_MEMORY;
+    NewHashSize = Reader->ObjectHashSize ?
+                  (Reader->ObjectHashSize << 1) : (ReaderInitialSize << 2);
+    NewHash = calloc(NewHashSize, sizeof(uint32_t));
+    if (!NewHash)
+      return TDMS_NO_MEMORY;
+    free(Reader->ObjectHash);
+    Reader->ObjectHash = NewHash;
+    Reader->ObjectHashSize = NewHashSize;
+    for (CounterI = 0; CounterI < Reader->NumOfObjects; CounterI++)
+      TDMS_ReaderHashInsert(Reader, CounterI);
+  }
+
+  if (TDMS_ReaderGrow((void **) &Reader->Objects, &Reader->ObjectsSize,
+                      Reader->NumOfObjects,
+                      sizeof(TDMS_ReaderObject_t)) != TDMS_OK)
+    return TDMS_NO_MEMORY;
+
+  Obj = &Reader->Objects[Reader->NumOfObjects];
+  memset(Obj, 0, sizeof(TDMS_ReaderObject_t));
+  Obj->Path = Path;
+  Obj->PathLen = PathLen;
+  Obj->DataType = TDMS_DataType_Void;
+  Obj->FirstEntry = NoIndex;
+  Obj->LastEntry = NoIndex;
+  Obj->FirstProperty = NoIndex;
+  Obj->LastProperty = NoIndex;
+
+  *Object = Reader->NumOfObjects;
+  Reader->NumOfObjects++;
+  TDMS_ReaderHashInsert(Reader, *Object);
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Add an object to the object list of the last segment
+ * @param  Reader: Pointer to TDMS Reader structure
+ * @param  Object: Index of the object in Reader->Objects
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ */
+static TDMS_Result_t
+TDMS_ReaderListAdd(TDMS_Reader_t *Reader, uint32_t Object)
+{
+  if (Reader->Objects[Object].InList)
+    return TDMS_OK;
+
+  if (TDMS_ReaderGrow((void **) &Reader->List, &Reader->ListSize,
+                      Reader->ListLen, sizeof(uint32_t)) != TDMS_OK)
+    return TDMS_NO_MEMORY;
+
+  Reader->List[Reader->ListLen] = Object;
+  Reader->ListLen++;
+  Reader->Objects[Object].InList = 1;
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Remove an object from the object list of the last segment
+ * @param  Reader: Pointer to TDMS Reader structure
+ * @param  Object: Index of the object in Reader->Objects
+ * @retval None
+ */
+static void
+TDMS_ReaderListRemove(TDMS_Reader_t *Reader, uint32_t Object)
+{
+  uint32_t CounterI = 0;
+
+  if (!Reader->Objects[Object].InList)
+    return;
+
+  for (CounterI = 0; CounterI < Reader->ListLen; CounterI++)
+  {
+    if (Reader->List[CounterI] == Object)
+    {
+      memmove(&Reader->List[CounterI], &Reader->List[CounterI + 1],
+              (Reader->ListLen - CounterI - 1) * sizeof(uint32_t));
+      Reader->ListLen--;
+      break;
+    }
+  }
+  Reader->Objects[Object].InList = 0;
+}
+
+
+/**
+ * @brief  Parse DAQmx raw data index of an object
+ * @note   Only one format changing scaler that its values are in the first raw
+ *         buffer is supported.
+ *
+ * @param  Reader: Pointer to TDMS Reader structure
+ * @param  Object: Index of the object in Reader->Objects
+ * @param  Pos: Pointer to offset of the data type of the raw data index in the
+ *              file
+ *
+ * @param  End: Offset of end of the meta data in the file
+ * @param  BigEndian: 1 if the meta data is big-endian
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: The raw data index is not valid or not supported
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ */
+static TDMS_Result_t
+TDMS_ReaderParseDAQmxIndex(TDMS_Reader_t *Reader, uint32_t Object,
+                           uint64_t *Pos, uint64_t End, uint8_t BigEndian)
+{
+  TDMS_ReaderObject_t *Obj = &Reader->Objects[Object];
+  const uint8_t *Data = Reader->Data;
+  TDMS_Data_t DataType = TDMS_DataType_Void;
+  uint64_t NumOfValues = 0;
+  uint32_t NumOfScalers = 0;
+  uint32_t NumOfWidths = 0;
+  uint32_t Offset = 0;
+  uint32_t Width = 0;
+
+  // data type, array dimension, number of values and number of scalers
+  if (End - *Pos < 20)
+    return TDMS_WRONG_ARG;
+  if (TDMS_ReaderLoad32(Data + *Pos, BigEndian) != tdsTypeDAQmxRawData ||
+      TDMS_ReaderLoad32(Data + *Pos + 4, BigEndian) != 1)
+    return TDMS_WRONG_ARG;
+  NumOfValues = TDMS_ReaderLoad64(Data + *Pos + 8, BigEndian);
+  NumOfScalers = TDMS_ReaderLoad32(Data + *Pos + 16, BigEndian);
+  *Pos += 20;
+
+  // data type, raw buffer index, byte offset in the frame, sample format
+  // bitmap and scale ID of the scaler
+  if (NumOfScalers != 1 || End - *Pos < DAQmxScalerLen + 4)
+    return TDMS_WRONG_ARG;
+  if (TDMS_ReaderDAQmxDataType(TDMS_ReaderLoad32(Data + *Pos, BigEndian),
+                               &DataType) != TDMS_OK ||
+      TDMS_ReaderLoad32(Data + *Pos + 4, BigEndian) != 0)
+    return TDMS_WRONG_ARG;
+  Offset = TDMS_ReaderLoad32(Data + *Pos + 8, BigEndian);
+  *Pos += DAQmxScalerLen;
+
+  // raw data widths (size of the frames of each raw buffer)
+  NumOfWidths = TDMS_ReaderLoad32(Data + *Pos, BigEndian);
+  *Pos += 4;
+  if (NumOfWidths == 0 || (End - *Pos) / 4 < NumOfWidths)
+    return TDMS_WRONG_ARG;
+  Width = TDMS_ReaderLoad32(Data + *Pos, BigEndian);
+  *Pos += (uint64_t) NumOfWidths * 4;
+
+  if ((uint64_t) Offset + dataTypeLength[DataType] > Width ||
+      NumOfValues > UINT64_MAX / Width)
+    return TDMS_WRONG_ARG;
+
+  Obj->DataType = DataType;
+  Obj->IndexNumOfValues = NumOfValues;
+  Obj->IndexSize = NumOfValues * dataTypeLength[DataType];
+  Obj->DAQmxOffset = Offset;
+  Obj->DAQmxWidth = Width;
+  Obj->HasIndex = 1;
+
+  return TDMS_ReaderListAdd(Reader, Object);
+}
+
+
+/**
+ * @brief  Parse raw data index of an object
+ * @param  Reader: Pointer to TDMS Reader structure
+ * @param  Object: Index of the object in Reader->Objects
+ * @param  Pos: Pointer to offset of the raw data index in the file
+ * @param  End: Offset of end of the meta data in the file
+ * @param  BigEndian: 1 if the meta data is big-endian
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: The raw data index is not valid or not supported
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ */
+static TDMS_Result_t
+TDMS_ReaderParseRawDataIndex(TDMS_Reader_t *Reader, uint32_t Object,
+                             uint64_t *Pos, uint64_t End, uint8_t BigEndian)
+{
+  TDMS_ReaderObject_t *Obj = &Reader->Objects[Object];
+  const uint8_t *Data = Reader->Data;
+  TDMS_Data_t DataType = TDMS_DataType_Void;
+  uint32_t IndexLen = 0;
+  uint64_t NumOfValues = 0;
+  uint64_t Size = 0;
+
+  if (End - *Pos < 4)
+    return TDMS_WRONG_ARG;
+  IndexLen = TDMS_ReaderLoad32(Data + *Pos, BigEndian);
+  *Pos += 4;
+
+  if (IndexLen == NoRawData)
+  {
+    TDMS_ReaderListRemove(Reader, Object);
+    return TDMS_OK;
+  }
+
+  if (IndexLen == SameRawDataIndex)
+  {
+    if (!Obj->HasIndex)
+      return TDMS_WRONG_ARG;
+    return TDMS_ReaderListAdd(Reader, Object);
+  }
+
+  if (IndexLen == DAQmxFormatChangingScaler)
+    return TDMS_ReaderParseDAQmxIndex(Reader, Object, Pos, End, BigEndian);
+
+  if (IndexLen == DAQmxDigitalLineScaler)
+    return TDMS_WRONG_ARG;
+
+  // data type, array dimension, number of values and (for strings) total size
+  if (IndexLen < 20 || End - *Pos < IndexLen - 4)
+    return TDMS_WRONG_ARG;
+  if (TDMS_ReaderDataType(TDMS_ReaderLoad32(Data + *Pos, BigEndian),
+                          &DataType) != TDMS_OK)
+    return TDMS_WRONG_ARG;
+  if (TDMS_ReaderLoad32(Data + *Pos + 4, BigEndian) != 1)
+    return TDMS_WRONG_ARG;
+  NumOfValues = TDMS_ReaderLoad64(Data + *Pos + 8, BigEndian);
+
+  if (DataType == TDMS_DataType_String)
+  {
+    if (IndexLen < 28)
+      return TDMS_WRONG_ARG;
+    Size = TDMS_ReaderLoad64(Data + *Pos + 16, BigEndian);
+  }
+  else
+  {
+    if (dataTypeLength[DataType] == 0 ||
+        NumOfValues > UINT64_MAX / dataTypeLength[DataType])
+      return TDMS_WRONG_ARG;
+    Size = NumOfValues * dataTypeLength[DataType];
+  }
+  *Pos += IndexLen - 4;
+
+  Obj->DataType = DataType;
+  Obj->IndexNumOfValues = NumOfValues;
+  Obj->IndexSize = Size;
+  Obj->DAQmxWidth = 0;
+  Obj->HasIndex = 1;
+
+  return TDMS_ReaderListAdd(Reader, Object);
+}
+
+
+/**
+ * @brief  Parse properties of an object
+ * @param  Reader: Pointer to TDMS Reader structure
+ * @param  Object: Index of the object in Reader->Objects
+ * @param  Pos: Pointer to offset of the number of properties in the file
+ * @param  End: Offset of end of the meta data in the file
+ * @param  BigEndian: 1 if the meta data is big-endian
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: The properties are not valid or not supported
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ */
+static TDMS_Result_t
+TDMS_ReaderParseProperties(TDMS_Reader_t *Reader, uint32_t Object,
+                           uint64_t *Pos, uint64_t End, uint8_t BigEndian)
+{
+  TDMS_ReaderObject_t *Obj = &Reader->Objects[Object];
+  TDMS_ReaderProperty_t *Property = NULL;
+  const uint8_t *Data = Reader->Data;
+  TDMS_Data_t DataType = TDMS_DataType_Void;
+  uint32_t NumOfProperties = 0;
+  uint32_t NameLen = 0;
+  uint32_t ValueLen = 0;
+  uint32_t CounterI = 0;
+
+  if (End - *Pos < 4)
+    return TDMS_WRONG_ARG;
+  NumOfProperties = TDMS_ReaderLoad32(Data + *Pos, BigEndian);
+  *Pos += 4;
+
+  for (CounterI = 0; CounterI < NumOfProperties; CounterI++)
+  {
+    if (End - *Pos < 4)
+      return TDMS_WRONG_ARG;
+    NameLen = TDMS_ReaderLoad32(Data + *Pos, BigEndian);
+    if (End - *Pos - 4 < (uint64_t) NameLen + 4)
+      return TDMS_WRONG_ARG;
+    if (TDMS_ReaderDataType(TDMS_ReaderLoad32(Data + *Pos + 4 + NameLen,
+                                              BigEndian), &DataType) != TDMS_OK)
+      return TDMS_WRONG_ARG;
+
+    if (TDMS_ReaderGrow((void **) &Reader->Properties, &Reader->PropertiesSize,
+                        Reader->NumOfProperties,
+                        sizeof(TDMS_ReaderProperty_t)) != TDMS_OK)
+      return TDMS_NO_MEMORY;
+    Property = &Reader->Properties[Reader->NumOfProperties];
+    Property->Name = (const char *) (Data + *Pos + 4);
+    Property->NameLen = NameLen;
+    Property->DataType = DataType;
+    Property->BigEndian = BigEndian;
+    Property->NextProperty = NoIndex;
+    *Pos += 4 + NameLen + 4;
+
+    if (DataType == TDMS_DataType_String)
+    {
+      if (End - *Pos < 4)
+        return TDMS_WRONG_ARG;
+      ValueLen = TDMS_ReaderLoad32(Data + *Pos, BigEndian);
+      *Pos += 4;
+    }
+    else
+    {
+      ValueLen = dataTypeLength[DataType];
+      if (ValueLen == 0 || DataType == TDMS_DataType_Void)
+        return TDMS_WRONG_ARG;
+    }
+    if (End - *Pos < ValueLen)
+      return TDMS_WRONG_ARG;
+    Property->Value = Data + *Pos;
+    Property->Size = ValueLen;
+    *Pos += ValueLen;
+
+    if (Obj->LastProperty == NoIndex)
+      Obj->FirstProperty = Reader->NumOfProperties;
+    else
+      Reader->Properties[Obj->LastProperty].NextProperty =
+          Reader->NumOfProperties;
+    Obj->LastProperty = Reader->NumOfProperties;
+    Reader->NumOfProperties++;
+  }
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Parse meta data part of a segment
+ * @param  Reader: Pointer to TDMS Reader structure
+ * @param  ToC: ToC mask of the segment
+ * @param  Pos: Offset of the meta data in the file
+ * @param  End: Offset of end of the meta data in the file
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: The meta data is not valid or not supported
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ */
+static TDMS_Result_t
+TDMS_ReaderParseMetaData(TDMS_Reader_t *Reader, uint32_t ToC,
+                         uint64_t Pos, uint64_t End)
+{
+  TDMS_Result_t Result = TDMS_OK;
+  uint8_t BigEndian = (ToC & kTocBigEndian) ? 1 : 0;
+  uint32_t NumOfObjects = 0;
+  uint32_t PathLen = 0;
+  uint32_t Object = 0;
+  uint32_t CounterI = 0;
+
+  if (ToC & kTocNewObjList)
+  {
+    for (CounterI = 0; CounterI < Reader->ListLen; CounterI++)
+      Reader->Objects[Reader->List[CounterI]].InList = 0;
+    Reader->ListLen = 0;
+  }
+
+  if (End - Pos < 4)
+    return TDMS_WRONG_ARG;
+  NumOfObjects = TDMS_ReaderLoad32(Reader->Data + Pos, BigEndian);
+  Pos += 4;
+
+  for (CounterI = 0; CounterI < NumOfObjects; CounterI++)
+  {
+    if (End - Pos < 4)
+      return TDMS_WRONG_ARG;
+    PathLen = TDMS_ReaderLoad32(Reader->Data + Pos, BigEndian);
+    if (End - Pos - 4 < PathLen)
+      return TDMS_WRONG_ARG;
+    Result = TDMS_ReaderGetObject(Reader, (const char *) (Reader->Data + Pos + 4),
+                                  PathLen, 1, &Object);
+    if (Result != TDMS_OK)
+      return Result;
+    Pos += 4 + PathLen;
+
+    Result = TDMS_ReaderParseRawDataIndex(Reader, Object, &Pos, End, BigEndian);
+    if (Result != TDMS_OK)
+      return Result;
+
+    Result = TDMS_ReaderParseProperties(Reader, Object, &Pos, End, BigEndian);
+    if (Result != TDMS_OK)
+      return Result;
+  }
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Add the entries of the objects that have raw data in a segment
+ * @param  Reader: Pointer to TDMS Reader structure
+ * @param  Segment: Index of the segment in Reader->Segments
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: The raw data is not valid or not supported
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ */
+static TDMS_Result_t
+TDMS_ReaderAddEntries(TDMS_Reader_t *Reader, uint32_t Segment)
+{
+  TDMS_ReaderSegment_t *Seg = &Reader->Segments[Segment];
+  TDMS_ReaderObject_t *Obj = NULL;
+  TDMS_ReaderEntry_t *Entry = NULL;
+  uint8_t Interleaved = (Seg->ToC & kTocInterleavedData) ? 1 : 0;
+  uint8_t DAQmx = (Seg->ToC & kTocDAQmxRawData) ? 1 : 0;
+  uint64_t NumOfValues = 0;
+  uint64_t ChunkSize = 0;
+  uint32_t Width = 0;
+  uint32_t CounterI = 0;
+
+  // size of chunks, and for interleaved data, all of the objects must have
+  // the same number of values. Objects of DAQmx raw data share one raw
+  // buffer of frames, so they must have the same number of values and frame
+  // size too.
+  for (CounterI = 0; CounterI < Reader->ListLen; CounterI++)
+  {
+    Obj = &Reader->Objects[Reader->List[CounterI]];
+    if (Obj->IndexNumOfValues == 0)
+      continue;
+    if (DAQmx != (Obj->DAQmxWidth ? 1 : 0))
+      return TDMS_WRONG_ARG;
+    if (DAQmx)
+    {
+      if (NumOfValues && (NumOfValues != Obj->IndexNumOfValues ||
+                          Width != Obj->DAQmxWidth))
+        return TDMS_WRONG_ARG;
+      NumOfValues = Obj->IndexNumOfValues;
+      Width = Obj->DAQmxWidth;
+      ChunkSize = NumOfValues * Width;
+      continue;
+    }
+    if (Interleaved)
+    {
+      if (Obj->DataType == TDMS_DataType_String ||
+          (NumOfValues && NumOfValues != Obj->IndexNumOfValues))
+        return TDMS_WRONG_ARG;
+      NumOfValues = Obj->IndexNumOfValues;
+    }
+    if (ChunkSize + Obj->IndexSize < ChunkSize)
+      return TDMS_WRONG_ARG;
+    ChunkSize += Obj->IndexSize;
+  }
+
+  Seg->ChunkSize = ChunkSize;
+  Seg->NumOfChunks = ChunkSize ? (Seg->RawDataSize / ChunkSize) : 0;
+  Seg->FirstEntry = Reader->NumOfEntries;
+  Seg->NumOfEntries = 0;
+  if (Seg->NumOfChunks == 0)
+    return TDMS_OK;
+
+  ChunkSize = 0;
+  for (CounterI = 0; CounterI < Reader->ListLen; CounterI++)
+  {
+    Obj = &Reader->Objects[Reader->List[CounterI]];
+    if (Obj->IndexNumOfValues == 0)
+      continue;
+
+    if (TDMS_ReaderGrow((void **) &Reader->Entries, &Reader->EntriesSize,
+                        Reader->NumOfEntries,
+                        sizeof(TDMS_ReaderEntry_t)) != TDMS_OK)
+      return TDMS_NO_MEMORY;
+    Entry = &Reader->Entries[Reader->NumOfEntries];
+    Entry->Object = Reader->List[CounterI];
+    Entry->Segment = Segment;
+    Entry->NextEntry = NoIndex;
+    Entry->NumOfValues = Obj->IndexNumOfValues;
+    Entry->Size = Obj->IndexSize;
+    Entry->Offset = DAQmx ? Obj->DAQmxOffset : ChunkSize;
+    ChunkSize += Interleaved ? dataTypeLength[Obj->DataType] : Obj->IndexSize;
+
+    if (Obj->LastEntry == NoIndex)
+      Obj->FirstEntry = Reader->NumOfEntries;
+    else
+      Reader->Entries[Obj->LastEntry].NextEntry = Reader->NumOfEntries;
+    Obj->LastEntry = Reader->NumOfEntries;
+    Obj->NumOfValues += Obj->IndexNumOfValues * Seg->NumOfChunks;
+
+    Reader->NumOfEntries++;
+    Seg->NumOfEntries++;
+  }
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Walk the lead in parts of the file and build the index
+ * @param  Reader: Pointer to TDMS Reader structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: The file is not valid or not supported
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ */
+static TDMS_Result_t
+TDMS_ReaderBuildIndex(TDMS_Reader_t *Reader)
+{
+  TDMS_Result_t Result = TDMS_OK;
+  TDMS_ReaderSegment_t *Seg = NULL;
+  const uint8_t *Data = Reader->Data;
+  uint8_t IndexFile = 0;
+  uint8_t BigEndian = 0;
+  uint32_t Tag = 0;
+  uint32_t ToC = 0;
+  uint32_t Version = 0;
+  uint64_t NextSegmentOffset = 0;
+  uint64_t RawDataOffset = 0;
+  uint64_t Pos = 0;
+  uint64_t End = 0;
+
+  while (Reader->Size - Pos >= LeadInPartLen)
+  {
+    // ToC is always little-endian, version and offsets are in the byte order
+    // of the segment
+    Tag = TDMS_ReaderLoad32(Data + Pos, 1);
+    if (Pos == 0)
+      IndexFile = (Tag == TAG_TDSh_Num) ? 1 : 0;
+    if (Tag != (IndexFile ? TAG_TDSh_Num : TAG_TDSm_Num))
+      return TDMS_WRONG_ARG;
+    ToC = TDMS_ReaderLoad32(Data + Pos + 4, 0);
+    BigEndian = (ToC & kTocBigEndian) ? 1 : 0;
+    Version = TDMS_ReaderLoad32(Data + Pos + 8, BigEndian);
+    NextSegmentOffset = TDMS_ReaderLoad64(Data + Pos + 12, BigEndian);
+    RawDataOffset = TDMS_ReaderLoad64(Data + Pos + 20, BigEndian);
+    if (Version != Version4712 && Version != Version4713)
+      return TDMS_WRONG_ARG;
+    Pos += LeadInPartLen;
+
+    // segments of index files have no raw data, and the last segment of a
+    // file may be incomplete (e.g. the writer did not finish it)
+    if (IndexFile)
+      NextSegmentOffset = (ToC & kTocMetaData) ? RawDataOffset : 0;
+    if (NextSegmentOffset == UnknownSegmentLength ||
+        NextSegmentOffset > Reader->Size - Pos)
+      NextSegmentOffset = Reader->Size - Pos;
+    if (RawDataOffset > NextSegmentOffset)
+      return TDMS_WRONG_ARG;
+    End = Pos + NextSegmentOffset;
+
+    if (TDMS_ReaderGrow((void **) &Reader->Segments, &Reader->SegmentsSize,
+                        Reader->NumOfSegments,
+                        sizeof(TDMS_ReaderSegment_t)) != TDMS_OK)
+      return TDMS_NO_MEMORY;
+    Seg = &Reader->Segments[Reader->NumOfSegments];
+    memset(Seg, 0, sizeof(TDMS_ReaderSegment_t));
+    Seg->ToC = ToC;
+    Seg->Offset = Pos - LeadInPartLen;
+    Seg->RawDataOffset = Pos + RawDataOffset;
+    Seg->RawDataSize = (ToC & kTocRawData) ? (End - Seg->RawDataOffset) : 0;
+    Seg->FirstEntry = Reader->NumOfEntries;
+    Reader->NumOfSegments++;
+
+    if (ToC & kTocMetaData)
+    {
+      Result = TDMS_ReaderParseMetaData(Reader, ToC, Pos, Pos + RawDataOffset);
+      if (Result != TDMS_OK)
+        return Result;
+    }
+
+    if (ToC & kTocRawData)
+    {
+      Result = TDMS_ReaderAddEntries(Reader, Reader->NumOfSegments - 1);
+      if (Result != TDMS_OK)
+        return Result;
+    }
+
+    Pos = End;
+  }
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Fill a chunk by its entry and index
+ * @param  Reader: Pointer to TDMS Reader structure
+ * @param  Chunk: Pointer to TDMS Reader Chunk structure
+ * @retval None
+ */
+static void
+TDMS_ReaderFillChunk(TDMS_Reader_t *Reader, TDMS_ReaderChunk_t *Chunk)
+{
+  TDMS_ReaderEntry_t *Entry = &Reader->Entries[Chunk->Entry];
+  TDMS_ReaderSegment_t *Seg = &Reader->Segments[Entry->Segment];
+  TDMS_Data_t DataType = Reader->Objects[Entry->Object].DataType;
+
+  Chunk->DataType = DataType;
+  Chunk->Data = Reader->Data + Seg->RawDataOffset +
+                Chunk->Index * Seg->ChunkSize + Entry->Offset;
+  Chunk->NumOfValues = Entry->NumOfValues;
+  Chunk->Size = Entry->Size;
+  Chunk->BigEndian = (Seg->ToC & kTocBigEndian) ? 1 : 0;
+
+  if (Seg->ToC & (kTocInterleavedData | kTocDAQmxRawData))
+    Chunk->Stride = Seg->ChunkSize / Entry->NumOfValues;
+  else
+    Chunk->Stride = dataTypeLength[DataType];
+}
+
+
+/**
+ * @brief  Copy a value and convert it to little-endian
+ * @param  Dest: Pointer to destination
+ * @param  Src: Pointer to the value
+ * @param  Len: Size of the value (Byte)
+ * @param  BigEndian: 1 if the value is big-endian (Timestamps are reversed as a
+ *                    whole, so their fraction comes first)
+ *
+ * @retval None
+ */
+static void
+TDMS_ReaderCopyValue(uint8_t *Dest, const uint8_t *Src, uint32_t Len,
+                     uint8_t BigEndian)
+{
+  uint32_t CounterI = 0;
+
+  if (!BigEndian)
+  {
+    memcpy(Dest, Src, Len);
+    return;
+  }
+
+  for (CounterI = 0; CounterI < Len; CounterI++)
+    Dest[CounterI] = Src[Len - 1 - CounterI];
+}
+
+
+/**
+ * @brief  Check if a property is the last value of its name in its object
+ * @param  Reader: Pointer to TDMS Reader structure
+ * @param  Index: Index of the property in Reader->Properties
+ * @retval 1 if the property is not set again, otherwise 0
+ */
+static uint8_t
+TDMS_ReaderIsLastProperty(TDMS_Reader_t *Reader, uint32_t Index)
+{
+  const TDMS_ReaderProperty_t *Property = &Reader->Properties[Index];
+  const TDMS_ReaderProperty_t *Next = NULL;
+
+  for (Index = Property->NextProperty; Index != NoIndex;
+       Index = Next->NextProperty)
+  {
+    Next = &Reader->Properties[Index];
+    if (Next->NameLen == Property->NameLen &&
+        memcmp(Next->Name, Property->Name, Property->NameLen) == 0)
+      return 0;
+  }
+
+  return 1;
+}
+
+
+/**
+ * @brief  Calculate size of raw data of an object in all of the segments
+ * @param  Reader: Pointer to TDMS Reader structure
+ * @param  Object: Index of the object in Reader->Objects
+ * @param  Size: Pointer to save the size (Byte). For strings, it is the size of
+ *               the offsets followed by the characters.
+ *
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_OUT_OF_CAP: The characters of the strings do not fit in one
+ *                            segment (their offsets are 32 bit)
+ */
+static TDMS_Result_t
+TDMS_ReaderObjectSize(TDMS_Reader_t *Reader, uint32_t Object, uint64_t *Size)
+{
+  TDMS_ReaderObject_t *Obj = &Reader->Objects[Object];
+  TDMS_ReaderEntry_t *Entry = NULL;
+  uint32_t Index = 0;
+
+  if (Obj->DataType != TDMS_DataType_String)
+  {
+    *Size = Obj->NumOfValues * dataTypeLength[Obj->DataType];
+    return TDMS_OK;
+  }
+
+  *Size = 0;
+  for (Index = Obj->FirstEntry; Index != NoIndex; Index = Entry->NextEntry)
+  {
+    Entry = &Reader->Entries[Index];
+    *Size += Entry->Size * Reader->Segments[Entry->Segment].NumOfChunks;
+  }
+  if (*Size - 4 * Obj->NumOfValues > 0xFFFFFFFF)
+    return TDMS_OUT_OF_CAP;
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Generate Lead In part and meta data of a defragmented file
+ * @note   All of the objects with their last properties are saved in one
+ *         object list, and each Channel has all of its values in one chunk.
+ *
+ * @param  Reader: Pointer to TDMS Reader structure
+ * @param  Buffer: Pointer to the buffer that data save in
+ * @note   If the buffer address is Null, then function only calculates needed
+ *         buffer size.
+ *
+ * @param  Size: Size of data in buffer (Byte)
+ * @param  RawDataSize: Pointer to save size of raw data of the file (Byte)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_OUT_OF_CAP: A string Channel does not fit in one segment
+ */
+static TDMS_Result_t
+TDMS_ReaderGenDefragHeader(TDMS_Reader_t *Reader, uint8_t *Buffer,
+                           uint64_t *Size, uint64_t *RawDataSize)
+{
+  TDMS_ReaderObject_t *Obj = NULL;
+  TDMS_ReaderProperty_t *Property = NULL;
+  uint64_t DataSize = LeadInPartLen;
+  uint64_t ObjectSize = 0;
+  uint32_t NumOfProperties = 0;
+  uint32_t Index = 0;
+  uint32_t CounterI = 0;
+
+  *RawDataSize = 0;
+  if (Buffer)
+    TDMS_ReaderStore32(&Buffer[DataSize], Reader->NumOfObjects, 0); // Number of objects
+  DataSize += 4;
+
+  for (CounterI = 0; CounterI < Reader->NumOfObjects; CounterI++)
+  {
+    Obj = &Reader->Objects[CounterI];
+    if (TDMS_ReaderObjectSize(Reader, CounterI, &ObjectSize) != TDMS_OK)
+      return TDMS_OUT_OF_CAP;
+    *RawDataSize += ObjectSize;
+
+    if (Buffer)
+    {
+      TDMS_ReaderStore32(&Buffer[DataSize], Obj->PathLen, 0); // Object path
+      memcpy(&Buffer[DataSize + 4], Obj->Path, Obj->PathLen);
+    }
+    DataSize += 4 + Obj->PathLen;
+
+    // raw data index (length of index information, data type, dimension,
+    // number of values and for strings, total size)
+    if (!Obj->NumOfValues)
+    {
+      if (Buffer)
+        TDMS_ReaderStore32(&Buffer[DataSize], NoRawData, 0);
+      DataSize += 4;
+    }
+    else if (Obj->DataType == TDMS_DataType_String)
+    {
+      if (Buffer)
+      {
+        TDMS_ReaderStore32(&Buffer[DataSize], 28, 0);
+        TDMS_ReaderStore32(&Buffer[DataSize + 4], dataTypeBinary[Obj->DataType], 0);
+        TDMS_ReaderStore32(&Buffer[DataSize + 8], 1, 0);
+        TDMS_ReaderStore64(&Buffer[DataSize + 12], Obj->NumOfValues);
+        TDMS_ReaderStore64(&Buffer[DataSize + 20], ObjectSize);
+      }
+      DataSize += 28;
+    }
+    else
+    {
+      if (Buffer)
+      {
+        TDMS_ReaderStore32(&Buffer[DataSize], 20, 0);
+        TDMS_ReaderStore32(&Buffer[DataSize + 4], dataTypeBinary[Obj->DataType], 0);
+        TDMS_ReaderStore32(&Buffer[DataSize + 8], 1, 0);
+        TDMS_ReaderStore64(&Buffer[DataSize + 12], Obj->NumOfValues);
+      }
+      DataSize += 20;
+    }
+
+    // properties that are set more than once are saved with their last value
+    NumOfProperties = 0;
+    for (Index = Obj->FirstProperty; Index != NoIndex;
+         Index = Property->NextProperty)
+    {
+      Property = &Reader->Properties[Index];
+      if (TDMS_ReaderIsLastProperty(Reader, Index))
+        NumOfProperties++;
+    }
+    if (Buffer)
+      TDMS_ReaderStore32(&Buffer[DataSize], NumOfProperties, 0); // Number of properties
+    DataSize += 4;
+
+    for (Index = Obj->FirstProperty; Index != NoIndex;
+         Index = Property->NextProperty)
+    {
+      Property = &Reader->Properties[Index];
+      if (!TDMS_ReaderIsLastProperty(Reader, Index))
+        continue;
+
+      if (Buffer)
+      {
+        TDMS_ReaderStore32(&Buffer[DataSize], Property->NameLen, 0); // Property name
+        memcpy(&Buffer[DataSize + 4], Property->Name, Property->NameLen);
+        TDMS_ReaderStore32(&Buffer[DataSize + 4 + Property->NameLen],
+                           dataTypeBinary[Property->DataType], 0); // Data type
+      }
+      DataSize += 4 + Property->NameLen + 4;
+
+      if (Property->DataType == TDMS_DataType_String)
+      {
+        if (Buffer)
+        {
+          TDMS_ReaderStore32(&Buffer[DataSize], Property->Size, 0);
+          memcpy(&Buffer[DataSize + 4], Property->Value, Property->Size);
+        }
+        DataSize += 4 + Property->Size;
+      }
+      else
+      {
+        if (Buffer)
+          TDMS_ReaderCopyValue(&Buffer[DataSize], Property->Value,
+                               Property->Size, Property->BigEndian);
+        DataSize += Property->Size;
+      }
+    }
+  }
+
+  *Size = DataSize;
+  if (!Buffer)
+    return TDMS_OK;
+
+  // lead in part
+  TDMS_ReaderStore32(&Buffer[0], TAG_TDSm_Num, 1);
+  TDMS_ReaderStore32(&Buffer[4], kTocMetaData | kTocNewObjList |
+                                 (*RawDataSize ? kTocRawData : 0), 0);
+  TDMS_ReaderStore32(&Buffer[8], Version4713, 0);
+  TDMS_ReaderStore64(&Buffer[12], DataSize - LeadInPartLen + *RawDataSize);
+  TDMS_ReaderStore64(&Buffer[20], DataSize - LeadInPartLen);
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Save all of the raw data of a Channel into a sink as one block
+ * @note   Chunks that are in little-endian and not interleaved are passed to
+ *         the sink without copy. The others are converted in the buffer, one
+ *         part at a time.
+ *
+ * @param  Reader: Pointer to TDMS Reader structure
+ * @param  Object: Index of the Channel in Reader->Objects
+ * @param  Sink: Pointer to the sink
+ * @param  Buffer: Pointer to the buffer that values are converted in
+ * @param  BufferSize: Size of the buffer (Byte, at least 16)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - Others: Error of the sink
+ */
+static TDMS_Result_t
+TDMS_ReaderDefragChannel(TDMS_Reader_t *Reader, uint32_t Object,
+                         const TDMS_Sink_t *Sink,
+                         uint8_t *Buffer, uint64_t BufferSize)
+{
+  TDMS_Result_t Result = TDMS_OK;
+  TDMS_ReaderChunk_t Chunk;
+  const uint8_t *Src = NULL;
+  uint64_t ValueLen = dataTypeLength[Reader->Objects[Object].DataType];
+  uint64_t Base = 0;
+  uint64_t Count = 0;
+  uint64_t Len = 0;
+  uint64_t CounterI = 0;
+  uint64_t CounterJ = 0;
+
+  if (Reader->Objects[Object].DataType == TDMS_DataType_String)
+    ValueLen = 4;
+
+  // values (for strings, offsets of the ends of the strings in all chunks)
+  Result = TDMS_ReaderFirstChunk(Reader, Object, &Chunk);
+  while (Result == TDMS_OK)
+  {
+    if (Chunk.DataType != TDMS_DataType_String && !Chunk.BigEndian &&
+        Chunk.Stride == ValueLen)
+    {
+      Result = Sink->Write(Sink->Context, Chunk.Data,
+                           Chunk.NumOfValues * ValueLen);
+      if (Result != TDMS_OK)
+        return Result;
+      Result = TDMS_ReaderNextChunk(Reader, &Chunk);
+      continue;
+    }
+
+    Src = Chunk.Data;
+    for (CounterI = 0; CounterI < Chunk.NumOfValues; CounterI += Count)
+    {
+      Count = Chunk.NumOfValues - CounterI;
+      if (Count > BufferSize / ValueLen)
+        Count = BufferSize / ValueLen;
+
+      for (CounterJ = 0; CounterJ < Count; CounterJ++)
+      {
+        if (Chunk.DataType == TDMS_DataType_String)
+          TDMS_ReaderStore32(&Buffer[CounterJ * 4],
+                             (uint32_t) (Base + TDMS_ReaderLoad32(&Src[CounterJ * 4],
+                                                                  Chunk.BigEndian)), 0);
+        else
+          TDMS_ReaderCopyValue(&Buffer[CounterJ * ValueLen],
+                               &Src[CounterJ * Chunk.Stride],
+                               (uint32_t) ValueLen, Chunk.BigEndian);
+      }
+      Result = Sink->Write(Sink->Context, Buffer, Count * ValueLen);
+      if (Result != TDMS_OK)
+        return Result;
+      Src += Count * (Chunk.DataType == TDMS_DataType_String ? 4 : Chunk.Stride);
+    }
+
+    if (Chunk.DataType == TDMS_DataType_String && Chunk.NumOfValues)
+      Base += TDMS_ReaderLoad32(&Chunk.Data[(Chunk.NumOfValues - 1) * 4],
+                                Chunk.BigEndian);
+    Result = TDMS_ReaderNextChunk(Reader, &Chunk);
+  }
+
+  if (Reader->Objects[Object].DataType != TDMS_DataType_String)
+    return TDMS_OK;
+
+  // characters of the strings of all chunks
+  Result = TDMS_ReaderFirstChunk(Reader, Object, &Chunk);
+  while (Result == TDMS_OK)
+  {
+    Len = Chunk.Size - Chunk.NumOfValues * 4;
+    if (Len)
+    {
+      Result = Sink->Write(Sink->Context, &Chunk.Data[Chunk.NumOfValues * 4],
+                           Len);
+      if (Result != TDMS_OK)
+        return Result;
+    }
+    Result = TDMS_ReaderNextChunk(Reader, &Chunk);
+  }
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Load a file into an allocated buffer
+ * @param  Reader: Pointer to TDMS Reader structure
+ * @param  FilePath: Path of the file
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Opening or reading the file failed
+ */
+static TDMS_Result_t
+TDMS_ReaderLoadFile(TDMS_Reader_t *Reader, const char *FilePath)
+{
+  FILE *File = NULL;
+  uint8_t *Data = NULL;
+  long Size = 0;
+
+  File = fopen(FilePath, "rb");
+  if (!File)
+    return TDMS_IO_ERROR;
+
+  if (fseek(File, 0, SEEK_END) != 0 || (Size = ftell(File)) < 0 ||
+      fseek(File, 0, SEEK_SET) != 0)
+  {
+    fclose(File);
+    return TDMS_IO_ERROR;
+  }
+
+  Data = malloc(Size ? (size_t) Size : 1);
+  if (!Data)
+  {
+    fclose(File);
+    return TDMS_NO_MEMORY;
+  }
+
+  if (fread(Data, 1, (size_t) Size, File) != (size_t) Size)
+  {
+    free(Data);
+    fclose(File);
+    return TDMS_IO_ERROR;
+  }
+  fclose(File);
+
+  Reader->Data = Data;
+  Reader->Size = (uint64_t) Size;
+  Reader->Owner = OwnerAllocated;
+
+  return TDMS_OK;
+}
+
+
+#if (TDMS_CONFIG_POSIX == 1)
+/**
+ * @brief  Map a file into memory
+ * @param  Reader: Pointer to TDMS Reader structure
+ * @param  FilePath: Path of the file
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_IO_ERROR: Opening or mapping the file failed
+ */
+static TDMS_Result_t
+TDMS_ReaderMapFile(TDMS_Reader_t *Reader, const char *FilePath)
+{
+  struct stat Stat;
+  void *Data = NULL;
+  int Fd = -1;
+
+  Fd = open(FilePath, O_RDONLY);
+  if (Fd < 0)
+    return TDMS_IO_ERROR;
+
+  if (fstat(Fd, &Stat) != 0 || Stat.st_size <= 0 ||
+      (uint64_t) Stat.st_size > SIZE_MAX)
+  {
+    close(Fd);
+    return TDMS_IO_ERROR;
+  }
+
+  Data = mmap(NULL, (size_t) Stat.st_size, PROT_READ, MAP_PRIVATE, Fd, 0);
+  close(Fd);
+  if (Data == MAP_FAILED)
+    return TDMS_IO_ERROR;
+
+  Reader->Data = Data;
+  Reader->Size = (uint64_t) Stat.st_size;
+  Reader->Owner = OwnerMapped;
+
+  return TDMS_OK;
+}
+#endif
+
+
+
+/**
+ ==================================================================================
+                            ##### Public Functions #####
+ ==================================================================================
+ */
+
+/**
+ * @brief  Open a TDMS file and build the index of its segments and objects
+ * @note   The file is mapped into memory on POSIX systems and loaded into an
+ *         allocated buffer on the others.
+ *
+ * @param  Reader: Pointer to TDMS Reader structure
+ * @param  FilePath: Path of the file
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: The file is not a valid TDMS file
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Opening or reading the file failed
+ */
+TDMS_Result_t
+TDMS_ReaderOpen(TDMS_Reader_t *Reader, const char *FilePath)
+{
+  TDMS_Result_t Result = TDMS_OK;
+
+  memset(Reader, 0, sizeof(TDMS_Reader_t));
+
+#if (TDMS_CONFIG_POSIX == 1)
+  Result = TDMS_ReaderMapFile(Reader, FilePath);
+  if (Result != TDMS_OK)
+    Result = TDMS_ReaderLoadFile(Reader, FilePath);
+#else
+  Result = TDMS_ReaderLoadFile(Reader, FilePath);
+#endif
+  if (Result != TDMS_OK)
+    return Result;
+
+  Result = TDMS_ReaderBuildIndex(Reader);
+  if (Result != TDMS_OK)
+    TDMS_ReaderClose(Reader);
+
+  return Result;
+}
+
+
+/**
+ * @brief  Build the index of the segments and objects of a TDMS file that is
+ *         already in memory
+ * @note   Data must remain valid until TDMS_ReaderClose is called.
+ *
+ * @param  Reader: Pointer to TDMS Reader structure
+ * @param  Data: Pointer to content of the file
+ * @param  Size: Size of the file (Byte)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Data is not a valid TDMS file
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ */
+TDMS_Result_t
+TDMS_ReaderOpenMemory(TDMS_Reader_t *Reader, const void *Data, uint64_t Size)
+{
+  TDMS_Result_t Result = TDMS_OK;
+
+  memset(Reader, 0, sizeof(TDMS_Reader_t));
+  if (!Data && Size)
+    return TDMS_WRONG_ARG;
+
+  Reader->Data = Data;
+  Reader->Size = Size;
+  Reader->Owner = OwnerUser;
+
+  Result = TDMS_ReaderBuildIndex(Reader);
+  if (Result != TDMS_OK)
+    TDMS_ReaderClose(Reader);
+
+  return Result;
+}
+
+
+/**
+ * @brief  Release the index and the file of a Reader
+ * @param  Reader: Pointer to TDMS Reader structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ */
+TDMS_Result_t
+TDMS_ReaderClose(TDMS_Reader_t *Reader)
+{
+#if (TDMS_CONFIG_POSIX == 1)
+  if (Reader->Owner == OwnerMapped)
+    munmap((void *) Reader->Data, (size_t) Reader->Size);
+#endif
+  if (Reader->Owner == OwnerAllocated)
+    free((void *) Reader->Data);
+
+  free(Reader->Segments);
+  free(Reader->Objects);
+  free(Reader->Entries);
+  free(Reader->Properties);
+  free(Reader->ObjectHash);
+  free(Reader->List);
+  memset(Reader, 0, sizeof(TDMS_Reader_t));
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Find an object by its path
+ * @param  Reader: Pointer to TDMS Reader structure
+ * @param  Path: NULL terminated path of the object (e.g. "/'Group'/'Channel'")
+ * @param  Object: Pointer to save index of the object in Reader->Objects
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: The object does not exist
+ */
+TDMS_Result_t
+TDMS_ReaderFindObject(TDMS_Reader_t *Reader, const char *Path, uint32_t *Object)
+{
+  size_t PathLen = strlen(Path);
+
+  if (PathLen > NoIndex)
+    return TDMS_WRONG_ARG;
+
+  return TDMS_ReaderGetObject(Reader, Path, (uint32_t) PathLen, 0, Object);
+}
+
+
+/**
+ * @brief  Find a property of an object by its name
+ * @note   If the property is set more than once, the last value is returned.
+ *
+ * @param  Reader: Pointer to TDMS Reader structure
+ * @param  Object: Index of the object in Reader->Objects
+ * @param  Name: NULL terminated name of the property
+ * @param  Property: Pointer to save address of the property
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: The property does not exist
+ */
+TDMS_Result_t
+TDMS_ReaderFindProperty(TDMS_Reader_t *Reader, uint32_t Object,
+                        const char *Name, const TDMS_ReaderProperty_t **Property)
+{
+  TDMS_ReaderProperty_t *Prop = NULL;
+  size_t NameLen = strlen(Name);
+  uint32_t Index = 0;
+
+  if (Object >= Reader->NumOfObjects)
+    return TDMS_WRONG_ARG;
+
+  *Property = NULL;
+  for (Index = Reader->Objects[Object].FirstProperty;
+       Index != NoIndex;
+       Index = Prop->NextProperty)
+  {
+    Prop = &Reader->Properties[Index];
+    if (Prop->NameLen == NameLen && memcmp(Prop->Name, Name, NameLen) == 0)
+      *Property = Prop;
+  }
+
+  return *Property ? TDMS_OK : TDMS_WRONG_ARG;
+}
+
+
+/**
+ * @brief  Get first chunk of raw data of a Channel
+ * @param  Reader: Pointer to TDMS Reader structure
+ * @param  Object: Index of the Channel in Reader->Objects
+ * @param  Chunk: Pointer to TDMS Reader Chunk structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_OUT_OF_CAP: The Channel has no raw data
+ */
+TDMS_Result_t
+TDMS_ReaderFirstChunk(TDMS_Reader_t *Reader, uint32_t Object,
+                      TDMS_ReaderChunk_t *Chunk)
+{
+  if (Object >= Reader->NumOfObjects)
+    return TDMS_WRONG_ARG;
+
+  if (Reader->Objects[Object].FirstEntry == NoIndex)
+    return TDMS_OUT_OF_CAP;
+
+  Chunk->Entry = Reader->Objects[Object].FirstEntry;
+  Chunk->Index = 0;
+  TDMS_ReaderFillChunk(Reader, Chunk);
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Get next chunk of raw data of a Channel
+ * @param  Reader: Pointer to TDMS Reader structure
+ * @param  Chunk: Pointer to TDMS Reader Chunk structure that is filled by
+ *                TDMS_ReaderFirstChunk or this function
+ *
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_OUT_OF_CAP: There is no more chunk
+ */
+TDMS_Result_t
+TDMS_ReaderNextChunk(TDMS_Reader_t *Reader, TDMS_ReaderChunk_t *Chunk)
+{
+  TDMS_ReaderEntry_t *Entry = &Reader->Entries[Chunk->Entry];
+
+  Chunk->Index++;
+  if (Chunk->Index >= Reader->Segments[Entry->Segment].NumOfChunks)
+  {
+    if (Entry->NextEntry == NoIndex)
+      return TDMS_OUT_OF_CAP;
+    Chunk->Entry = Entry->NextEntry;
+    Chunk->Index = 0;
+  }
+  TDMS_ReaderFillChunk(Reader, Chunk);
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Save the content of a file in a compact layout: one segment with
+ *         all of the objects and their properties, followed by the raw data of
+ *         each Channel as one contiguous block
+ * @note   Chunks are streamed from the file (mapped on POSIX systems), so
+ *         only the index of the Reader, the meta data and the buffer are held
+ *         in memory. Properties that are set more than once are saved with
+ *         their last value, and the output is little-endian. DAQmx raw data is
+ *         saved as normal raw data of the raw values.
+ *
+ * @param  Reader: Pointer to TDMS Reader structure (opened with
+ *                 TDMS_ReaderOpen or TDMS_ReaderOpenMemory)
+ *
+ * @param  Sink: Pointer to the sink of the new file
+ * @param  IndexSink: Pointer to the sink of the new TDMS index file, or Null
+ * @param  BufferSize: Size of the buffer that interleaved and big-endian
+ *                     values are converted in (Byte, at least 16)
+ *
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_OUT_OF_CAP: Characters of a string Channel are more than
+ *                            4 GB and do not fit in one segment
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - Others: Error of a sink
+ */
+TDMS_Result_t
+TDMS_ReaderDefragment(TDMS_Reader_t *Reader, const TDMS_Sink_t *Sink,
+                      const TDMS_Sink_t *IndexSink, uint64_t BufferSize)
+{
+  TDMS_Result_t Result = TDMS_OK;
+  uint8_t *Header = NULL;
+  uint8_t *Buffer = NULL;
+  uint64_t HeaderSize = 0;
+  uint64_t RawDataSize = 0;
+  uint32_t CounterI = 0;
+
+  if (!Sink || !Sink->Write || BufferSize < 16 || BufferSize > SIZE_MAX)
+    return TDMS_WRONG_ARG;
+
+  Result = TDMS_ReaderGenDefragHeader(Reader, NULL, &HeaderSize, &RawDataSize);
+  if (Result != TDMS_OK)
+    return Result;
+  if (HeaderSize > SIZE_MAX)
+    return TDMS_NO_MEMORY;
+
+  Header = (uint8_t *) malloc((size_t) HeaderSize);
+  Buffer = (uint8_t *) malloc((size_t) BufferSize);
+  if (!Header || !Buffer)
+  {
+    free(Header);
+    free(Buffer);
+    return TDMS_NO_MEMORY;
+  }
+
+  TDMS_ReaderGenDefragHeader(Reader, Header, &HeaderSize, &RawDataSize);
+  Result = Sink->Write(Sink->Context, Header, HeaderSize);
+
+  for (CounterI = 0;
+       CounterI < Reader->NumOfObjects && Result == TDMS_OK;
+       CounterI++)
+  {
+    if (Reader->Objects[CounterI].NumOfValues)
+      Result = TDMS_ReaderDefragChannel(Reader, CounterI, Sink,
+                                        Buffer, BufferSize);
+  }
+
+  // index file has the same Lead In part and meta data with its own tag
+  if (Result == TDMS_OK && IndexSink && IndexSink->Write)
+  {
+    TDMS_ReaderStore32(Header, TAG_TDSh_Num, 1);
+    Result = IndexSink->Write(IndexSink->Context, Header, HeaderSize);
+  }
+
+  free(Header);
+  free(Buffer);
+
+  return Result;
+}
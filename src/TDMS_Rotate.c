@@ -0,0 +1,391 @@
+/**
+ **********************************************************************************
+ * @file   TDMS_Rotate.c
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  File Rotator of rotating TDMS Writers for POSIX systems
+ * @note   A background thread opens the next file before it is needed and
+ *         closes the files that are finished, so switching the files of a
+ *         rotating Writer does not wait for open and close calls.
+ **********************************************************************************
+ */
+
+/* Includes ---------------------------------------------------------------------*/
+#include "TDMS_Rotate.h"
+
+#if (TDMS_CONFIG_POSIX == 1)
+#include "TDMS_Sink.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+/* Private Constants ------------------------------------------------------------*/
+/**
+ * @brief  Max number of finished file descriptors that wait to be closed
+ */
+#define RotateMaxRetired    8
+
+/**
+ * @brief  Length of the number and extension of the file names (with NULL)
+ */
+#define RotateSuffixLen     32
+
+
+/* Private Data Types -----------------------------------------------------------*/
+/**
+ * @brief  Files and state of the background thread
+ */
+typedef struct
+{
+  pthread_mutex_t Lock;
+  pthread_cond_t Cond;
+  pthread_t Thread;
+  uint8_t Closing;
+
+  // Path of the files (prefix and space for number and extension)
+  char *Path;
+  size_t PrefixLen;
+  uint8_t IndexFile;
+
+  // Files of the rotating Writer (-1: not opened)
+  int Fd;
+  int IndexFd;
+
+  // Next file that is opened by the background thread (NextResult is the
+  // error of opening it)
+  int NextFd;
+  int NextIndexFd;
+  uint32_t NextNumber;
+  TDMS_Result_t NextResult;
+
+  // Finished files that are closed by the background thread
+  int Retired[RotateMaxRetired];
+  uint32_t NumOfRetired;
+  TDMS_Result_t CloseResult;
+} TDMS_RotateState_t;
+
+
+
+/**
+ ==================================================================================
+                           ##### Private Functions #####
+ ==================================================================================
+ */
+
+/**
+ * @brief  Generate the path of a file in the Path of the state
+ * @param  State: Pointer to the state
+ * @param  Number: Number of the file
+ * @param  Index: 1 for TDMS index file
+ * @retval None
+ */
+static void
+TDMS_RotatePath(TDMS_RotateState_t *State, uint32_t Number, uint8_t Index)
+{
+  snprintf(&State->Path[State->PrefixLen], RotateSuffixLen, "%06u.%s",
+           (unsigned int) Number, Index ? "tdms_index" : "tdms");
+}
+
+
+/**
+ * @brief  Open a file to write
+ * @param  Path: Path of the file
+ * @retval File descriptor or -1
+ */
+static int
+TDMS_RotateOpen(const char *Path)
+{
+  return open(Path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+}
+
+
+/**
+ * @brief  Background thread that opens the next file and closes the finished
+ *         files
+ * @param  Arg: Pointer to the state
+ * @retval Null
+ */
+static void *
+TDMS_RotateThread(void *Arg)
+{
+  TDMS_RotateState_t *State = (TDMS_RotateState_t *) Arg;
+  uint32_t Number = 0;
+  int Fd = -1;
+  int IndexFd = -1;
+
+  pthread_mutex_lock(&State->Lock);
+  for (;;)
+  {
+    if (State->NumOfRetired)
+    {
+      Fd = State->Retired[--State->NumOfRetired];
+      pthread_cond_broadcast(&State->Cond);
+      pthread_mutex_unlock(&State->Lock);
+      if (close(Fd) != 0)
+        State->CloseResult = TDMS_IO_ERROR;
+      pthread_mutex_lock(&State->Lock);
+      continue;
+    }
+
+    if (State->Closing)
+      break;
+
+    if (State->NextFd < 0 && State->NextResult == TDMS_OK)
+    {
+      Number = State->NextNumber;
+      pthread_mutex_unlock(&State->Lock);
+
+      IndexFd = -1;
+      TDMS_RotatePath(State, Number, 0);
+      Fd = TDMS_RotateOpen(State->Path);
+      if (Fd >= 0 && State->IndexFile)
+      {
+        TDMS_RotatePath(State, Number, 1);
+        IndexFd = TDMS_RotateOpen(State->Path);
+        if (IndexFd < 0)
+        {
+          close(Fd);
+          Fd = -1;
+        }
+      }
+
+      pthread_mutex_lock(&State->Lock);
+      if (Fd < 0)
+        State->NextResult = TDMS_IO_ERROR;
+      State->NextFd = Fd;
+      State->NextIndexFd = IndexFd;
+      pthread_cond_broadcast(&State->Cond);
+      continue;
+    }
+
+    pthread_cond_wait(&State->Cond, &State->Lock);
+  }
+  pthread_mutex_unlock(&State->Lock);
+
+  return NULL;
+}
+
+
+/**
+ * @brief  Pass a finished file descriptor to the background thread
+ * @note   The lock of the state must be held.
+ * @param  State: Pointer to the state
+ * @param  Fd: File descriptor (-1: nothing)
+ * @retval None
+ */
+static void
+TDMS_RotateRetire(TDMS_RotateState_t *State, int Fd)
+{
+  if (Fd < 0)
+    return;
+
+  while (State->NumOfRetired == RotateMaxRetired)
+    pthread_cond_wait(&State->Cond, &State->Lock);
+
+  State->Retired[State->NumOfRetired++] = Fd;
+}
+
+
+/**
+ * @brief  NextFile function of the Rotation of File Rotators
+ * @note   The next file is already opened by the background thread (it waits
+ *         only if the thread is not ready yet).
+ *
+ * @param  Context: Pointer to the state
+ * @param  Sink: Pointer to save the sink of the next file
+ * @param  IndexSink: Pointer to save the sink of the next TDMS index file
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_IO_ERROR: Opening the file failed
+ */
+static TDMS_Result_t
+TDMS_RotateNextFile(void *Context, TDMS_Sink_t *Sink, TDMS_Sink_t *IndexSink)
+{
+  TDMS_RotateState_t *State = (TDMS_RotateState_t *) Context;
+  TDMS_Result_t Result = TDMS_OK;
+
+  pthread_mutex_lock(&State->Lock);
+  while (State->NextFd < 0 && State->NextResult == TDMS_OK)
+    pthread_cond_wait(&State->Cond, &State->Lock);
+
+  Result = State->NextResult;
+  if (Result == TDMS_OK)
+  {
+    TDMS_RotateRetire(State, State->Fd);
+    TDMS_RotateRetire(State, State->IndexFd);
+    State->Fd = State->NextFd;
+    State->IndexFd = State->NextIndexFd;
+    State->NextFd = -1;
+    State->NextIndexFd = -1;
+    State->NextNumber++;
+    pthread_cond_broadcast(&State->Cond);
+  }
+  pthread_mutex_unlock(&State->Lock);
+
+  if (Result != TDMS_OK)
+    return Result;
+
+  TDMS_InitFdSink(Sink, State->Fd);
+  if (State->IndexFd >= 0)
+    TDMS_InitFdSink(IndexSink, State->IndexFd);
+  else
+  {
+    IndexSink->Context = NULL;
+    IndexSink->Write = NULL;
+    IndexSink->Writev = NULL;
+    IndexSink->WriteAt = NULL;
+  }
+
+  return TDMS_OK;
+}
+
+
+
+/**
+ ==================================================================================
+                            ##### Public Functions #####
+ ==================================================================================
+ */
+
+/**
+ * @brief  Initialize File Rotator object structure and start its background
+ *         thread
+ * @note   Files are named PathPrefix followed by a 6 digit number of the file
+ *         (from 000000) and ".tdms" (".tdms_index" for TDMS index files). Then
+ *         the Rotation of the File Rotator is passed to
+ *         TDMS_InitRotatingWriter.
+ *
+ * @param  Rotator: Pointer to TDMS File Rotator object structure
+ * @param  PathPrefix: Path of the files without number and extension (copied)
+ * @param  IndexFile: 1 to generate TDMS index files too
+ * @param  MaxSize: Size that a new file is started after it (Byte, 0: disabled)
+ * @param  MaxDuration: Time that a new file is started after it (ms, 0:
+ *                      disabled)
+ *
+ * @param  Builder: Pointer to TDMS Property Builder object structure that
+ *                  Properties of the first part of the files are in (or Null)
+ *
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Starting the thread failed
+ */
+TDMS_Result_t
+TDMS_InitFileRotator(TDMS_FileRotator_t *Rotator, const char *PathPrefix,
+                     uint8_t IndexFile, uint64_t MaxSize, uint64_t MaxDuration,
+                     TDMS_PropertyBuilder_t *Builder)
+{
+  TDMS_RotateState_t *State = NULL;
+  size_t PrefixLen = 0;
+
+  if (!PathPrefix)
+    return TDMS_WRONG_ARG;
+
+  State = (TDMS_RotateState_t *) calloc(1, sizeof(TDMS_RotateState_t));
+  if (!State)
+    return TDMS_NO_MEMORY;
+
+  PrefixLen = strlen(PathPrefix);
+  State->Path = (char *) malloc(PrefixLen + RotateSuffixLen);
+  if (!State->Path)
+  {
+    free(State);
+    return TDMS_NO_MEMORY;
+  }
+  memcpy(State->Path, PathPrefix, PrefixLen);
+  State->PrefixLen = PrefixLen;
+  State->IndexFile = IndexFile ? 1 : 0;
+  State->Fd = -1;
+  State->IndexFd = -1;
+  State->NextFd = -1;
+  State->NextIndexFd = -1;
+  State->NextNumber = 0;
+  State->NextResult = TDMS_OK;
+  State->NumOfRetired = 0;
+  State->CloseResult = TDMS_OK;
+  State->Closing = 0;
+  pthread_mutex_init(&State->Lock, NULL);
+  pthread_cond_init(&State->Cond, NULL);
+
+  Rotator->Rotation.MaxSize = MaxSize;
+  Rotator->Rotation.MaxDuration = MaxDuration;
+  Rotator->Rotation.GetTime = NULL;
+  Rotator->Rotation.NextFile = TDMS_RotateNextFile;
+  Rotator->Rotation.Context = (void *) State;
+  Rotator->Rotation.Builder = Builder;
+  Rotator->State = (void *) State;
+
+  // the first file is opened by the thread too
+  if (pthread_create(&State->Thread, NULL, TDMS_RotateThread, State) != 0)
+  {
+    pthread_cond_destroy(&State->Cond);
+    pthread_mutex_destroy(&State->Lock);
+    free(State->Path);
+    free(State);
+    Rotator->State = NULL;
+    return TDMS_IO_ERROR;
+  }
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Stop the background thread of File Rotator and close all of the files
+ * @note   Must be called after the last segment is saved by the rotating
+ *         Writer. The next file that is opened but not used is removed.
+ *
+ * @param  Rotator: Pointer to TDMS File Rotator object structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_IO_ERROR: Closing a file failed
+ */
+TDMS_Result_t
+TDMS_DeInitFileRotator(TDMS_FileRotator_t *Rotator)
+{
+  TDMS_RotateState_t *State = (TDMS_RotateState_t *) Rotator->State;
+  TDMS_Result_t Result = TDMS_OK;
+
+  if (!State)
+    return TDMS_OK;
+
+  pthread_mutex_lock(&State->Lock);
+  State->Closing = 1;
+  pthread_cond_broadcast(&State->Cond);
+  pthread_mutex_unlock(&State->Lock);
+  pthread_join(State->Thread, NULL);
+
+  Result = State->CloseResult;
+  if (State->Fd >= 0 && close(State->Fd) != 0)
+    Result = TDMS_IO_ERROR;
+  if (State->IndexFd >= 0 && close(State->IndexFd) != 0)
+    Result = TDMS_IO_ERROR;
+
+  if (State->NextFd >= 0)
+  {
+    close(State->NextFd);
+    TDMS_RotatePath(State, State->NextNumber, 0);
+    unlink(State->Path);
+  }
+  if (State->NextIndexFd >= 0)
+  {
+    close(State->NextIndexFd);
+    TDMS_RotatePath(State, State->NextNumber, 1);
+    unlink(State->Path);
+  }
+
+  pthread_cond_destroy(&State->Cond);
+  pthread_mutex_destroy(&State->Lock);
+  free(State->Path);
+  free(State);
+  Rotator->State = NULL;
+
+  return Result;
+}
+
+#endif //! TDMS_CONFIG_POSIX
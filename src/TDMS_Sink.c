@@ -0,0 +1,609 @@
+/**
+ **********************************************************************************
+ * @file   TDMS_Sink.c
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  Sinks of TDMS Writer for POSIX file descriptors
+ **********************************************************************************
+ */
+
+/* Includes ---------------------------------------------------------------------*/
+// O_DIRECT and fallocate are GNU extensions
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+#include "TDMS_Sink.h"
+
+#if (TDMS_CONFIG_POSIX == 1)
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+
+/* Private Constants ------------------------------------------------------------*/
+/**
+ * @brief  Max number of elements passed to each writev call
+ */
+#define WritevMaxIoVec    64
+
+/**
+ * @brief  Alignment of the writes of Direct Files (Byte). It is the logical
+ *         block size of common disks and the page size.
+ */
+#define DirectAlign       4096
+
+
+/**
+ ==================================================================================
+                           ##### Private Functions #####
+ ==================================================================================
+ */
+
+/**
+ * @brief  Sink write function of file descriptor sinks
+ * @param  Context: File descriptor
+ * @param  Data: Pointer to data
+ * @param  Size: Size of data (Byte)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_IO_ERROR: Writing into the file failed
+ */
+static TDMS_Result_t
+TDMS_FdSinkWrite(void *Context, const uint8_t *Data, uint64_t Size)
+{
+  int Fd = (int) (intptr_t) Context;
+  ssize_t Written = 0;
+
+  while (Size)
+  {
+    Written = write(Fd, Data, Size);
+    if (Written < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      return TDMS_IO_ERROR;
+    }
+
+    Data += Written;
+    Size -= Written;
+  }
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Sink scatter-gather write function of file descriptor sinks
+ * @param  Context: File descriptor
+ * @param  IoVec: Pointer to array of elements
+ * @param  NumOfIoVec: Number of elements
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_IO_ERROR: Writing into the file failed
+ */
+static TDMS_Result_t
+TDMS_FdSinkWritev(void *Context, const TDMS_IoVec_t *IoVec, uint32_t NumOfIoVec)
+{
+  int Fd = (int) (intptr_t) Context;
+  struct iovec Vec[WritevMaxIoVec];
+  uint32_t NumOfVec = 0;
+  uint32_t CounterI = 0;
+  ssize_t Written = 0;
+
+  while (NumOfIoVec)
+  {
+    NumOfVec = (NumOfIoVec < WritevMaxIoVec) ? NumOfIoVec : WritevMaxIoVec;
+    for (CounterI = 0; CounterI < NumOfVec; CounterI++)
+    {
+      Vec[CounterI].iov_base = (void *) IoVec[CounterI].Base;
+      Vec[CounterI].iov_len = IoVec[CounterI].Len;
+    }
+    IoVec += NumOfVec;
+    NumOfIoVec -= NumOfVec;
+
+    CounterI = 0;
+    while (CounterI < NumOfVec)
+    {
+      Written = writev(Fd, &Vec[CounterI], NumOfVec - CounterI);
+      if (Written < 0)
+      {
+        if (errno == EINTR)
+          continue;
+        return TDMS_IO_ERROR;
+      }
+
+      // skip the elements that are completely written and continue from the
+      // first byte of a partially written one
+      while (CounterI < NumOfVec && (size_t) Written >= Vec[CounterI].iov_len)
+      {
+        Written -= Vec[CounterI].iov_len;
+        CounterI++;
+      }
+      if (CounterI < NumOfVec)
+      {
+        Vec[CounterI].iov_base = (uint8_t *) Vec[CounterI].iov_base + Written;
+        Vec[CounterI].iov_len -= Written;
+      }
+    }
+  }
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Write data at an offset of a file
+ * @param  Fd: File descriptor
+ * @param  Data: Pointer to data
+ * @param  Size: Size of data (Byte)
+ * @param  Offset: Offset in the file (Byte)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_IO_ERROR: Writing into the file failed
+ */
+static TDMS_Result_t
+TDMS_FdPwrite(int Fd, const uint8_t *Data, uint64_t Size, uint64_t Offset)
+{
+  ssize_t Written = 0;
+
+  while (Size)
+  {
+    Written = pwrite(Fd, Data, Size, (off_t) Offset);
+    if (Written < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      return TDMS_IO_ERROR;
+    }
+    if (Written == 0)
+      return TDMS_IO_ERROR;
+
+    Data += Written;
+    Size -= Written;
+    Offset += Written;
+  }
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Sink write at offset function of file descriptor sinks
+ * @param  Context: File descriptor
+ * @param  Data: Pointer to data
+ * @param  Size: Size of data (Byte)
+ * @param  Offset: Offset in the file (Byte)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_IO_ERROR: Writing into the file failed
+ */
+static TDMS_Result_t
+TDMS_FdSinkWriteAt(void *Context, const uint8_t *Data, uint64_t Size,
+                   uint64_t Offset)
+{
+  return TDMS_FdPwrite((int) (intptr_t) Context, Data, Size, Offset);
+}
+
+
+/**
+ * @brief  Preallocate space of a Direct File up to an offset
+ * @note   The size of the file is not changed, so a file that is not closed
+ *         (e.g. after a crash) has no zeros after its last segment.
+ * 
+ * @param  File: Pointer to TDMS Direct File structure
+ * @param  End: Offset that the space before it is needed (Byte)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_IO_ERROR: Disk is full
+ */
+static TDMS_Result_t
+TDMS_DirectFileReserve(TDMS_DirectFile_t *File, uint64_t End)
+{
+  uint64_t Allocated = File->Allocated;
+
+  if (!File->Prealloc || End <= Allocated)
+    return TDMS_OK;
+
+  while (Allocated < End)
+    Allocated += File->Prealloc;
+
+#if defined(FALLOC_FL_KEEP_SIZE)
+  if (fallocate(File->Fd, FALLOC_FL_KEEP_SIZE, (off_t) File->Allocated,
+                (off_t) (Allocated - File->Allocated)) != 0)
+  {
+    if (errno == ENOSPC)
+      return TDMS_IO_ERROR;
+    // file system does not support it
+    File->Prealloc = 0;
+    return TDMS_OK;
+  }
+#else
+  File->Prealloc = 0;
+  return TDMS_OK;
+#endif
+
+  File->Allocated = Allocated;
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Write aligned data of a Direct File at the offset of its staging
+ *         buffer
+ * @param  File: Pointer to TDMS Direct File structure
+ * @param  Data: Pointer to data (aligned)
+ * @param  Size: Size of data (Byte, multiple of alignment)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_IO_ERROR: Writing into the file failed
+ */
+static TDMS_Result_t
+TDMS_DirectFileWriteBlocks(TDMS_DirectFile_t *File,
+                           const uint8_t *Data, uint64_t Size)
+{
+  TDMS_Result_t Result = TDMS_OK;
+
+  Result = TDMS_DirectFileReserve(File, File->Offset + Size);
+  if (Result != TDMS_OK)
+    return Result;
+
+  Result = TDMS_FdPwrite(File->Fd, Data, Size, File->Offset);
+  if (Result != TDMS_OK)
+    return Result;
+
+  File->Offset += Size;
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Append data to a Direct File
+ * @note   Data is copied into the staging buffer and full buffers are written.
+ *         Large aligned data is written without copy when the buffer is empty.
+ * 
+ * @param  File: Pointer to TDMS Direct File structure
+ * @param  Data: Pointer to data
+ * @param  Size: Size of data (Byte)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_IO_ERROR: Writing into the file failed
+ */
+static TDMS_Result_t
+TDMS_DirectFileAppend(TDMS_DirectFile_t *File, const uint8_t *Data, uint64_t Size)
+{
+  TDMS_Result_t Result = TDMS_OK;
+  uint64_t Len = 0;
+
+  while (Size)
+  {
+    if (!File->BufferLen && Size >= File->BufferSize &&
+        ((uintptr_t) Data % File->Align) == 0)
+    {
+      Len = Size - (Size % File->Align);
+      Result = TDMS_DirectFileWriteBlocks(File, Data, Len);
+      if (Result != TDMS_OK)
+        return Result;
+
+      Data += Len;
+      Size -= Len;
+      continue;
+    }
+
+    Len = File->BufferSize - File->BufferLen;
+    if (Len > Size)
+      Len = Size;
+    memcpy(&File->Buffer[File->BufferLen], Data, (size_t) Len);
+    File->BufferLen += Len;
+    Data += Len;
+    Size -= Len;
+
+    if (File->BufferLen == File->BufferSize)
+    {
+      Result = TDMS_DirectFileWriteBlocks(File, File->Buffer, File->BufferSize);
+      if (Result != TDMS_OK)
+        return Result;
+      File->BufferLen = 0;
+    }
+  }
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Sink write function of Direct File sinks
+ * @param  Context: Pointer to TDMS Direct File structure
+ * @param  Data: Pointer to data
+ * @param  Size: Size of data (Byte)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_IO_ERROR: Writing into the file failed
+ */
+static TDMS_Result_t
+TDMS_DirectSinkWrite(void *Context, const uint8_t *Data, uint64_t Size)
+{
+  return TDMS_DirectFileAppend((TDMS_DirectFile_t *) Context, Data, Size);
+}
+
+
+/**
+ * @brief  Sink scatter-gather write function of Direct File sinks
+ * @param  Context: Pointer to TDMS Direct File structure
+ * @param  IoVec: Pointer to array of elements
+ * @param  NumOfIoVec: Number of elements
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_IO_ERROR: Writing into the file failed
+ */
+static TDMS_Result_t
+TDMS_DirectSinkWritev(void *Context,
+                      const TDMS_IoVec_t *IoVec, uint32_t NumOfIoVec)
+{
+  TDMS_Result_t Result = TDMS_OK;
+  uint32_t CounterI = 0;
+
+  for (CounterI = 0; CounterI < NumOfIoVec; CounterI++)
+  {
+    Result = TDMS_DirectFileAppend((TDMS_DirectFile_t *) Context,
+                                   (const uint8_t *) IoVec[CounterI].Base,
+                                   IoVec[CounterI].Len);
+    if (Result != TDMS_OK)
+      return Result;
+  }
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Sink write at offset function of Direct File sinks
+ * @note   Data in the staging buffer is changed in place. Blocks that are
+ *         already written are read, changed and written again.
+ * 
+ * @param  Context: Pointer to TDMS Direct File structure
+ * @param  Data: Pointer to data
+ * @param  Size: Size of data (Byte)
+ * @param  Offset: Offset in the file (Byte)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Offset is after the end of the file
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Reading or writing the file failed
+ */
+static TDMS_Result_t
+TDMS_DirectSinkWriteAt(void *Context, const uint8_t *Data, uint64_t Size,
+                       uint64_t Offset)
+{
+  TDMS_DirectFile_t *File = (TDMS_DirectFile_t *) Context;
+  TDMS_Result_t Result = TDMS_OK;
+  void *Block = NULL;
+  uint64_t BlockOffset = 0;
+  uint64_t Start = 0;
+  uint64_t Len = 0;
+  ssize_t Read = 0;
+
+  if (Offset + Size > File->Offset + File->BufferLen)
+    return TDMS_WRONG_ARG;
+
+  // the part in the staging buffer
+  if (Offset + Size > File->Offset)
+  {
+    Start = (Offset > File->Offset) ? Offset : File->Offset;
+    memcpy(&File->Buffer[Start - File->Offset], &Data[Start - Offset],
+           (size_t) (Offset + Size - Start));
+    Size = Start - Offset;
+  }
+  if (!Size)
+    return TDMS_OK;
+
+  // the part in the blocks that are written
+  if (posix_memalign(&Block, File->Align, File->Align) != 0)
+    return TDMS_NO_MEMORY;
+
+  while (Size)
+  {
+    BlockOffset = Offset & ~((uint64_t) File->Align - 1);
+    do
+      Read = pread(File->Fd, Block, File->Align, (off_t) BlockOffset);
+    while (Read < 0 && errno == EINTR);
+    if (Read != (ssize_t) File->Align)
+    {
+      Result = TDMS_IO_ERROR;
+      break;
+    }
+
+    Len = BlockOffset + File->Align - Offset;
+    if (Len > Size)
+      Len = Size;
+    memcpy((uint8_t *) Block + (Offset - BlockOffset), Data, (size_t) Len);
+    Result = TDMS_FdPwrite(File->Fd, (const uint8_t *) Block, File->Align,
+                           BlockOffset);
+    if (Result != TDMS_OK)
+      break;
+
+    Data += Len;
+    Size -= Len;
+    Offset += Len;
+  }
+
+  free(Block);
+
+  return Result;
+}
+
+
+
+/**
+ ==================================================================================
+                            ##### Public Functions #####                           
+ ==================================================================================
+ */
+
+/**
+ * @brief  Initialize a sink that saves data into a file descriptor
+ * @note   The sink supports scatter-gather write (writev), so a Writer that uses
+ *         it does not copy raw data of Channels. It supports WriteAt (pwrite)
+ *         too.
+ * 
+ * @param  Sink: Pointer to TDMS Sink structure
+ * @param  Fd: File descriptor (e.g. returned by open)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+TDMS_Result_t
+TDMS_InitFdSink(TDMS_Sink_t *Sink, int Fd)
+{
+  if (Fd < 0)
+    return TDMS_WRONG_ARG;
+
+  Sink->Context = (void *) (intptr_t) Fd;
+  Sink->Write = TDMS_FdSinkWrite;
+  Sink->Writev = TDMS_FdSinkWritev;
+  Sink->WriteAt = TDMS_FdSinkWriteAt;
+
+  return TDMS_OK;
+}
+
+
+
+/**
+ * @brief  Open (create or truncate) a file that is saved by aligned direct
+ *         writes
+ * @note   Data is staged in an aligned buffer and saved in full blocks with
+ *         O_DIRECT, so it does not pass through page cache and writeback does
+ *         not stall the Writer. Space is preallocated (fallocate) before the
+ *         blocks are written.
+ * 
+ * @param  File: Pointer to TDMS Direct File structure
+ * @param  Path: Path of the file
+ * @param  BufferSize: Size of the staging buffer (Byte). It is rounded up to
+ *                     the alignment of writes (4 KB).
+ * 
+ * @param  Prealloc: Size of each preallocation (Byte, 0: no preallocation)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Opening the file failed
+ */
+TDMS_Result_t
+TDMS_OpenDirectFile(TDMS_DirectFile_t *File, const char *Path,
+                    uint64_t BufferSize, uint64_t Prealloc)
+{
+  void *Buffer = NULL;
+
+  if (!Path)
+    return TDMS_WRONG_ARG;
+
+  File->Align = DirectAlign;
+  BufferSize = (BufferSize + DirectAlign - 1) & ~((uint64_t) DirectAlign - 1);
+  if (!BufferSize)
+    BufferSize = DirectAlign;
+  Prealloc = (Prealloc + DirectAlign - 1) & ~((uint64_t) DirectAlign - 1);
+  if (BufferSize > SIZE_MAX)
+    return TDMS_NO_MEMORY;
+
+  if (posix_memalign(&Buffer, DirectAlign, (size_t) BufferSize) != 0)
+    return TDMS_NO_MEMORY;
+
+  File->Direct = 0;
+  File->Fd = -1;
+#if defined(O_DIRECT)
+  File->Fd = open(Path, O_RDWR | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+  if (File->Fd >= 0)
+    File->Direct = 1;
+#endif
+  if (File->Fd < 0)
+    File->Fd = open(Path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (File->Fd < 0)
+  {
+    free(Buffer);
+    return TDMS_IO_ERROR;
+  }
+
+  File->Buffer = (uint8_t *) Buffer;
+  File->BufferSize = BufferSize;
+  File->BufferLen = 0;
+  File->Offset = 0;
+  File->Allocated = 0;
+  File->Prealloc = Prealloc;
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Initialize a sink that saves data into a Direct File
+ * @note   The sink supports scatter-gather write, so raw data of Channels is
+ *         copied only once (into the staging buffer). It supports WriteAt too.
+ * 
+ * @param  Sink: Pointer to TDMS Sink structure
+ * @param  File: Pointer to opened TDMS Direct File structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+TDMS_Result_t
+TDMS_InitDirectSink(TDMS_Sink_t *Sink, TDMS_DirectFile_t *File)
+{
+  if (!File || File->Fd < 0)
+    return TDMS_WRONG_ARG;
+
+  Sink->Context = (void *) File;
+  Sink->Write = TDMS_DirectSinkWrite;
+  Sink->Writev = TDMS_DirectSinkWritev;
+  Sink->WriteAt = TDMS_DirectSinkWriteAt;
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Save the rest of a Direct File and close it
+ * @note   The last partial block is written padded to the alignment, then the
+ *         file is truncated to its real size (the padding and the preallocated
+ *         space that is not used are released).
+ * 
+ * @param  File: Pointer to TDMS Direct File structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_IO_ERROR: Writing or closing the file failed
+ */
+TDMS_Result_t
+TDMS_CloseDirectFile(TDMS_DirectFile_t *File)
+{
+  TDMS_Result_t Result = TDMS_OK;
+  uint64_t Size = File->Offset + File->BufferLen;
+  uint64_t Len = 0;
+
+  if (File->Fd < 0)
+    return TDMS_OK;
+
+  if (File->BufferLen)
+  {
+    Len = (File->BufferLen + File->Align - 1) & ~((uint64_t) File->Align - 1);
+    memset(&File->Buffer[File->BufferLen], 0, (size_t) (Len - File->BufferLen));
+    Result = TDMS_DirectFileWriteBlocks(File, File->Buffer, Len);
+    File->BufferLen = 0;
+  }
+
+  if (ftruncate(File->Fd, (off_t) Size) != 0)
+    Result = TDMS_IO_ERROR;
+  if (close(File->Fd) != 0)
+    Result = TDMS_IO_ERROR;
+  File->Fd = -1;
+
+  free(File->Buffer);
+  File->Buffer = NULL;
+  File->BufferSize = 0;
+
+  return Result;
+}
+
+#endif //! TDMS_CONFIG_POSIX
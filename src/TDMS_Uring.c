@@ -0,0 +1,751 @@
+/**
+ **********************************************************************************
+ * @file   TDMS_Uring.c
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  io_uring sink of TDMS Writer for Linux systems
+ * @note   Segments are copied into a set of buffers and full buffers are
+ *         written by io_uring while the Writer generates the next segments.
+ *         Buffers are reused when their writes are completed. If io_uring is
+ *         not available, full buffers are written by pwrite.
+ **********************************************************************************
+ */
+
+/* Includes ---------------------------------------------------------------------*/
+// pwrite, syscall and MAP_POPULATE are not in ISO C
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+#include "TDMS_Uring.h"
+
+#if (TDMS_CONFIG_POSIX == 1)
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+// io_uring is used by its system calls (no liburing)
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define UringSupported    1
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#endif
+#endif
+
+#ifndef UringSupported
+#define UringSupported    0
+#endif
+
+
+/* Private Constants ------------------------------------------------------------*/
+/**
+ * @brief  Number of operations of the probe of io_uring
+ */
+#define UringProbeOps     256
+
+
+/* Private Data Types -----------------------------------------------------------*/
+/**
+ * @brief  Ring and buffers of io_uring File
+ */
+typedef struct
+{
+#if (UringSupported == 1)
+  // 1 if the ring is set up (it is kept until TDMS_DeInitUringFile, even if
+  // io_uring is not used anymore)
+  uint8_t Ring;
+  int RingFd;
+  uint8_t *SqRing;
+  size_t SqRingSize;
+  uint8_t *CqRing;
+  size_t CqRingSize;
+  struct io_uring_sqe *Sqes;
+  size_t SqesSize;
+  uint32_t *SqTail;
+  uint32_t *SqMask;
+  uint32_t *SqArray;
+  uint32_t *CqHead;
+  uint32_t *CqTail;
+  uint32_t *CqMask;
+  struct io_uring_cqe *Cqes;
+  // Buffers that were in flight when waiting for the ring failed (the kernel
+  // may still read them, so they are released with the ring)
+  uint8_t *StaleBuffers;
+#endif
+
+  // Buffers (NumOfBuffers * BufferSize), data in each buffer, its offset in
+  // the file and if its write is not completed yet
+  uint8_t *Buffers;
+  uint64_t *Len;
+  uint64_t *FileOffset;
+  uint8_t *InFlight;
+  uint32_t NumOfInFlight;
+  // Buffer that data is copied into
+  uint32_t Current;
+  // First error of the writes
+  TDMS_Result_t Result;
+} TDMS_UringState_t;
+
+
+
+/**
+ ==================================================================================
+                           ##### Private Functions #####
+ ==================================================================================
+ */
+
+/**
+ * @brief  Write data at an offset of a file
+ * @param  Fd: File descriptor
+ * @param  Data: Pointer to data
+ * @param  Size: Size of data (Byte)
+ * @param  Offset: Offset in the file (Byte)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_IO_ERROR: Writing into the file failed
+ */
+static TDMS_Result_t
+TDMS_UringPwrite(int Fd, const uint8_t *Data, uint64_t Size, uint64_t Offset)
+{
+  ssize_t Written = 0;
+
+  while (Size)
+  {
+    Written = pwrite(Fd, Data, Size, (off_t) Offset);
+    if (Written < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      return TDMS_IO_ERROR;
+    }
+    if (Written == 0)
+      return TDMS_IO_ERROR;
+
+    Data += Written;
+    Size -= Written;
+    Offset += Written;
+  }
+
+  return TDMS_OK;
+}
+
+
+#if (UringSupported == 1)
+/**
+ * @brief  Check that a ring supports IORING_OP_WRITE
+ * @note   Kernels 5.1 to 5.5 have io_uring without IORING_OP_WRITE (and without
+ *         IORING_REGISTER_PROBE).
+ *
+ * @param  RingFd: File descriptor of the ring
+ * @retval 1: write is supported, 0: it is not supported
+ */
+static uint8_t
+TDMS_UringProbeWrite(int RingFd)
+{
+  struct io_uring_probe *Probe = NULL;
+  uint8_t Supported = 0;
+
+  Probe = (struct io_uring_probe *)
+          calloc(1, sizeof(struct io_uring_probe) +
+                    UringProbeOps * sizeof(struct io_uring_probe_op));
+  if (!Probe)
+    return 0;
+
+  if (syscall(__NR_io_uring_register, RingFd, IORING_REGISTER_PROBE,
+              Probe, UringProbeOps) == 0 &&
+      Probe->last_op >= IORING_OP_WRITE &&
+      (Probe->ops[IORING_OP_WRITE].flags & IO_URING_OP_SUPPORTED))
+    Supported = 1;
+
+  free(Probe);
+
+  return Supported;
+}
+
+
+/**
+ * @brief  Set up the ring of io_uring File
+ * @param  State: Pointer to the state
+ * @param  Entries: Number of entries of the ring
+ * @retval 1: ring is ready, 0: io_uring is not available
+ */
+static uint8_t
+TDMS_UringSetup(TDMS_UringState_t *State, uint32_t Entries)
+{
+  struct io_uring_params Params;
+  int RingFd = -1;
+  void *Map = NULL;
+
+  memset(&Params, 0, sizeof(Params));
+  RingFd = (int) syscall(__NR_io_uring_setup, Entries, &Params);
+  if (RingFd < 0)
+    return 0;
+  if (!TDMS_UringProbeWrite(RingFd))
+  {
+    close(RingFd);
+    return 0;
+  }
+
+  State->RingFd = RingFd;
+  State->SqRingSize = Params.sq_off.array + Params.sq_entries * sizeof(uint32_t);
+  State->CqRingSize = Params.cq_off.cqes +
+                      Params.cq_entries * sizeof(struct io_uring_cqe);
+  if (Params.features & IORING_FEAT_SINGLE_MMAP)
+  {
+    if (State->CqRingSize > State->SqRingSize)
+      State->SqRingSize = State->CqRingSize;
+    State->CqRingSize = State->SqRingSize;
+  }
+
+  Map = mmap(NULL, State->SqRingSize, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_POPULATE, RingFd, IORING_OFF_SQ_RING);
+  if (Map == MAP_FAILED)
+  {
+    close(RingFd);
+    return 0;
+  }
+  State->SqRing = (uint8_t *) Map;
+
+  State->CqRing = State->SqRing;
+  if (!(Params.features & IORING_FEAT_SINGLE_MMAP))
+  {
+    Map = mmap(NULL, State->CqRingSize, PROT_READ | PROT_WRITE,
+               MAP_SHARED | MAP_POPULATE, RingFd, IORING_OFF_CQ_RING);
+    if (Map == MAP_FAILED)
+    {
+      munmap(State->SqRing, State->SqRingSize);
+      close(RingFd);
+      return 0;
+    }
+    State->CqRing = (uint8_t *) Map;
+  }
+
+  State->SqesSize = Params.sq_entries * sizeof(struct io_uring_sqe);
+  Map = mmap(NULL, State->SqesSize, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_POPULATE, RingFd, IORING_OFF_SQES);
+  if (Map == MAP_FAILED)
+  {
+    if (State->CqRing != State->SqRing)
+      munmap(State->CqRing, State->CqRingSize);
+    munmap(State->SqRing, State->SqRingSize);
+    close(RingFd);
+    return 0;
+  }
+  State->Sqes = (struct io_uring_sqe *) Map;
+
+  State->SqTail = (uint32_t *) &State->SqRing[Params.sq_off.tail];
+  State->SqMask = (uint32_t *) &State->SqRing[Params.sq_off.ring_mask];
+  State->SqArray = (uint32_t *) &State->SqRing[Params.sq_off.array];
+  State->CqHead = (uint32_t *) &State->CqRing[Params.cq_off.head];
+  State->CqTail = (uint32_t *) &State->CqRing[Params.cq_off.tail];
+  State->CqMask = (uint32_t *) &State->CqRing[Params.cq_off.ring_mask];
+  State->Cqes = (struct io_uring_cqe *) &State->CqRing[Params.cq_off.cqes];
+  State->Ring = 1;
+
+  return 1;
+}
+
+
+/**
+ * @brief  Release the ring of io_uring File
+ * @param  State: Pointer to the state
+ * @retval None
+ */
+static void
+TDMS_UringRelease(TDMS_UringState_t *State)
+{
+  munmap(State->Sqes, State->SqesSize);
+  if (State->CqRing != State->SqRing)
+    munmap(State->CqRing, State->CqRingSize);
+  munmap(State->SqRing, State->SqRingSize);
+  close(State->RingFd);
+}
+
+
+/**
+ * @brief  Submit the write of a buffer to the ring
+ * @note   The ring has an entry for each buffer, so it is never full.
+ *
+ * @param  File: Pointer to TDMS io_uring File structure
+ * @param  Index: Index of the buffer
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_IO_ERROR: Submission failed
+ */
+static TDMS_Result_t
+TDMS_UringSubmit(TDMS_UringFile_t *File, uint32_t Index)
+{
+  TDMS_UringState_t *State = (TDMS_UringState_t *) File->State;
+  struct io_uring_sqe *Sqe = NULL;
+  uint32_t Tail = *State->SqTail;
+  uint32_t Slot = Tail & *State->SqMask;
+  long Submitted = 0;
+
+  Sqe = &State->Sqes[Slot];
+  memset(Sqe, 0, sizeof(struct io_uring_sqe));
+  Sqe->opcode = IORING_OP_WRITE;
+  Sqe->fd = File->Fd;
+  Sqe->addr = (uint64_t) (uintptr_t) &State->Buffers[Index * File->BufferSize];
+  Sqe->len = (uint32_t) State->Len[Index];
+  Sqe->off = State->FileOffset[Index];
+  Sqe->user_data = Index;
+  State->SqArray[Slot] = Slot;
+  __atomic_store_n(State->SqTail, Tail + 1, __ATOMIC_RELEASE);
+
+  do
+    Submitted = syscall(__NR_io_uring_enter, State->RingFd, 1, 0, 0, NULL, 0);
+  while (Submitted < 0 && errno == EINTR);
+
+  // the entry is not consumed, so it is removed from the ring (it must not be
+  // submitted by a later call)
+  if (Submitted != 1)
+  {
+    __atomic_store_n(State->SqTail, Tail, __ATOMIC_RELEASE);
+    return TDMS_IO_ERROR;
+  }
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Handle the completed writes of the ring
+ * @note   If waiting for the ring fails, the ring is not used anymore and the
+ *         buffers in flight are written again by pwrite. Then new buffers are
+ *         used, so the writes of the ring that are not completed yet save the
+ *         same data.
+ *
+ * @param  File: Pointer to TDMS io_uring File structure
+ * @param  Wait: 1 to wait for at least one completion
+ * @retval None
+ */
+static void
+TDMS_UringReap(TDMS_UringFile_t *File, uint8_t Wait)
+{
+  TDMS_UringState_t *State = (TDMS_UringState_t *) File->State;
+  struct io_uring_cqe *Cqe = NULL;
+  uint32_t Head = *State->CqHead;
+  uint32_t Index = 0;
+  uint64_t Done = 0;
+  uint8_t *Buffers = NULL;
+  uint8_t Failed = 0;
+  long Ret = 0;
+
+  for (;;)
+  {
+    while (Head != __atomic_load_n(State->CqTail, __ATOMIC_ACQUIRE))
+    {
+      Cqe = &State->Cqes[Head & *State->CqMask];
+      Index = (uint32_t) Cqe->user_data;
+      Ret = Cqe->res;
+      Head++;
+      __atomic_store_n(State->CqHead, Head, __ATOMIC_RELEASE);
+      Wait = 0;
+
+      // a short write continues by pwrite (the data after it may be written
+      // already, but this range is not). If the write is not supported, this
+      // buffer and the next buffers are written by pwrite.
+      if (Ret < 0 || (uint64_t) Ret < State->Len[Index])
+      {
+        Done = (Ret < 0) ? 0 : (uint64_t) Ret;
+        if (Ret == -EINVAL || Ret == -EOPNOTSUPP)
+          File->Uring = 0;
+        Failed = (Ret < 0 && Ret != -EAGAIN && Ret != -EINTR &&
+                  Ret != -EINVAL && Ret != -EOPNOTSUPP) ? 1 : 0;
+        if (Failed ||
+            TDMS_UringPwrite(File->Fd,
+                             &State->Buffers[Index * File->BufferSize + Done],
+                             State->Len[Index] - Done,
+                             State->FileOffset[Index] + Done) != TDMS_OK)
+          if (State->Result == TDMS_OK)
+            State->Result = TDMS_IO_ERROR;
+      }
+
+      State->InFlight[Index] = 0;
+      State->NumOfInFlight--;
+    }
+
+    if (!Wait || !State->NumOfInFlight)
+      return;
+
+    Ret = syscall(__NR_io_uring_enter, State->RingFd, 0, 1,
+                  IORING_ENTER_GETEVENTS, NULL, 0);
+    if (Ret < 0 && errno != EINTR)
+    {
+      File->Uring = 0;
+      for (Index = 0; Index < File->NumOfBuffers; Index++)
+      {
+        if (!State->InFlight[Index])
+          continue;
+        if (TDMS_UringPwrite(File->Fd, &State->Buffers[Index * File->BufferSize],
+                             State->Len[Index],
+                             State->FileOffset[Index]) != TDMS_OK &&
+            State->Result == TDMS_OK)
+          State->Result = TDMS_IO_ERROR;
+        State->InFlight[Index] = 0;
+      }
+      State->NumOfInFlight = 0;
+
+      Buffers = (uint8_t *) malloc((size_t) (File->BufferSize *
+                                             File->NumOfBuffers));
+      if (!Buffers)
+      {
+        if (State->Result == TDMS_OK)
+          State->Result = TDMS_IO_ERROR;
+        return;
+      }
+      memcpy(&Buffers[State->Current * File->BufferSize],
+             &State->Buffers[State->Current * File->BufferSize],
+             (size_t) State->Len[State->Current]);
+      State->StaleBuffers = State->Buffers;
+      State->Buffers = Buffers;
+      return;
+    }
+  }
+}
+#endif
+
+
+/**
+ * @brief  Write the data of the current buffer and move to the next buffer
+ *         (wait if its write is not completed yet)
+ * @param  File: Pointer to TDMS io_uring File structure
+ * @retval None (errors are saved in the state)
+ */
+static void
+TDMS_UringWriteBuffer(TDMS_UringFile_t *File)
+{
+  TDMS_UringState_t *State = (TDMS_UringState_t *) File->State;
+  uint32_t Index = State->Current;
+
+  if (!State->Len[Index])
+    return;
+
+  State->FileOffset[Index] = File->Offset;
+  File->Offset += State->Len[Index];
+
+#if (UringSupported == 1)
+  if (File->Uring)
+  {
+    State->InFlight[Index] = 1;
+    State->NumOfInFlight++;
+    if (TDMS_UringSubmit(File, Index) != TDMS_OK)
+    {
+      // the entry is removed from the ring, so the ring is not used anymore
+      State->InFlight[Index] = 0;
+      State->NumOfInFlight--;
+      TDMS_UringReap(File, 1);
+      File->Uring = 0;
+    }
+  }
+  if (!File->Uring)
+#endif
+  {
+    if (TDMS_UringPwrite(File->Fd, &State->Buffers[Index * File->BufferSize],
+                         State->Len[Index], State->FileOffset[Index]) != TDMS_OK &&
+        State->Result == TDMS_OK)
+      State->Result = TDMS_IO_ERROR;
+  }
+
+  State->Current = (Index + 1) % File->NumOfBuffers;
+#if (UringSupported == 1)
+  while (State->InFlight[State->Current])
+    TDMS_UringReap(File, 1);
+#endif
+  State->Len[State->Current] = 0;
+}
+
+
+/**
+ * @brief  Copy data into the buffers of io_uring File
+ * @param  File: Pointer to TDMS io_uring File structure
+ * @param  Data: Pointer to data
+ * @param  Size: Size of data (Byte)
+ * @retval None (errors are saved in the state)
+ */
+static void
+TDMS_UringAppend(TDMS_UringFile_t *File, const uint8_t *Data, uint64_t Size)
+{
+  TDMS_UringState_t *State = (TDMS_UringState_t *) File->State;
+  uint64_t Len = 0;
+
+  while (Size)
+  {
+    Len = File->BufferSize - State->Len[State->Current];
+    if (Len > Size)
+      Len = Size;
+    memcpy(&State->Buffers[State->Current * File->BufferSize +
+                           State->Len[State->Current]],
+           Data, (size_t) Len);
+    State->Len[State->Current] += Len;
+    Data += Len;
+    Size -= Len;
+
+    if (State->Len[State->Current] == File->BufferSize)
+      TDMS_UringWriteBuffer(File);
+  }
+}
+
+
+/**
+ * @brief  Sink write function of io_uring File sinks
+ * @param  Context: Pointer to TDMS io_uring File structure
+ * @param  Data: Pointer to data
+ * @param  Size: Size of data (Byte)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_IO_ERROR: A write failed
+ */
+static TDMS_Result_t
+TDMS_UringSinkWrite(void *Context, const uint8_t *Data, uint64_t Size)
+{
+  TDMS_UringFile_t *File = (TDMS_UringFile_t *) Context;
+
+  TDMS_UringAppend(File, Data, Size);
+
+  return ((TDMS_UringState_t *) File->State)->Result;
+}
+
+
+/**
+ * @brief  Sink scatter-gather write function of io_uring File sinks
+ * @param  Context: Pointer to TDMS io_uring File structure
+ * @param  IoVec: Pointer to array of elements
+ * @param  NumOfIoVec: Number of elements
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_IO_ERROR: A write failed
+ */
+static TDMS_Result_t
+TDMS_UringSinkWritev(void *Context,
+                     const TDMS_IoVec_t *IoVec, uint32_t NumOfIoVec)
+{
+  TDMS_UringFile_t *File = (TDMS_UringFile_t *) Context;
+  uint32_t CounterI = 0;
+
+  for (CounterI = 0; CounterI < NumOfIoVec; CounterI++)
+    TDMS_UringAppend(File, (const uint8_t *) IoVec[CounterI].Base,
+                     IoVec[CounterI].Len);
+
+  return ((TDMS_UringState_t *) File->State)->Result;
+}
+
+
+/**
+ * @brief  Sink write at offset function of io_uring File sinks
+ * @note   Data in the current buffer is changed in place. Data that is passed
+ *         to the ring is written by pwrite after all of the writes are
+ *         completed.
+ *
+ * @param  Context: Pointer to TDMS io_uring File structure
+ * @param  Data: Pointer to data
+ * @param  Size: Size of data (Byte)
+ * @param  Offset: Offset in the file (Byte)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Offset is after the end of the file
+ *         - TDMS_IO_ERROR: A write failed
+ */
+static TDMS_Result_t
+TDMS_UringSinkWriteAt(void *Context, const uint8_t *Data, uint64_t Size,
+                      uint64_t Offset)
+{
+  TDMS_UringFile_t *File = (TDMS_UringFile_t *) Context;
+  TDMS_UringState_t *State = (TDMS_UringState_t *) File->State;
+  uint8_t *Buffer = &State->Buffers[State->Current * File->BufferSize];
+  uint64_t Start = 0;
+
+  if (Offset + Size > File->Offset + State->Len[State->Current])
+    return TDMS_WRONG_ARG;
+
+  // the part in the current buffer
+  if (Offset + Size > File->Offset)
+  {
+    Start = (Offset > File->Offset) ? Offset : File->Offset;
+    memcpy(&Buffer[Start - File->Offset], &Data[Start - Offset],
+           (size_t) (Offset + Size - Start));
+    Size = Start - Offset;
+  }
+  if (!Size)
+    return State->Result;
+
+#if (UringSupported == 1)
+  while (State->NumOfInFlight)
+    TDMS_UringReap(File, 1);
+#endif
+  if (TDMS_UringPwrite(File->Fd, Data, Size, Offset) != TDMS_OK &&
+      State->Result == TDMS_OK)
+    State->Result = TDMS_IO_ERROR;
+
+  return State->Result;
+}
+
+
+
+/**
+ ==================================================================================
+                            ##### Public Functions #####
+ ==================================================================================
+ */
+
+/**
+ * @brief  Initialize io_uring File structure that saves data into a file
+ *         descriptor
+ * @note   Data is saved from the current position of the file. The file
+ *         descriptor must not be used until TDMS_DeInitUringFile is called.
+ *
+ * @param  File: Pointer to TDMS io_uring File structure
+ * @param  Fd: File descriptor (e.g. returned by open)
+ * @param  NumOfBuffers: Number of buffers (writes in flight, at least 2)
+ * @param  BufferSize: Size of each buffer (Byte)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ */
+TDMS_Result_t
+TDMS_InitUringFile(TDMS_UringFile_t *File, int Fd,
+                   uint32_t NumOfBuffers, uint64_t BufferSize)
+{
+  TDMS_UringState_t *State = NULL;
+  off_t Offset = 0;
+
+  if (Fd < 0 || NumOfBuffers < 2 || !BufferSize ||
+      BufferSize > 0xFFFFFFFF || BufferSize * NumOfBuffers > SIZE_MAX)
+    return TDMS_WRONG_ARG;
+
+  // data is written at explicit offsets from the current position
+  Offset = lseek(Fd, 0, SEEK_CUR);
+  if (Offset < 0)
+    return TDMS_WRONG_ARG;
+
+  State = (TDMS_UringState_t *) calloc(1, sizeof(TDMS_UringState_t));
+  if (!State)
+    return TDMS_NO_MEMORY;
+
+  State->Buffers = (uint8_t *) malloc((size_t) (BufferSize * NumOfBuffers));
+  State->Len = (uint64_t *) calloc(NumOfBuffers, sizeof(uint64_t));
+  State->FileOffset = (uint64_t *) calloc(NumOfBuffers, sizeof(uint64_t));
+  State->InFlight = (uint8_t *) calloc(NumOfBuffers, sizeof(uint8_t));
+  if (!State->Buffers || !State->Len || !State->FileOffset || !State->InFlight)
+  {
+    free(State->Buffers);
+    free(State->Len);
+    free(State->FileOffset);
+    free(State->InFlight);
+    free(State);
+    return TDMS_NO_MEMORY;
+  }
+  State->NumOfInFlight = 0;
+  State->Current = 0;
+  State->Result = TDMS_OK;
+
+  File->Fd = Fd;
+  File->NumOfBuffers = NumOfBuffers;
+  File->BufferSize = BufferSize;
+  File->Offset = (uint64_t) Offset;
+  File->State = (void *) State;
+#if (UringSupported == 1)
+  File->Uring = TDMS_UringSetup(State, NumOfBuffers);
+#else
+  File->Uring = 0;
+#endif
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Initialize a sink that saves data into an io_uring File
+ * @note   The sink supports scatter-gather write, so raw data of Channels is
+ *         copied only once (into the buffers). It supports WriteAt too.
+ *
+ * @param  Sink: Pointer to TDMS Sink structure
+ * @param  File: Pointer to initialized TDMS io_uring File structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+TDMS_Result_t
+TDMS_InitUringSink(TDMS_Sink_t *Sink, TDMS_UringFile_t *File)
+{
+  if (!File || !File->State)
+    return TDMS_WRONG_ARG;
+
+  Sink->Context = (void *) File;
+  Sink->Write = TDMS_UringSinkWrite;
+  Sink->Writev = TDMS_UringSinkWritev;
+  Sink->WriteAt = TDMS_UringSinkWriteAt;
+
+  return TDMS_OK;
+}
+
+
+/**
+ * @brief  Write the data of the current buffer and wait for all of the writes
+ * @param  File: Pointer to TDMS io_uring File structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_IO_ERROR: A write failed
+ */
+TDMS_Result_t
+TDMS_UringFileFlush(TDMS_UringFile_t *File)
+{
+  TDMS_UringState_t *State = (TDMS_UringState_t *) File->State;
+
+  if (!State)
+    return TDMS_OK;
+
+  TDMS_UringWriteBuffer(File);
+#if (UringSupported == 1)
+  while (State->NumOfInFlight)
+    TDMS_UringReap(File, 1);
+#endif
+
+  return State->Result;
+}
+
+
+/**
+ * @brief  Flush io_uring File and release its ring and buffers
+ * @note   The file descriptor is not closed. Its position is moved to the end
+ *         of the saved data.
+ *
+ * @param  File: Pointer to TDMS io_uring File structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_IO_ERROR: A write failed
+ */
+TDMS_Result_t
+TDMS_DeInitUringFile(TDMS_UringFile_t *File)
+{
+  TDMS_UringState_t *State = (TDMS_UringState_t *) File->State;
+  TDMS_Result_t Result = TDMS_OK;
+
+  if (!State)
+    return TDMS_OK;
+
+  Result = TDMS_UringFileFlush(File);
+  if (lseek(File->Fd, (off_t) File->Offset, SEEK_SET) < 0)
+    Result = TDMS_IO_ERROR;
+
+#if (UringSupported == 1)
+  if (State->Ring)
+    TDMS_UringRelease(State);
+  free(State->StaleBuffers);
+#endif
+  File->Uring = 0;
+
+  free(State->Buffers);
+  free(State->Len);
+  free(State->FileOffset);
+  free(State->InFlight);
+  free(State);
+  File->State = NULL;
+
+  return Result;
+}
+
+#endif //! TDMS_CONFIG_POSIX
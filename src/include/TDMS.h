@@ -3,7 +3,7 @@
  * @file   TDMS.h
  * @author Hossein.M (https://github.com/Hossein-M98)
  * @brief  Generate NI TDMS file (.TDMS)
- * @note   This library cannot read TDMS files.
+ * @note   TDMS files are read by TDMS_Reader.
  *         This library do not support all data types.
  **********************************************************************************
  */
@@ -20,9 +20,14 @@ extern "C" {
 /* Includes ---------------------------------------------------------------------*/
 #include "TDMS_config.h"
 #include <stdint.h>
+#include <stdio.h>
 
 
 /* Configurations ---------------------------------------------------------------*/
+#ifndef TDMS_CONFIG_DYNAMIC_OBJECTS
+  #define TDMS_CONFIG_DYNAMIC_OBJECTS  0
+#endif
+
 #ifndef TDMS_CONFIG_GROUP_NAME_LEN
   #define TDMS_CONFIG_GROUP_NAME_LEN  30
 #endif
@@ -39,10 +44,48 @@ extern "C" {
   #define TDMS_CONFIG_MAX_CHANNEL_OF_GROUP  8
 #endif
 
+#ifndef TDMS_CONFIG_MAX_SCALE_COEFFICIENTS
+  #define TDMS_CONFIG_MAX_SCALE_COEFFICIENTS  8
+#endif
+
 #ifndef TDMS_CONFIG_SYSTEM_ENDIANNESS
   #define TDMS_CONFIG_SYSTEM_ENDIANNESS  0
 #endif
 
+#ifndef TDMS_CONFIG_OUTPUT_ENDIANNESS
+  #define TDMS_CONFIG_OUTPUT_ENDIANNESS  TDMS_CONFIG_SYSTEM_ENDIANNESS
+#endif
+
+#ifndef TDMS_CONFIG_WRITER_BUFFER_SIZE
+  #define TDMS_CONFIG_WRITER_BUFFER_SIZE  4096
+#endif
+
+#ifndef TDMS_CONFIG_POSIX
+  #if defined(__unix__) || defined(__unix) || defined(__APPLE__)
+    #define TDMS_CONFIG_POSIX  1
+  #else
+    #define TDMS_CONFIG_POSIX  0
+  #endif
+#endif
+
+#if (TDMS_CONFIG_POSIX == 1)
+#include <time.h>
+#endif
+
+
+/* Exported Constants -----------------------------------------------------------*/
+/**
+ * @brief  Version of the API of the library
+ * @note   Version 2 breaks the callers of version 1: the number of values of
+ *         each Channel that is passed to variadic functions
+ *         (TDMS_SetGroupDataValues, TDMS_SetGroupDataValuesIoVec,
+ *         TDMS_WriterSetGroupDataValues, TDMS_CoalescerSetGroupDataValues and
+ *         TDMS_AsyncWriter(Lane)SetGroupDataValues) is uint64_t instead of
+ *         uint32_t. The compiler does not convert variadic arguments, so int
+ *         or size_t counts must be cast to uint64_t.
+ */
+#define TDMS_API_VERSION  2
+
 
 /* Exported Data Types ----------------------------------------------------------*/
 
@@ -53,7 +96,9 @@ typedef enum
 {
   TDMS_OK           = 0,
   TDMS_OUT_OF_CAP   = -1,
-  TDMS_WRONG_ARG    = -2
+  TDMS_WRONG_ARG    = -2,
+  TDMS_NO_MEMORY    = -3,
+  TDMS_IO_ERROR     = -4
 } TDMS_Result_t;
 
 typedef enum TDMS_Data_e
@@ -94,6 +139,31 @@ typedef struct
   int64_t   Second;
 } TDMS_Timestamp_t;
 
+/**
+ * @brief  Scale type of DAQmx Channels
+ */
+typedef enum
+{
+  // Value = Slope * Raw + Intercept
+  TDMS_ScaleType_Linear = 0,
+  // Value = Coefficients[0] + Coefficients[1] * Raw + ...
+  TDMS_ScaleType_Polynomial
+} TDMS_ScaleType_t;
+
+/**
+ * @brief  Scale that converts raw values of a DAQmx Channel to scaled values
+ */
+typedef struct
+{
+  TDMS_ScaleType_t Type;
+  // Linear scale
+  double Slope;
+  double Intercept;
+  // Polynomial scale (the array is copied into the Channel)
+  const double *Coefficients;
+  uint32_t NumOfCoefficients;
+} TDMS_Scale_t;
+
 /**
  * @brief  Channel structure
  */
@@ -101,7 +171,44 @@ typedef struct
 {
   void *GroupOfChannel;
   TDMS_Data_t ChannelDataType;
-  char ChannelPath[TDMS_CONFIG_GROUP_NAME_LEN+TDMS_CONFIG_CHANNEL_NAME_LEN+6];
+  // Length of the path (4B little-endian) followed by the path, as it is saved
+  // in meta data
+#if (TDMS_CONFIG_DYNAMIC_OBJECTS == 1)
+  uint8_t *ChannelPathBytes; // allocated from arena of the File
+#else
+  uint8_t ChannelPathBytes[4+TDMS_CONFIG_GROUP_NAME_LEN+TDMS_CONFIG_CHANNEL_NAME_LEN+6];
+#endif
+  // NULL terminated path (points into ChannelPathBytes)
+  char *ChannelPath;
+  uint32_t ChannelPathLen;
+  // Raw data of the segment that is being generated
+  void *ChunkValues;
+  uint64_t ChunkNumOfValues;
+  // Next Channel and number of values in object list of previous raw data
+  // segment of the file
+  void *LayoutNext;
+  uint64_t LayoutNumOfValues;
+  // Values that are staged by a Coalescer (StageSize: size of the buffer)
+  uint8_t *StageValues;
+  uint64_t StageNumOfValues;
+  uint64_t StageSize;
+  // Time of first sample and time between samples (Second) of a waveform
+  // Channel (saved as wf_ Properties in first part of the file)
+  uint8_t Waveform;
+  TDMS_Timestamp_t WfStartTime;
+  double WfIncrement;
+  // Number of values of a waveform Channel that are saved since WfStartTime
+  // (wf_start_time of the first part of next files is moved by them)
+  uint64_t WfNumOfValues;
+  // Scale of raw values of a DAQmx Channel (saved as NI_Scale Properties in
+  // first part of the file)
+  uint8_t DAQmx;
+  TDMS_Scale_t Scale;
+#if (TDMS_CONFIG_DYNAMIC_OBJECTS == 1)
+  double *ScaleCoefficients; // allocated from arena of the File
+#else
+  double ScaleCoefficients[TDMS_CONFIG_MAX_SCALE_COEFFICIENTS];
+#endif
 } TDMS_Channel_t;
 
 /**
@@ -111,8 +218,22 @@ typedef struct
 {
   void *FileOfGroup;
   uint32_t NumOfChannels;
+#if (TDMS_CONFIG_DYNAMIC_OBJECTS == 1)
+  TDMS_Channel_t **ChannelArray;
+  uint32_t ChannelArraySize;
+#else
   TDMS_Channel_t *ChannelArray[TDMS_CONFIG_MAX_CHANNEL_OF_GROUP];
-  char GroupPath[TDMS_CONFIG_GROUP_NAME_LEN+3];
+#endif
+  // Length of the path (4B little-endian) followed by the path, as it is saved
+  // in meta data
+#if (TDMS_CONFIG_DYNAMIC_OBJECTS == 1)
+  uint8_t *GroupPathBytes; // allocated from arena of the File
+#else
+  uint8_t GroupPathBytes[4+TDMS_CONFIG_GROUP_NAME_LEN+3];
+#endif
+  // NULL terminated path (points into GroupPathBytes)
+  char *GroupPath;
+  uint32_t GroupPathLen;
 } TDMS_Group_t;
 
 /**
@@ -121,9 +242,203 @@ typedef struct
 typedef struct 
 {
   uint32_t NumOfGroups;
+#if (TDMS_CONFIG_DYNAMIC_OBJECTS == 1)
+  TDMS_Group_t **GroupArray;
+  uint32_t GroupArraySize;
+  // Blocks that paths of the objects are allocated from (each block starts
+  // with pointer to the previous block)
+  uint8_t *Arena;
+  uint64_t ArenaUsed;
+  uint64_t ArenaSize;
+  // Hash tables of the objects by path (open addressing)
+  TDMS_Group_t **GroupHash;
+  uint32_t GroupHashSize;
+  TDMS_Channel_t **ChannelHash;
+  uint32_t ChannelHashSize;
+  uint32_t NumOfChannels;
+#else
   TDMS_Group_t *GroupArray[TDMS_CONFIG_MAX_GROUP_OF_FILE];
+#endif
+  // First Channel in object list of previous raw data segment
+  TDMS_Channel_t *LayoutFirst;
 } TDMS_File_t;
 
+/**
+ * @brief  Scatter-gather element (like struct iovec)
+ */
+typedef struct
+{
+  const void *Base;
+  uint64_t Len;
+} TDMS_IoVec_t;
+
+/**
+ * @brief  Sink that generated data of TDMS file save into
+ */
+typedef struct
+{
+  // Passed to the sink functions
+  void *Context;
+  // Saves Size bytes of Data and returns TDMS_OK on success
+  TDMS_Result_t (*Write)(void *Context, const uint8_t *Data, uint64_t Size);
+  // Optional: Saves all elements of IoVec in order and returns TDMS_OK on
+  // success
+  TDMS_Result_t (*Writev)(void *Context,
+                          const TDMS_IoVec_t *IoVec, uint32_t NumOfIoVec);
+  // Optional: Saves Size bytes of Data at Offset of the file (data that is
+  // saved before is overwritten and next data is still saved at the end) and
+  // returns TDMS_OK on success. Needed by streaming segments.
+  TDMS_Result_t (*WriteAt)(void *Context, const uint8_t *Data, uint64_t Size,
+                           uint64_t Offset);
+} TDMS_Sink_t;
+
+/**
+ * @brief  Writer structure
+ */
+typedef struct
+{
+  TDMS_File_t *File;
+  TDMS_Sink_t Sink;
+  // Buffer that each part of file is generated in before saving into sink
+  uint8_t *Buffer;
+  uint64_t BufferSize;
+  // Elements of scatter-gather write (used if sink has Writev function)
+  TDMS_IoVec_t *IoVec;
+  uint32_t IoVecSize;
+  // Sink of TDMS index file (disabled if Write function is Null)
+  TDMS_Sink_t IndexSink;
+  // Number of bytes saved into sink
+  uint64_t Offset;
+  // Rotation of the files of a rotating Writer (TDMS_Rotation_t, Null: no
+  // rotation)
+  void *Rotation;
+} TDMS_Writer_t;
+
+/**
+ * @brief  Coalescer structure
+ */
+typedef struct
+{
+  TDMS_Writer_t *Writer;
+  // Thresholds of saving the staged values (0: disabled)
+  uint64_t MaxBytes;
+  uint64_t MaxValues;
+  uint64_t MaxTime;
+  // Returns current time (ms)
+  uint64_t (*GetTime)(void);
+  // Channels that have staging buffer (in order of their first values)
+  TDMS_Channel_t **Channels;
+  uint32_t NumOfChannels;
+  uint32_t ChannelsSize;
+  // Staged raw data of all Channels (Byte) and time of the first staged value
+  uint64_t StagedBytes;
+  uint64_t FirstTime;
+} TDMS_Coalescer_t;
+
+/**
+ * @brief  Group Template structure (serialized Lead In part and meta data of
+ *         the raw data segments of a Group)
+ */
+typedef struct
+{
+  TDMS_Group_t *Group;
+  uint32_t NumOfChannels;
+  // Number of values of each Channel and offset of it in Header (0: Channel is
+  // not in the segment)
+  uint64_t *NumOfValues;
+  uint64_t *NumOfValuesOffset;
+  // Lead In part and meta data of a segment with new object list, followed by
+  // Lead In part of a raw data only segment
+  uint8_t *Header;
+  uint64_t MetaDataLen;
+  uint64_t RawDataLen;
+} TDMS_GroupTemplate_t;
+
+/**
+ * @brief  Streaming Segment structure (a raw data segment that is open while
+ *         raw data of a Group Template is appended to it)
+ */
+typedef struct
+{
+  TDMS_Writer_t *Writer;
+  TDMS_GroupTemplate_t *Template;
+  // Offset of the Lead In part of the segment in the file (Byte)
+  uint64_t Start;
+  // Length of raw data that is appended to the segment (Byte)
+  uint64_t RawDataLen;
+  // Lead In part and meta data of the segment
+  uint8_t *Header;
+  uint64_t HeaderLen;
+} TDMS_StreamSegment_t;
+
+/**
+ * @brief  Object of a Property Builder
+ */
+typedef struct
+{
+  // Path of the object in meta data format (length followed by path)
+  const uint8_t *PathBytes;
+  uint32_t PathLen;
+  // Channel of the object (Null for File and Groups)
+  TDMS_Channel_t *Channel;
+  // Properties of the object and their length in meta data
+  uint32_t NumOfProperties;
+  uint64_t PropertiesLen;
+  // Offset of first and last Property of the object in Properties of the
+  // Builder
+  uint64_t First;
+  uint64_t Last;
+} TDMS_PropertyObject_t;
+
+/**
+ * @brief  Property Builder structure
+ */
+typedef struct
+{
+  TDMS_File_t *File;
+  // Objects that have Properties (in order of their first Property)
+  TDMS_PropertyObject_t *Objects;
+  uint32_t NumOfObjects;
+  uint32_t ObjectsSize;
+  // Hash table of the objects by path (index of object + 1, 0: empty)
+  uint32_t *ObjectHash;
+  uint32_t ObjectHashSize;
+  // Properties of all objects (each one is saved as offset of next Property
+  // of the object, its length and its meta data)
+  uint8_t *Properties;
+  uint64_t PropertiesLen;
+  uint64_t PropertiesSize;
+} TDMS_PropertyBuilder_t;
+
+/**
+ * @brief  Rotation structure (files of a rotating Writer)
+ */
+typedef struct
+{
+  // Thresholds of starting a new file (0: disabled)
+  uint64_t MaxSize; // Byte
+  uint64_t MaxDuration; // ms
+  // Returns current time in ms (Null: monotonic clock on POSIX systems)
+  uint64_t (*GetTime)(void);
+  // Gives the sinks of the next file (Write of IndexSink is Null if there is
+  // no index file). The sinks of the previous file are not used after it is
+  // called, so it can close them.
+  TDMS_Result_t (*NextFile)(void *Context,
+                            TDMS_Sink_t *Sink, TDMS_Sink_t *IndexSink);
+  void *Context;
+  // Properties that are saved in the first part of each file, or Null.
+  // Properties that are saved by the Writer are added to it too.
+  TDMS_PropertyBuilder_t *Builder;
+  // First part of the files that is generated once and saved again at the
+  // start of each file (FirstPartLen 0: it must be generated again)
+  uint8_t *FirstPart;
+  uint64_t FirstPartLen;
+  uint64_t FirstPartSize;
+  // Time that current file is started and number of started files
+  uint64_t FileStartTime;
+  uint32_t NumOfFiles;
+} TDMS_Rotation_t;
+
 
 
 /**
@@ -142,6 +457,18 @@ TDMS_Result_t
 TDMS_InitFile(TDMS_File_t *File);
 
 
+/**
+ * @brief  Release the memory of File object structure (dynamic objects only)
+ * @note   Paths of the Groups and Channels of the File are released too.
+ *
+ * @param  File: Pointer to File object structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ */
+TDMS_Result_t
+TDMS_DeInitFile(TDMS_File_t *File);
+
+
 /**
  * @brief  Initialize Channel Group object structure
  * @param  Group: Pointer to TDMS Channel Group object structure
@@ -152,6 +479,8 @@ TDMS_InitFile(TDMS_File_t *File);
  * @retval TDMS_Result_t
  *         - TDMS_OK: Operation was successful
  *         - TDMS_OUT_OF_CAP: The file object capacity is full
+ *         - TDMS_WRONG_ARG: Name is too long or the Group already exists
+ *         - TDMS_NO_MEMORY: Memory allocation failed (dynamic objects)
  */
 TDMS_Result_t
 TDMS_AddGroupToFile(TDMS_Group_t *Group, TDMS_File_t *File, char *Name);
@@ -176,19 +505,121 @@ TDMS_AddGroupToFile(TDMS_Group_t *Group, TDMS_File_t *File, char *Name);
  *         - TDMS_DataType_U64: unsigned int 64 bit
  *         - TDMS_DataType_SingleFloat: 4 byte floating point number
  *         - TDMS_DataType_DoubleFloat: 8 byte floating point number
- *         - TDMS_DataType_String: string, array of characters
+ *         - TDMS_DataType_String: string, array of characters (values are set
+ *                                 by TDMS_SetChannelStringValues functions)
  *         - TDMS_DataType_Boolean: boolean data
  *         - TDMS_DataType_TimeStamp: time stamp data
  * 
  * @retval TDMS_Result_t
  *         - TDMS_OK: Operation was successful
- *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_WRONG_ARG: Wrong argument or the Channel already exists
+ *         - TDMS_OUT_OF_CAP: The Group object capacity is full
+ *         - TDMS_NO_MEMORY: Memory allocation failed (dynamic objects)
  */
 TDMS_Result_t
 TDMS_AddChannelToGroup(TDMS_Channel_t *Channel, TDMS_Group_t *Group,
                        char *Name, TDMS_Data_t DataType);
 
 
+/**
+ * @brief  Add a waveform Channel to Channel Group
+ * @note   Time of the samples is saved as wf_start_time, wf_start_offset and
+ *         wf_increment Properties of the Channel in first part of the file, so
+ *         no Timestamp Channel is needed for fixed-rate signals. wf_samples is
+ *         not saved, readers take the number of samples from the raw data.
+ * 
+ * @param  Channel: Pointer to TDMS Channel object structure
+ * @param  Group: Pointer to the Channel Group object structure that Channel assign
+ *                into
+ * 
+ * @param  Name: Pointer to Name of TDMS Channel object
+ * @param  DataType: Data type of Channel Raw data (like TDMS_AddChannelToGroup)
+ * @param  StartTime: Pointer to time of first sample
+ * @param  Increment: Time between two samples (Second, greater than 0)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_OUT_OF_CAP: The Group object capacity is full
+ *         - TDMS_NO_MEMORY: Memory allocation failed (dynamic objects)
+ */
+TDMS_Result_t
+TDMS_AddWaveformChannelToGroup(TDMS_Channel_t *Channel, TDMS_Group_t *Group,
+                               char *Name, TDMS_Data_t DataType,
+                               const TDMS_Timestamp_t *StartTime,
+                               double Increment);
+
+
+/**
+ * @brief  Add a DAQmx Channel to Channel Group
+ * @note   Raw values (e.g. ADC counts) are saved in DAQmx raw data segments
+ *         (kTocDAQmxRawData) and the Scale is saved as NI_Scale Properties of
+ *         the Channel in first part of the file, so readers apply the scale and
+ *         values are not converted to floating point before saving.
+ * @note   All of the Channels of a segment that has a DAQmx Channel must be
+ *         DAQmx Channels with the same number of values. Their values are saved
+ *         interleaved (like TDMS_SetGroupInterleavedDataValues), so
+ *         TDMS_SetGroupInterleavedFrames saves ADC frames without copy.
+ * 
+ * @param  Channel: Pointer to TDMS Channel object structure
+ * @param  Group: Pointer to the Channel Group object structure that Channel assign
+ *                into
+ * 
+ * @param  Name: Pointer to Name of TDMS Channel object
+ * @param  RawDataType: Data type of raw values
+ *         - TDMS_DataType_I8, TDMS_DataType_I16, TDMS_DataType_I32,
+ *           TDMS_DataType_I64: signed integer
+ *         - TDMS_DataType_U8, TDMS_DataType_U16, TDMS_DataType_U32,
+ *           TDMS_DataType_U64: unsigned integer
+ *         - TDMS_DataType_SingleFloat, TDMS_DataType_DoubleFloat: floating
+ *           point number
+ * 
+ * @param  Scale: Pointer to the Scale of raw values (it and its coefficients
+ *                are copied)
+ *
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_OUT_OF_CAP: The Group object capacity is full or the Scale
+ *                            has more than TDMS_CONFIG_MAX_SCALE_COEFFICIENTS
+ *                            coefficients (static objects)
+ *         - TDMS_NO_MEMORY: Memory allocation failed (dynamic objects)
+ */
+TDMS_Result_t
+TDMS_AddDAQmxChannelToGroup(TDMS_Channel_t *Channel, TDMS_Group_t *Group,
+                            char *Name, TDMS_Data_t RawDataType,
+                            const TDMS_Scale_t *Scale);
+
+
+/**
+ * @brief  Find a Channel Group of the File by its path
+ * @note   It is O(1) for dynamic objects and a linear search for static ones.
+ *
+ * @param  File: Pointer to TDMS File object structure
+ * @param  Path: Path of the Channel Group (e.g. "/'Group'")
+ * @param  Group: Pointer to save address of the Channel Group
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: The Channel Group does not exist
+ */
+TDMS_Result_t
+TDMS_FindGroup(TDMS_File_t *File, const char *Path, TDMS_Group_t **Group);
+
+
+/**
+ * @brief  Find a Channel of the File by its path
+ * @note   It is O(1) for dynamic objects and a linear search for static ones.
+ *
+ * @param  File: Pointer to TDMS File object structure
+ * @param  Path: Path of the Channel (e.g. "/'Group'/'Channel'")
+ * @param  Channel: Pointer to save address of the Channel
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: The Channel does not exist
+ */
+TDMS_Result_t
+TDMS_FindChannel(TDMS_File_t *File, const char *Path, TDMS_Channel_t **Channel);
+
+
 /**
  * @brief  Generate First part of TDMS file
  * @note   To use this function, you must first create the File, and add
@@ -203,7 +634,7 @@ TDMS_AddChannelToGroup(TDMS_Channel_t *Channel, TDMS_Group_t *Group,
 TDMS_Result_t
 TDMS_GenFirstPart(TDMS_File_t *File,
                   uint8_t *Buffer,
-                  uint32_t *Size);
+                  uint64_t *Size);
 
 
 /**
@@ -224,7 +655,7 @@ TDMS_GenFirstPart(TDMS_File_t *File,
  *         - TDMS_WRONG_ARG: Wrong argument
  */
 TDMS_Result_t
-TDMS_AddPropertyToFile(uint8_t *Buffer, uint32_t *Size,
+TDMS_AddPropertyToFile(uint8_t *Buffer, uint64_t *Size,
                        char *Name, TDMS_Data_t DataType, void *Value);
 
 
@@ -248,7 +679,7 @@ TDMS_AddPropertyToFile(uint8_t *Buffer, uint32_t *Size,
  */
 TDMS_Result_t
 TDMS_AddPropertyToGroup(TDMS_Group_t *Group,
-                        uint8_t *Buffer, uint32_t *Size,
+                        uint8_t *Buffer, uint64_t *Size,
                         char *Name, TDMS_Data_t DataType, void *Value);
 
 
@@ -272,7 +703,7 @@ TDMS_AddPropertyToGroup(TDMS_Group_t *Group,
  */
 TDMS_Result_t
 TDMS_AddPropertyToChannel(TDMS_Channel_t *Channel,
-                          uint8_t *Buffer, uint32_t *Size,
+                          uint8_t *Buffer, uint64_t *Size,
                           char *Name, TDMS_Data_t DataType, void *Value);
 
 
@@ -283,6 +714,10 @@ TDMS_AddPropertyToChannel(TDMS_Channel_t *Channel,
  *         then generate and save the first part of TDMS file using the
  *         TDMS_GenFirstPart function, and then use this function to add data to
  *         the Channels.
+ * @note   If the Channel and number of values are the same as previous raw data
+ *         segment of the file, the segment only contains Lead In part and raw
+ *         data. The buffer must be saved on disk, after each call with a valid
+ *         buffer address.
  * 
  * @param  Channel: Pointer to TDMS Channel object structure
  * @param  Buffer: Pointer to the buffer that data save in
@@ -290,17 +725,20 @@ TDMS_AddPropertyToChannel(TDMS_Channel_t *Channel,
  *         buffer size and returns TDMS_OK.
  * 
  * @param  Size: Size of data in buffer (Byte)
- * @param  Values: Pointer to data values
+ * @param  Values: Pointer to data values (not changed, Boolean values are
+ *                 saved as 0 and 1)
+ * 
  * @param  NumOfValues: Number of values
  * @retval TDMS_Result_t
  *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
  */
 TDMS_Result_t
 TDMS_SetChannelDataValues(TDMS_Channel_t *Channel,
                           uint8_t *Buffer,
-                          uint32_t *Size,
-                          void *Values,
-                          uint32_t NumOfValues);
+                          uint64_t *Size,
+                          const void *Values,
+                          uint64_t NumOfValues);
 
 
 /**
@@ -310,6 +748,10 @@ TDMS_SetChannelDataValues(TDMS_Channel_t *Channel,
  *         then generate and save the first part of TDMS file using the
  *         TDMS_GenFirstPart function, and then use this function to add data to
  *         the Channels of a Groupe.
+ * @note   If the Channels and their number of values are the same as previous
+ *         raw data segment of the file, the segment only contains Lead In part
+ *         and raw data. The buffer must be saved on disk, after each call with a
+ *         valid buffer address.
  * 
  * @param  Group: Pointer to TDMS Group object structure
  * @param  Buffer: Pointer to the buffer that data save in
@@ -317,25 +759,258 @@ TDMS_SetChannelDataValues(TDMS_Channel_t *Channel,
  *         buffer size and returns TDMS_OK.
  * 
  * @param  Size: Size of data in buffer (Byte)
- * @param  ...: Pointer to Channels data values, Number of values.
+ * @param  ...: Pointer to Channels data values, Number of values (uint64_t).
+ * @note   Number of values must be passed as uint64_t.
  * @note   This is a example of calling this function for a Group with 2
  *         Channels:
  *         uint8_t Ch1Values[3] = {0,1,2}; // Ch1 data type is tdsTypeU8
  *         float Ch2Values[2] = {10.0,11.1}; // Ch1 data type is tdsTypeSingleFloat
  *         TDMS_SetGroupDataValues(&Group, Buffer, &Size,
- *                                 Ch1Values, 3, Ch2Values , 2);
+ *                                 Ch1Values, (uint64_t) 3,
+ *                                 Ch2Values, (uint64_t) 2);
  * 
  * @retval TDMS_Result_t
  *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
  */
 TDMS_Result_t
 TDMS_SetGroupDataValues(TDMS_Group_t *Group,
                         uint8_t *Buffer,
-                        uint32_t *Size,
+                        uint64_t *Size,
                         ...
                         );
 
 
+/**
+ * @brief  Set data to a Channel without copying the data values
+ * @note   Like TDMS_SetChannelDataValues, but only Lead In part and meta data
+ *         are generated in the buffer. The segment is described by IoVec array
+ *         that points to the buffer and to the data values, and can be saved
+ *         with a scatter-gather write (e.g. writev).
+ * @note   Boolean values (and values that are saved in other byte order) are
+ *         still converted into the buffer.
+ * 
+ * @param  Channel: Pointer to TDMS Channel object structure
+ * @param  Buffer: Pointer to the buffer that Lead In part and meta data save in
+ * @note   If the buffer address is Null, then function only calculates needed
+ *         buffer size and returns TDMS_OK.
+ * 
+ * @param  Size: Size of data in buffer (Byte)
+ * @param  IoVec: Pointer to an array of at least 2 elements
+ * @param  NumOfIoVec: Number of used elements of IoVec
+ * @param  Values: Pointer to data values (must be valid until the segment is
+ *                 saved)
+ * 
+ * @param  NumOfValues: Number of values
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+TDMS_Result_t
+TDMS_SetChannelDataValuesIoVec(TDMS_Channel_t *Channel,
+                               uint8_t *Buffer,
+                               uint64_t *Size,
+                               TDMS_IoVec_t *IoVec,
+                               uint32_t *NumOfIoVec,
+                               const void *Values,
+                               uint64_t NumOfValues);
+
+
+/**
+ * @brief  Set data to Channels of a Group without copying the data values
+ * @note   Like TDMS_SetGroupDataValues, but only Lead In part and meta data
+ *         are generated in the buffer. The segment is described by IoVec array
+ *         that points to the buffer and to the data values, and can be saved
+ *         with a scatter-gather write (e.g. writev).
+ * @note   Boolean values (and values that are saved in other byte order) are
+ *         still converted into the buffer.
+ * 
+ * @param  Group: Pointer to TDMS Group object structure
+ * @param  Buffer: Pointer to the buffer that Lead In part and meta data save in
+ * @note   If the buffer address is Null, then function only calculates needed
+ *         buffer size and returns TDMS_OK.
+ * 
+ * @param  Size: Size of data in buffer (Byte)
+ * @param  IoVec: Pointer to an array of at least (number of Channels of the
+ *                Group + 1) elements
+ * 
+ * @param  NumOfIoVec: Number of used elements of IoVec
+ * @param  ...: Pointer to Channels data values, Number of values (uint64_t).
+ *         (like TDMS_SetGroupDataValues)
+ * 
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+TDMS_Result_t
+TDMS_SetGroupDataValuesIoVec(TDMS_Group_t *Group,
+                             uint8_t *Buffer,
+                             uint64_t *Size,
+                             TDMS_IoVec_t *IoVec,
+                             uint32_t *NumOfIoVec,
+                             ...
+                             );
+
+
+/**
+ * @brief  Set data to Channels of a Group as interleaved raw data
+ * @note   Like TDMS_SetGroupDataValues, but all of the Channels have the same
+ *         number of values and the values are interleaved (one value of each
+ *         Channel per row) in the buffer (kTocInterleavedData segment).
+ * 
+ * @param  Group: Pointer to TDMS Group object structure
+ * @param  Buffer: Pointer to the buffer that data save in
+ * @note   If the buffer address is Null, then function only calculates needed
+ *         buffer size and returns TDMS_OK.
+ * 
+ * @param  Size: Size of data in buffer (Byte)
+ * @param  NumOfValues: Number of values of each Channel
+ * @param  ...: Pointer to data values of each Channel.
+ * @note   This is a example of calling this function for a Group with 2
+ *         Channels:
+ *         uint16_t Ch1Values[3] = {0,1,2}; // Ch1 data type is tdsTypeU16
+ *         float Ch2Values[3] = {10.0,11.1,12.2}; // Ch2 data type is tdsTypeSingleFloat
+ *         TDMS_SetGroupInterleavedDataValues(&Group, Buffer, &Size, 3,
+ *                                            Ch1Values, Ch2Values);
+ * 
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+TDMS_Result_t
+TDMS_SetGroupInterleavedDataValues(TDMS_Group_t *Group,
+                                   uint8_t *Buffer,
+                                   uint64_t *Size,
+                                   uint64_t NumOfValues,
+                                   ...
+                                   );
+
+
+/**
+ * @brief  Set data to Channels of a Group from interleaved frames
+ * @note   Each frame contains one value of each Channel of the Group in order
+ *         of the Channels (e.g. a sample of a DAQ device), so the frames are
+ *         saved as interleaved raw data (kTocInterleavedData segment) without
+ *         any conversion.
+ * 
+ * @param  Group: Pointer to TDMS Group object structure
+ * @param  Buffer: Pointer to the buffer that data save in
+ * @note   If the buffer address is Null, then function only calculates needed
+ *         buffer size and returns TDMS_OK.
+ * 
+ * @param  Size: Size of data in buffer (Byte)
+ * @param  Frames: Pointer to the frames
+ * @param  NumOfFrames: Number of frames
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+TDMS_Result_t
+TDMS_SetGroupInterleavedFrames(TDMS_Group_t *Group,
+                               uint8_t *Buffer,
+                               uint64_t *Size,
+                               const void *Frames,
+                               uint64_t NumOfFrames);
+
+
+/**
+ * @brief  Set data to Channels of a Group from interleaved frames without
+ *         copying the frames
+ * @note   Like TDMS_SetGroupInterleavedFrames, but only Lead In part and meta
+ *         data are generated in the buffer. The segment is described by IoVec
+ *         array that points to the buffer and to the frames, and can be saved
+ *         with a scatter-gather write (e.g. writev).
+ * 
+ * @param  Group: Pointer to TDMS Group object structure
+ * @param  Buffer: Pointer to the buffer that Lead In part and meta data save in
+ * @note   If the buffer address is Null, then function only calculates needed
+ *         buffer size and returns TDMS_OK.
+ * 
+ * @param  Size: Size of data in buffer (Byte)
+ * @param  IoVec: Pointer to an array of at least 2 elements
+ * @param  NumOfIoVec: Number of used elements of IoVec
+ * @param  Frames: Pointer to the frames (must be valid until the segment is
+ *                 saved)
+ * 
+ * @param  NumOfFrames: Number of frames
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+TDMS_Result_t
+TDMS_SetGroupInterleavedFramesIoVec(TDMS_Group_t *Group,
+                                    uint8_t *Buffer,
+                                    uint64_t *Size,
+                                    TDMS_IoVec_t *IoVec,
+                                    uint32_t *NumOfIoVec,
+                                    const void *Frames,
+                                    uint64_t NumOfFrames);
+
+
+/**
+ * @brief  Set strings to a string Channel
+ * @note   The end offsets and the concatenated strings are generated in one
+ *         pass, without allocation. String Channels are always saved in a
+ *         segment with a new object list. The buffer must be saved on disk,
+ *         after each call with a valid buffer address.
+ * 
+ * @param  Channel: Pointer to TDMS Channel object structure (TDMS_DataType_String)
+ * @param  Buffer: Pointer to the buffer that data save in
+ * @note   If the buffer address is Null, then function only calculates needed
+ *         buffer size and returns TDMS_OK.
+ * 
+ * @param  Size: Size of data in buffer (Byte)
+ * @param  Strings: Array of pointers to the strings
+ * @param  Lengths: Array of lengths of the strings (Byte). If it is Null, the
+ *                  strings must be NULL terminated.
+ * 
+ * @param  NumOfValues: Number of strings
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+TDMS_Result_t
+TDMS_SetChannelStringValues(TDMS_Channel_t *Channel,
+                            uint8_t *Buffer,
+                            uint64_t *Size,
+                            const char * const *Strings,
+                            const uint32_t *Lengths,
+                            uint64_t NumOfValues);
+
+
+/**
+ * @brief  Set packed strings to a string Channel
+ * @note   This is the layout of string raw data in TDMS files, so the strings
+ *         are saved as they are (with a Writer that its sink has Writev
+ *         function, they are not copied).
+ * 
+ * @param  Channel: Pointer to TDMS Channel object structure (TDMS_DataType_String)
+ * @param  Buffer: Pointer to the buffer that data save in
+ * @note   If the buffer address is Null, then function only calculates needed
+ *         buffer size and returns TDMS_OK.
+ * 
+ * @param  Size: Size of data in buffer (Byte)
+ * @param  Packed: Pointer to the concatenated strings (without NULL characters)
+ * @param  PackedLen: Length of Packed (Byte)
+ * @param  EndOffsets: Array of end offsets of the strings in Packed (Byte, not
+ *                     decreasing and not more than PackedLen)
+ * 
+ * @param  NumOfValues: Number of strings
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument (e.g. end offsets out of order or
+ *           out of Packed)
+ */
+TDMS_Result_t
+TDMS_SetChannelPackedStringValues(TDMS_Channel_t *Channel,
+                                  uint8_t *Buffer,
+                                  uint64_t *Size,
+                                  const char *Packed,
+                                  uint64_t PackedLen,
+                                  const uint32_t *EndOffsets,
+                                  uint64_t NumOfValues);
+
+
 /**
  * @brief  Calculate second part of TDMS Timestamp from normal time and date
  * @param  Year: Normal Year (1904 to ...)
@@ -351,6 +1026,858 @@ TDMS_TimeSecond(uint16_t Year, uint8_t Month, uint8_t Day,
                 uint8_t Hour, uint8_t Minute, uint8_t Second);
 
 
+/**
+ * @brief  Convert nanoseconds since Unix epoch (1970-01-01 UTC) to TDMS
+ *         Timestamps
+ * @note   Timestamps and Ns can not overlap.
+ * 
+ * @param  Timestamps: Pointer to save TDMS Timestamps
+ * @param  Ns: Pointer to nanoseconds since Unix epoch (negative before it)
+ * @param  NumOfValues: Number of values
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ */
+TDMS_Result_t
+TDMS_TimestampFromUnixNs(TDMS_Timestamp_t *Timestamps,
+                         const int64_t *Ns,
+                         uint64_t NumOfValues);
+
+
+#if (TDMS_CONFIG_POSIX == 1)
+/**
+ * @brief  Convert timespec values since Unix epoch (e.g. from clock_gettime
+ *         with CLOCK_REALTIME) to TDMS Timestamps
+ * @param  Timestamps: Pointer to save TDMS Timestamps
+ * @param  Times: Pointer to timespec values (tv_nsec: 0 to 999999999)
+ * @param  NumOfValues: Number of values
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ */
+TDMS_Result_t
+TDMS_TimestampFromTimespec(TDMS_Timestamp_t *Timestamps,
+                           const struct timespec *Times,
+                           uint64_t NumOfValues);
+#endif
+
+
+
+/**
+ ==================================================================================
+                          ##### Writer Functions #####                             
+ ==================================================================================
+ */
+
+/**
+ * @brief  Initialize Writer object structure
+ * @note   The Writer generates each part of the TDMS file in a buffer that it
+ *         owns and passes it to the sink. The buffer is reused and only grows
+ *         when a part does not fit in it.
+ * @note   If the sink has Writev function, raw data of Channels is not copied
+ *         into the buffer and only Lead In part and meta data are generated in
+ *         it.
+ * 
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  File: Pointer to TDMS File object structure
+ * @param  Sink: Pointer to the sink that generated data save into (copied)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ */
+TDMS_Result_t
+TDMS_InitWriter(TDMS_Writer_t *Writer, TDMS_File_t *File,
+                const TDMS_Sink_t *Sink);
+
+
+/**
+ * @brief  Initialize Writer object structure that saves data into a stdio
+ *         stream
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  File: Pointer to TDMS File object structure
+ * @param  Stream: Pointer to FILE object of the stream (opened in binary mode)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ */
+TDMS_Result_t
+TDMS_InitWriterStream(TDMS_Writer_t *Writer, TDMS_File_t *File, FILE *Stream);
+
+
+/**
+ * @brief  Set the sink of TDMS index file (.tdms_index) of the Writer
+ * @note   When the Writer has an index sink, Lead In part and meta data of each
+ *         segment are saved into it too. NI readers use the index file to open
+ *         large TDMS files faster.
+ * @note   Must be called before TDMS_WriterGenFirstPart
+ * 
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Sink: Pointer to the sink that index data save into (copied). Null
+ *               disables TDMS index file generation.
+ * 
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+TDMS_Result_t
+TDMS_WriterSetIndexSink(TDMS_Writer_t *Writer, const TDMS_Sink_t *Sink);
+
+
+/**
+ * @brief  Set a stdio stream as the sink of TDMS index file (.tdms_index) of
+ *         the Writer
+ * @note   Must be called before TDMS_WriterGenFirstPart
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Stream: Pointer to FILE object of the stream (opened in binary mode)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+TDMS_Result_t
+TDMS_WriterSetIndexStream(TDMS_Writer_t *Writer, FILE *Stream);
+
+
+/**
+ * @brief  De-initialize Writer object structure and free its buffer
+ * @note   The sink is not closed (for a rotating Writer, neither are the sinks
+ *         of its last file)
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ */
+TDMS_Result_t
+TDMS_DeInitWriter(TDMS_Writer_t *Writer);
+
+
+/**
+ * @brief  Generate First part of TDMS file and save it into the sink
+ * @note   To use this function, you must first create the File, and add
+ *         Groups and Channels.
+ * 
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_WriterGenFirstPart(TDMS_Writer_t *Writer);
+
+
+/**
+ * @brief  Add Property to the file object and save it into the sink
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Name: Name of Property
+ * @param  DataType: Data type of Property
+ * @param  Value: Pointer to the value of Property
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_WriterAddPropertyToFile(TDMS_Writer_t *Writer,
+                             char *Name, TDMS_Data_t DataType, void *Value);
+
+
+/**
+ * @brief  Add Property to the group object and save it into the sink
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Group: Pointer to TDMS group object structure
+ * @param  Name: Name of Property
+ * @param  DataType: Data type of Property
+ * @param  Value: Pointer to the value of Property
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_WriterAddPropertyToGroup(TDMS_Writer_t *Writer, TDMS_Group_t *Group,
+                              char *Name, TDMS_Data_t DataType, void *Value);
+
+
+/**
+ * @brief  Add Property to the channel object and save it into the sink
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Channel: Pointer to TDMS channel object structure
+ * @param  Name: Name of Property
+ * @param  DataType: Data type of Property
+ * @param  Value: Pointer to the value of Property
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_WriterAddPropertyToChannel(TDMS_Writer_t *Writer, TDMS_Channel_t *Channel,
+                                char *Name, TDMS_Data_t DataType, void *Value);
+
+
+/**
+ * @brief  Set data to a Channel and save it into the sink
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Channel: Pointer to TDMS Channel object structure
+ * @param  Values: Pointer to data values
+ * @param  NumOfValues: Number of values
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_WriterSetChannelDataValues(TDMS_Writer_t *Writer,
+                                TDMS_Channel_t *Channel,
+                                const void *Values,
+                                uint64_t NumOfValues);
+
+
+/**
+ * @brief  Set data to Channels of a Group and save it into the sink
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Group: Pointer to TDMS Group object structure
+ * @param  ...: Pointer to Channels data values, Number of values (uint64_t).
+ *         (like TDMS_SetGroupDataValues)
+ * 
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_WriterSetGroupDataValues(TDMS_Writer_t *Writer,
+                              TDMS_Group_t *Group,
+                              ...
+                              );
+
+
+/**
+ * @brief  Set data to Channels of a Group as interleaved raw data and save it
+ *         into the sink
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Group: Pointer to TDMS Group object structure
+ * @param  NumOfValues: Number of values of each Channel
+ * @param  ...: Pointer to data values of each Channel.
+ *         (like TDMS_SetGroupInterleavedDataValues)
+ * 
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_WriterSetGroupInterleavedDataValues(TDMS_Writer_t *Writer,
+                                         TDMS_Group_t *Group,
+                                         uint64_t NumOfValues,
+                                         ...
+                                         );
+
+
+/**
+ * @brief  Set data to Channels of a Group from interleaved frames and save it
+ *         into the sink
+ * @note   If the sink supports scatter-gather write, the frames are not copied.
+ * 
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Group: Pointer to TDMS Group object structure
+ * @param  Frames: Pointer to the frames (like TDMS_SetGroupInterleavedFrames)
+ * @param  NumOfFrames: Number of frames
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_WriterSetGroupInterleavedFrames(TDMS_Writer_t *Writer,
+                                     TDMS_Group_t *Group,
+                                     const void *Frames,
+                                     uint64_t NumOfFrames);
+
+
+/**
+ * @brief  Set strings to a string Channel and save it into the sink
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Channel: Pointer to TDMS Channel object structure (TDMS_DataType_String)
+ * @param  Strings: Array of pointers to the strings
+ * @param  Lengths: Array of lengths of the strings (Byte). If it is Null, the
+ *                  strings must be NULL terminated.
+ * 
+ * @param  NumOfValues: Number of strings
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_WriterSetChannelStringValues(TDMS_Writer_t *Writer,
+                                  TDMS_Channel_t *Channel,
+                                  const char * const *Strings,
+                                  const uint32_t *Lengths,
+                                  uint64_t NumOfValues);
+
+
+/**
+ * @brief  Set packed strings to a string Channel and save it into the sink
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Channel: Pointer to TDMS Channel object structure (TDMS_DataType_String)
+ * @param  Packed: Pointer to the concatenated strings (without NULL characters)
+ * @param  PackedLen: Length of Packed (Byte)
+ * @param  EndOffsets: Array of end offsets of the strings in Packed (Byte, not
+ *                     decreasing and not more than PackedLen)
+ * 
+ * @param  NumOfValues: Number of strings
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_WriterSetChannelPackedStringValues(TDMS_Writer_t *Writer,
+                                        TDMS_Channel_t *Channel,
+                                        const char *Packed,
+                                        uint64_t PackedLen,
+                                        const uint32_t *EndOffsets,
+                                        uint64_t NumOfValues);
+
+
+/**
+ ==================================================================================
+                         ##### Coalescer Functions #####
+ ==================================================================================
+ */
+
+/**
+ * @brief  Initialize Coalescer object structure
+ * @note   A Coalescer stages values of Channels and saves them as one raw data
+ *         segment by a Writer when a threshold is reached or
+ *         TDMS_CoalescerFlush is called.
+ * @note   On POSIX systems, time is measured by a monotonic clock in ms. On the
+ *         others, MaxTime is disabled until TDMS_CoalescerSetClock is called.
+ * 
+ * @param  Coalescer: Pointer to TDMS Coalescer object structure
+ * @param  Writer: Pointer to initialized TDMS Writer object structure
+ * @param  MaxBytes: Staged raw data (Byte) of all Channels that is saved
+ *                   (0: disabled)
+ * 
+ * @param  MaxValues: Staged values of a Channel that are saved (0: disabled)
+ * @param  MaxTime: Time (ms) after the first staged value that staged values
+ *                  are saved (0: disabled)
+ * 
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+TDMS_Result_t
+TDMS_InitCoalescer(TDMS_Coalescer_t *Coalescer, TDMS_Writer_t *Writer,
+                   uint64_t MaxBytes, uint64_t MaxValues, uint64_t MaxTime);
+
+
+/**
+ * @brief  Set the time source of a Coalescer
+ * @param  Coalescer: Pointer to TDMS Coalescer object structure
+ * @param  GetTime: Function that returns current time in ms (Null disables
+ *                  MaxTime)
+ * 
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ */
+TDMS_Result_t
+TDMS_CoalescerSetClock(TDMS_Coalescer_t *Coalescer, uint64_t (*GetTime)(void));
+
+
+/**
+ * @brief  Save the staged values and release the staging buffers
+ * @param  Coalescer: Pointer to TDMS Coalescer object structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_DeInitCoalescer(TDMS_Coalescer_t *Coalescer);
+
+
+/**
+ * @brief  Stage data values of a Channel
+ * @note   Values are copied, so the buffer of values can be reused after the
+ *         call.
+ * 
+ * @param  Coalescer: Pointer to TDMS Coalescer object structure
+ * @param  Channel: Pointer to TDMS Channel object structure
+ * @param  Values: Pointer to data values
+ * @param  NumOfValues: Number of values
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_CoalescerSetChannelDataValues(TDMS_Coalescer_t *Coalescer,
+                                   TDMS_Channel_t *Channel,
+                                   const void *Values,
+                                   uint64_t NumOfValues);
+
+
+/**
+ * @brief  Stage data values of Channels of a Group
+ * @param  Coalescer: Pointer to TDMS Coalescer object structure
+ * @param  Group: Pointer to TDMS Group object structure
+ * @param  ...: Pointer to Channels data values, Number of values (uint64_t).
+ *         (like TDMS_SetGroupDataValues)
+ * 
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_CoalescerSetGroupDataValues(TDMS_Coalescer_t *Coalescer,
+                                 TDMS_Group_t *Group,
+                                 ...
+                                 );
+
+
+/**
+ * @brief  Save the staged values if MaxTime of Coalescer is elapsed
+ * @note   Thresholds are checked when values are staged. This function can be
+ *         called periodically to save the values of idle Channels in time.
+ * 
+ * @param  Coalescer: Pointer to TDMS Coalescer object structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_CoalescerPoll(TDMS_Coalescer_t *Coalescer);
+
+
+/**
+ * @brief  Save the staged values of all Channels as one raw data segment
+ * @note   If saving the segment fails, the values stay staged, so the flush can
+ *         be called again.
+ *
+ * @param  Coalescer: Pointer to TDMS Coalescer object structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_CoalescerFlush(TDMS_Coalescer_t *Coalescer);
+
+
+
+/**
+ ==================================================================================
+                       ##### Group Template Functions #####
+ ==================================================================================
+ */
+
+/**
+ * @brief  Initialize Group Template object structure
+ * @note   A Group Template holds the serialized Lead In part and meta data of
+ *         the raw data segments of a Group with fixed number of values of each
+ *         Channel, so the segments are generated without walking the Channels
+ *         and only the data values are copied (or passed to a scatter-gather
+ *         sink).
+ * @note   The Template must be initialized again if Channels are added to the
+ *         Group.
+ * 
+ * @param  Template: Pointer to TDMS Group Template object structure
+ * @param  Group: Pointer to TDMS Group object structure
+ * @param  NumOfValues: Array of number of values of each Channel of the Group
+ *                      (0: Channel is not in the segments)
+ * 
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ */
+TDMS_Result_t
+TDMS_InitGroupTemplate(TDMS_GroupTemplate_t *Template, TDMS_Group_t *Group,
+                       const uint64_t *NumOfValues);
+
+
+/**
+ * @brief  Change number of values of the Channels of a Group Template
+ * @note   Numbers of values are patched in place, unless a Channel is added to
+ *         or removed from the segments (its number of values becomes or was 0).
+ * 
+ * @param  Template: Pointer to TDMS Group Template object structure
+ * @param  NumOfValues: Array of number of values of each Channel of the Group
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ */
+TDMS_Result_t
+TDMS_GroupTemplateSetNumOfValues(TDMS_GroupTemplate_t *Template,
+                                 const uint64_t *NumOfValues);
+
+
+/**
+ * @brief  Release the memory of a Group Template
+ * @param  Template: Pointer to TDMS Group Template object structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ */
+TDMS_Result_t
+TDMS_DeInitGroupTemplate(TDMS_GroupTemplate_t *Template);
+
+
+/**
+ * @brief  Set data to Channels of a Group by its Template
+ * @note   Like TDMS_SetGroupDataValues with the number of values of the
+ *         Template. The buffer must be saved on disk, after each call with a
+ *         valid buffer address.
+ * 
+ * @param  Template: Pointer to TDMS Group Template object structure
+ * @param  Buffer: Pointer to the buffer that data save in
+ * @note   If the buffer address is Null, then function only calculates needed
+ *         buffer size and returns TDMS_OK.
+ * 
+ * @param  Size: Size of data in buffer (Byte)
+ * @param  Values: Array of pointers to data values of each Channel of the Group
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+TDMS_Result_t
+TDMS_SetGroupTemplateDataValues(TDMS_GroupTemplate_t *Template,
+                                uint8_t *Buffer,
+                                uint64_t *Size,
+                                const void * const *Values);
+
+
+/**
+ * @brief  Set data to Channels of a Group by its Template and save it into the
+ *         sink of a Writer
+ * @note   If the sink supports scatter-gather write, the data values are not
+ *         copied.
+ * 
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Template: Pointer to TDMS Group Template object structure
+ * @param  Values: Array of pointers to data values of each Channel of the Group
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_WriterSetGroupTemplateDataValues(TDMS_Writer_t *Writer,
+                                      TDMS_GroupTemplate_t *Template,
+                                      const void * const *Values);
+
+
+
+/**
+ ==================================================================================
+                     ##### Streaming Segment Functions #####
+ ==================================================================================
+ */
+
+/**
+ * @brief  Start a raw data segment of a Group Template that stays open, so the
+ *         raw data of next writes is appended to it without any Lead In part
+ *         or meta data
+ * @note   NextSegmentOffset of the segment is 0xFFFFFFFFFFFFFFFF until
+ *         TDMS_EndStreamSegment patches it, so a file that is not closed (e.g.
+ *         after a crash) can still be read (readers use the end of file and
+ *         whole chunks).
+ * @note   The Writer must not save other data until TDMS_EndStreamSegment is
+ *         called, and its sink must support WriteAt and save from the start of
+ *         the file.
+ * 
+ * @param  Segment: Pointer to TDMS Streaming Segment structure
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Template: Pointer to TDMS Group Template object structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument (e.g. sink has no WriteAt)
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_BeginStreamSegment(TDMS_StreamSegment_t *Segment, TDMS_Writer_t *Writer,
+                        TDMS_GroupTemplate_t *Template);
+
+
+/**
+ * @brief  Append data values of Channels of the Group (a chunk with the number
+ *         of values of the Template) to a Streaming Segment
+ * @note   If the sink supports scatter-gather write, the data values are not
+ *         copied.
+ * 
+ * @param  Segment: Pointer to TDMS Streaming Segment structure
+ * @param  Values: Array of pointers to data values of each Channel of the Group
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_StreamSegmentSetDataValues(TDMS_StreamSegment_t *Segment,
+                                const void * const *Values);
+
+
+/**
+ * @brief  Close a Streaming Segment (patch the offsets of its Lead In part and
+ *         save it into the index sink)
+ * @param  Segment: Pointer to TDMS Streaming Segment structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_EndStreamSegment(TDMS_StreamSegment_t *Segment);
+
+
+
+/**
+ ==================================================================================
+                      ##### Property Builder Functions #####
+ ==================================================================================
+ */
+
+/**
+ * @brief  Initialize Property Builder object structure
+ * @note   A Property Builder collects Properties of any number of objects of a
+ *         File and generates all of them in one meta data segment (or in first
+ *         part of the file), instead of a segment for each Property.
+ * 
+ * @param  Builder: Pointer to TDMS Property Builder object structure
+ * @param  File: Pointer to TDMS File object structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+TDMS_Result_t
+TDMS_InitPropertyBuilder(TDMS_PropertyBuilder_t *Builder, TDMS_File_t *File);
+
+
+/**
+ * @brief  Remove all Properties of a Property Builder (its memory is reused)
+ * @param  Builder: Pointer to TDMS Property Builder object structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ */
+TDMS_Result_t
+TDMS_ClearPropertyBuilder(TDMS_PropertyBuilder_t *Builder);
+
+
+/**
+ * @brief  Release the memory of a Property Builder
+ * @param  Builder: Pointer to TDMS Property Builder object structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ */
+TDMS_Result_t
+TDMS_DeInitPropertyBuilder(TDMS_PropertyBuilder_t *Builder);
+
+
+/**
+ * @brief  Add Property to the file object of a Property Builder
+ * @note   The value is copied into the Builder.
+ * 
+ * @param  Builder: Pointer to TDMS Property Builder object structure
+ * @param  Name: Name of Property
+ * @param  DataType: Data type of Property
+ * @param  Value: Pointer to the value of Property (NULL terminated string for
+ *                TDMS_DataType_String)
+ * 
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ */
+TDMS_Result_t
+TDMS_PropertyBuilderAddToFile(TDMS_PropertyBuilder_t *Builder,
+                              const char *Name, TDMS_Data_t DataType,
+                              const void *Value);
+
+
+/**
+ * @brief  Add Property to a Group of a Property Builder
+ * @param  Builder: Pointer to TDMS Property Builder object structure
+ * @param  Group: Pointer to TDMS Group object structure
+ * @param  Name: Name of Property
+ * @param  DataType: Data type of Property
+ * @param  Value: Pointer to the value of Property
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ */
+TDMS_Result_t
+TDMS_PropertyBuilderAddToGroup(TDMS_PropertyBuilder_t *Builder,
+                               TDMS_Group_t *Group,
+                               const char *Name, TDMS_Data_t DataType,
+                               const void *Value);
+
+
+/**
+ * @brief  Add Property to a Channel of a Property Builder
+ * @param  Builder: Pointer to TDMS Property Builder object structure
+ * @param  Channel: Pointer to TDMS Channel object structure
+ * @param  Name: Name of Property
+ * @param  DataType: Data type of Property
+ * @param  Value: Pointer to the value of Property
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ */
+TDMS_Result_t
+TDMS_PropertyBuilderAddToChannel(TDMS_PropertyBuilder_t *Builder,
+                                 TDMS_Channel_t *Channel,
+                                 const char *Name, TDMS_Data_t DataType,
+                                 const void *Value);
+
+
+/**
+ * @brief  Generate one meta data segment with all Properties of a Property
+ *         Builder
+ * @note   The segment does not contain a new object list, so the object list
+ *         of previous raw data segment stays valid for next segments.
+ *         Properties stay in the Builder until TDMS_ClearPropertyBuilder is
+ *         called.
+ * 
+ * @param  Builder: Pointer to TDMS Property Builder object structure
+ * @param  Buffer: Pointer to the buffer that data save in
+ * @note   If the buffer address is Null, then function only calculates needed
+ *         buffer size and returns TDMS_OK.
+ * 
+ * @param  Size: Size of data in buffer (Byte, 0 if Builder is empty)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ */
+TDMS_Result_t
+TDMS_GenPropertySegment(TDMS_PropertyBuilder_t *Builder,
+                        uint8_t *Buffer,
+                        uint64_t *Size);
+
+
+/**
+ * @brief  Generate First part of TDMS file with the Properties of a Property
+ *         Builder
+ * @note   Like TDMS_GenFirstPart, but Properties of the objects are saved in
+ *         their entries of the object list.
+ * 
+ * @param  Builder: Pointer to TDMS Property Builder object structure
+ * @param  Buffer: Pointer to the buffer that data save in
+ * @note   If the buffer address is Null, then function only calculates needed
+ *         buffer size and returns TDMS_OK.
+ * 
+ * @param  Size: Size of data in buffer (Byte)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ */
+TDMS_Result_t
+TDMS_GenFirstPartWithProperties(TDMS_PropertyBuilder_t *Builder,
+                                uint8_t *Buffer,
+                                uint64_t *Size);
+
+
+/**
+ * @brief  Generate one meta data segment with all Properties of a Property
+ *         Builder and save it into the sink
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Builder: Pointer to TDMS Property Builder object structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_WriterSaveProperties(TDMS_Writer_t *Writer,
+                          TDMS_PropertyBuilder_t *Builder);
+
+
+/**
+ * @brief  Generate First part of TDMS file with the Properties of a Property
+ *         Builder and save it into the sink
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  Builder: Pointer to TDMS Property Builder object structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Sink failed
+ */
+TDMS_Result_t
+TDMS_WriterGenFirstPartWithProperties(TDMS_Writer_t *Writer,
+                                      TDMS_PropertyBuilder_t *Builder);
+
+
+
+/**
+ ==================================================================================
+                      ##### Rotating Writer Functions #####
+ ==================================================================================
+ */
+
+/**
+ * @brief  Initialize a Writer that saves data into a sequence of files and
+ *         starts a new file by size or duration
+ * @note   The first part of the files (with the Properties of the Builder of
+ *         Rotation) is generated once, saved into the first file and saved
+ *         again at the start of each new file. Files are switched after a
+ *         segment is saved, so no value is lost or saved twice, and the first
+ *         raw data segment of each file has a new object list.
+ * @note   wf_start_time of waveform Channels in next files is moved by the
+ *         number of values that are saved before.
+ * 
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @param  File: Pointer to TDMS File object structure (Groups and Channels must
+ *               be added before)
+ * 
+ * @param  Rotation: Pointer to TDMS Rotation structure (MaxSize, MaxDuration,
+ *                   GetTime, NextFile, Context and Builder must be set). It
+ *                   must be valid until TDMS_DeInitWriter is called. If
+ *                   GetTime is Null, the monotonic clock is used (POSIX).
+ * 
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - Others: Error of NextFile or sink
+ */
+TDMS_Result_t
+TDMS_InitRotatingWriter(TDMS_Writer_t *Writer, TDMS_File_t *File,
+                        TDMS_Rotation_t *Rotation);
+
+
+/**
+ * @brief  Start a new file of a rotating Writer now
+ * @param  Writer: Pointer to TDMS Writer object structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Writer is not a rotating Writer
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - Others: Error of NextFile or sink
+ */
+TDMS_Result_t
+TDMS_WriterRotate(TDMS_Writer_t *Writer);
+
+
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,250 @@
+/**
+ **********************************************************************************
+ * @file   TDMS_Async.h
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  Asynchronous TDMS Writer for POSIX systems
+ * @note   Data values are copied into lock-free single producer, single
+ *         consumer rings (a lane for each producer thread) and a background
+ *         thread merges them into segments and saves them by a TDMS Writer, so
+ *         disk stalls do not block the threads that produce the data.
+ **********************************************************************************
+ */
+
+/* Define to prevent recursive inclusion ----------------------------------------*/
+#ifndef _TDMS_ASYNC_H_
+#define _TDMS_ASYNC_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* Includes ---------------------------------------------------------------------*/
+#include "TDMS.h"
+#include <stdint.h>
+
+
+#if (TDMS_CONFIG_POSIX == 1)
+
+/* Exported Data Types ----------------------------------------------------------*/
+
+/**
+ * @brief  What happens when the ring of an Asynchronous Writer is full
+ */
+typedef enum
+{
+  // Wait until the background thread frees enough space
+  TDMS_AsyncPolicy_Block = 0,
+  // Drop the values and return TDMS_OUT_OF_CAP
+  TDMS_AsyncPolicy_Drop
+} TDMS_AsyncPolicy_t;
+
+/**
+ * @brief  Asynchronous Writer structure
+ */
+typedef struct
+{
+  TDMS_Writer_t *Writer;
+  TDMS_AsyncPolicy_t Policy;
+  // Size of the ring of each lane (Byte)
+  uint64_t RingSize;
+  uint32_t NumOfLanes;
+  // Lanes and state of the background thread (allocated by
+  // TDMS_InitAsyncWriter)
+  void *State;
+} TDMS_AsyncWriter_t;
+
+
+
+/**
+ ==================================================================================
+                             ##### Functions #####
+ ==================================================================================
+ */
+
+/**
+ * @brief  Initialize Asynchronous Writer object structure with one lane and
+ *         start its background thread
+ * @note   Only one thread can set data values to this Asynchronous Writer, and
+ *         the Writer must not be used by other functions until
+ *         TDMS_DeInitAsyncWriter is called (e.g. first part of the file and
+ *         properties must be saved before).
+ *
+ * @param  Async: Pointer to TDMS Asynchronous Writer object structure
+ * @param  Writer: Pointer to initialized TDMS Writer object structure
+ * @param  RingSize: Size of the ring (Byte). It is rounded up to a power of 2
+ *                   and limits the memory of the data values that are not
+ *                   saved yet.
+ *
+ * @param  Policy: What happens when the ring is full
+ *         - TDMS_AsyncPolicy_Block: Wait for space
+ *         - TDMS_AsyncPolicy_Drop: Drop the values
+ *
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Starting the thread failed
+ */
+TDMS_Result_t
+TDMS_InitAsyncWriter(TDMS_AsyncWriter_t *Async, TDMS_Writer_t *Writer,
+                     uint64_t RingSize, TDMS_AsyncPolicy_t Policy);
+
+
+/**
+ * @brief  Initialize Asynchronous Writer object structure with a lane for each
+ *         producer thread and start its background thread
+ * @note   Each lane must be used by only one thread at a time, and a Channel
+ *         should be set by only one lane (values of a Channel that is set by
+ *         more than one lane are saved in the order that the background thread
+ *         reads them). The Writer must not be used by other functions until
+ *         TDMS_DeInitAsyncWriter is called.
+ *
+ * @param  Async: Pointer to TDMS Asynchronous Writer object structure
+ * @param  Writer: Pointer to initialized TDMS Writer object structure
+ * @param  NumOfLanes: Number of lanes (producer threads)
+ * @param  RingSize: Size of the ring of each lane (Byte). It is rounded up to a
+ *                   power of 2.
+ *
+ * @param  Policy: What happens when the ring of a lane is full
+ *         - TDMS_AsyncPolicy_Block: Wait for space
+ *         - TDMS_AsyncPolicy_Drop: Drop the values
+ *
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Starting the thread failed
+ */
+TDMS_Result_t
+TDMS_InitAsyncWriterLanes(TDMS_AsyncWriter_t *Async, TDMS_Writer_t *Writer,
+                          uint32_t NumOfLanes, uint64_t RingSize,
+                          TDMS_AsyncPolicy_t Policy);
+
+
+/**
+ * @brief  Save all of the data values in the lanes, stop the background thread
+ *         and release the lanes
+ * @note   Producer threads must not set data values during or after this call.
+ *
+ * @param  Async: Pointer to TDMS Asynchronous Writer object structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - Others: First error of the background thread
+ */
+TDMS_Result_t
+TDMS_DeInitAsyncWriter(TDMS_AsyncWriter_t *Async);
+
+
+/**
+ * @brief  Set data to a Channel (saved by the background thread) by the first
+ *         lane
+ * @note   Values are copied, so the buffer of values can be reused after the
+ *         call.
+ *
+ * @param  Async: Pointer to TDMS Asynchronous Writer object structure
+ * @param  Channel: Pointer to TDMS Channel object structure
+ * @param  Values: Pointer to data values
+ * @param  NumOfValues: Number of values
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_OUT_OF_CAP: The values are dropped (ring is full or smaller
+ *                            than the values)
+ *         - Others: Error of the background thread
+ */
+TDMS_Result_t
+TDMS_AsyncWriterSetChannelDataValues(TDMS_AsyncWriter_t *Async,
+                                     TDMS_Channel_t *Channel,
+                                     const void *Values,
+                                     uint64_t NumOfValues);
+
+
+/**
+ * @brief  Set data to Channels of a Group (saved by the background thread) by
+ *         the first lane
+ * @param  Async: Pointer to TDMS Asynchronous Writer object structure
+ * @param  Group: Pointer to TDMS Group object structure
+ * @param  ...: Pointer to Channels data values, Number of values (uint64_t).
+ *         (like TDMS_SetGroupDataValues)
+ *
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_OUT_OF_CAP: The values are dropped (ring is full or smaller
+ *                            than the values)
+ *         - Others: Error of the background thread
+ */
+TDMS_Result_t
+TDMS_AsyncWriterSetGroupDataValues(TDMS_AsyncWriter_t *Async,
+                                   TDMS_Group_t *Group,
+                                   ...
+                                   );
+
+
+/**
+ * @brief  Set data to a Channel (saved by the background thread) by a lane
+ * @param  Async: Pointer to TDMS Asynchronous Writer object structure
+ * @param  Lane: Index of the lane of the calling thread
+ * @param  Channel: Pointer to TDMS Channel object structure
+ * @param  Values: Pointer to data values
+ * @param  NumOfValues: Number of values
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_OUT_OF_CAP: The values are dropped (ring is full or smaller
+ *                            than the values)
+ *         - Others: Error of the background thread
+ */
+TDMS_Result_t
+TDMS_AsyncWriterLaneSetChannelDataValues(TDMS_AsyncWriter_t *Async,
+                                         uint32_t Lane,
+                                         TDMS_Channel_t *Channel,
+                                         const void *Values,
+                                         uint64_t NumOfValues);
+
+
+/**
+ * @brief  Set data to Channels of a Group (saved by the background thread) by
+ *         a lane
+ * @param  Async: Pointer to TDMS Asynchronous Writer object structure
+ * @param  Lane: Index of the lane of the calling thread
+ * @param  Group: Pointer to TDMS Group object structure
+ * @param  ...: Pointer to Channels data values, Number of values (uint64_t).
+ *         (like TDMS_SetGroupDataValues)
+ *
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_OUT_OF_CAP: The values are dropped (ring is full or smaller
+ *                            than the values)
+ *         - Others: Error of the background thread
+ */
+TDMS_Result_t
+TDMS_AsyncWriterLaneSetGroupDataValues(TDMS_AsyncWriter_t *Async,
+                                       uint32_t Lane,
+                                       TDMS_Group_t *Group,
+                                       ...
+                                       );
+
+
+/**
+ * @brief  Get number of data values that are dropped because a ring was full
+ * @param  Async: Pointer to TDMS Asynchronous Writer object structure
+ * @param  NumOfValues: Pointer to save number of dropped values
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ */
+TDMS_Result_t
+TDMS_AsyncWriterDropped(TDMS_AsyncWriter_t *Async, uint64_t *NumOfValues);
+
+#endif //! TDMS_CONFIG_POSIX
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif //! _TDMS_ASYNC_H_
@@ -0,0 +1,329 @@
+/**
+ **********************************************************************************
+ * @file   TDMS_Reader.h
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  Read NI TDMS file (.TDMS)
+ * @note   The file is mapped into memory (or loaded if mmap is not available)
+ *         and an index of its segments and objects is built by walking the lead
+ *         in parts. Raw data is not touched until a chunk is requested, and the
+ *         chunks point into the mapped file (zero-copy).
+ * @note   DAQmx raw data is supported if each object has one format changing
+ *         scaler and all of the objects of a segment share one raw buffer
+ *         (like the files that are generated by TDMS_AddDAQmxChannelToGroup).
+ *         Values of the chunks are the raw values; NI_Scale Properties are not
+ *         applied.
+ **********************************************************************************
+ */
+
+/* Define to prevent recursive inclusion ----------------------------------------*/
+#ifndef _TDMS_READER_H_
+#define _TDMS_READER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* Includes ---------------------------------------------------------------------*/
+#include "TDMS.h"
+#include <stdint.h>
+
+
+/* Exported Data Types ----------------------------------------------------------*/
+
+/**
+ * @brief  Segment of TDMS file
+ */
+typedef struct
+{
+  // ToC mask of the lead in part
+  uint32_t ToC;
+  // Offset of the lead in part in the file
+  uint64_t Offset;
+  // Offset and size of raw data in the file
+  uint64_t RawDataOffset;
+  uint64_t RawDataSize;
+  // Size and number of the chunks of raw data
+  uint64_t ChunkSize;
+  uint64_t NumOfChunks;
+  // Entries of the objects that have raw data in the segment
+  uint32_t FirstEntry;
+  uint32_t NumOfEntries;
+} TDMS_ReaderSegment_t;
+
+/**
+ * @brief  Raw data of an object in a segment
+ */
+typedef struct
+{
+  uint32_t Object;
+  uint32_t Segment;
+  // Next entry of the same object (0xFFFFFFFF: last entry)
+  uint32_t NextEntry;
+  uint64_t NumOfValues;
+  // Size of raw data of the object in each chunk (Byte)
+  uint64_t Size;
+  // Offset of raw data in the chunk (in interleaved and DAQmx segments: in
+  // each row)
+  uint64_t Offset;
+} TDMS_ReaderEntry_t;
+
+/**
+ * @brief  Object (File, Group or Channel) of TDMS file
+ */
+typedef struct
+{
+  // Path of the object (points into the file and is not NULL terminated)
+  const char *Path;
+  uint32_t PathLen;
+  TDMS_Data_t DataType;
+  // Number of values of the object in all of the segments
+  uint64_t NumOfValues;
+  // First and last entries of the object (0xFFFFFFFF: no entry)
+  uint32_t FirstEntry;
+  uint32_t LastEntry;
+  // First and last properties of the object (0xFFFFFFFF: no property)
+  uint32_t FirstProperty;
+  uint32_t LastProperty;
+  // Raw data index of the object in the last segment that had it
+  uint64_t IndexNumOfValues;
+  uint64_t IndexSize;
+  // Byte offset of the values in each frame and size of the frames of DAQmx
+  // raw data (DAQmxWidth is 0 if raw data is not DAQmx raw data)
+  uint32_t DAQmxOffset;
+  uint32_t DAQmxWidth;
+  uint8_t HasIndex;
+  // 1 if the object is in the object list of the last segment
+  uint8_t InList;
+} TDMS_ReaderObject_t;
+
+/**
+ * @brief  Property of an object
+ */
+typedef struct
+{
+  // Name of the property (points into the file and is not NULL terminated)
+  const char *Name;
+  uint32_t NameLen;
+  TDMS_Data_t DataType;
+  // Value of the property (points into the file). For strings, it points to
+  // the characters that are not NULL terminated.
+  const uint8_t *Value;
+  uint32_t Size;
+  // 1 if Value is big-endian
+  uint8_t BigEndian;
+  // Next property of the same object (0xFFFFFFFF: last property)
+  uint32_t NextProperty;
+} TDMS_ReaderProperty_t;
+
+/**
+ * @brief  Chunk of raw data of a Channel
+ */
+typedef struct
+{
+  // Position of the chunk in the file (used by TDMS_ReaderNextChunk)
+  uint32_t Entry;
+  uint64_t Index;
+  TDMS_Data_t DataType;
+  // First value of the chunk (points into the file)
+  const uint8_t *Data;
+  uint64_t NumOfValues;
+  // Distance between the values (Byte). It is the size of the data type if the
+  // segment is not interleaved or DAQmx raw data.
+  uint64_t Stride;
+  // Size of raw data of the chunk. For strings, it is the size of the offsets
+  // followed by the characters.
+  uint64_t Size;
+  // 1 if the values are big-endian
+  uint8_t BigEndian;
+} TDMS_ReaderChunk_t;
+
+/**
+ * @brief  Reader structure
+ */
+typedef struct
+{
+  // Content of the file
+  const uint8_t *Data;
+  uint64_t Size;
+  // 1: Data is mapped, 2: Data is allocated, 0: Data belongs to the user
+  uint8_t Owner;
+
+  TDMS_ReaderSegment_t *Segments;
+  uint32_t NumOfSegments;
+  uint32_t SegmentsSize;
+
+  TDMS_ReaderObject_t *Objects;
+  uint32_t NumOfObjects;
+  uint32_t ObjectsSize;
+
+  TDMS_ReaderEntry_t *Entries;
+  uint32_t NumOfEntries;
+  uint32_t EntriesSize;
+
+  TDMS_ReaderProperty_t *Properties;
+  uint32_t NumOfProperties;
+  uint32_t PropertiesSize;
+
+  // Hash table of the objects by path (indexes into Objects)
+  uint32_t *ObjectHash;
+  uint32_t ObjectHashSize;
+
+  // Objects of the object list of the last segment
+  uint32_t *List;
+  uint32_t ListLen;
+  uint32_t ListSize;
+} TDMS_Reader_t;
+
+
+
+/**
+ ==================================================================================
+                             ##### Functions #####
+ ==================================================================================
+ */
+
+/**
+ * @brief  Open a TDMS file and build the index of its segments and objects
+ * @note   The file is mapped into memory on POSIX systems and loaded into an
+ *         allocated buffer on the others.
+ *
+ * @param  Reader: Pointer to TDMS Reader structure
+ * @param  FilePath: Path of the file
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: The file is not a valid TDMS file
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Opening or reading the file failed
+ */
+TDMS_Result_t
+TDMS_ReaderOpen(TDMS_Reader_t *Reader, const char *FilePath);
+
+
+/**
+ * @brief  Build the index of the segments and objects of a TDMS file that is
+ *         already in memory
+ * @note   Data must remain valid until TDMS_ReaderClose is called.
+ *
+ * @param  Reader: Pointer to TDMS Reader structure
+ * @param  Data: Pointer to content of the file
+ * @param  Size: Size of the file (Byte)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Data is not a valid TDMS file
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ */
+TDMS_Result_t
+TDMS_ReaderOpenMemory(TDMS_Reader_t *Reader, const void *Data, uint64_t Size);
+
+
+/**
+ * @brief  Release the index and the file of a Reader
+ * @param  Reader: Pointer to TDMS Reader structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ */
+TDMS_Result_t
+TDMS_ReaderClose(TDMS_Reader_t *Reader);
+
+
+/**
+ * @brief  Find an object by its path
+ * @param  Reader: Pointer to TDMS Reader structure
+ * @param  Path: NULL terminated path of the object (e.g. "/'Group'/'Channel'")
+ * @param  Object: Pointer to save index of the object in Reader->Objects
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: The object does not exist
+ */
+TDMS_Result_t
+TDMS_ReaderFindObject(TDMS_Reader_t *Reader, const char *Path, uint32_t *Object);
+
+
+/**
+ * @brief  Find a property of an object by its name
+ * @note   If the property is set more than once, the last value is returned.
+ *
+ * @param  Reader: Pointer to TDMS Reader structure
+ * @param  Object: Index of the object in Reader->Objects
+ * @param  Name: NULL terminated name of the property
+ * @param  Property: Pointer to save address of the property
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: The property does not exist
+ */
+TDMS_Result_t
+TDMS_ReaderFindProperty(TDMS_Reader_t *Reader, uint32_t Object,
+                        const char *Name, const TDMS_ReaderProperty_t **Property);
+
+
+/**
+ * @brief  Get first chunk of raw data of a Channel
+ * @param  Reader: Pointer to TDMS Reader structure
+ * @param  Object: Index of the Channel in Reader->Objects
+ * @param  Chunk: Pointer to TDMS Reader Chunk structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_OUT_OF_CAP: The Channel has no raw data
+ */
+TDMS_Result_t
+TDMS_ReaderFirstChunk(TDMS_Reader_t *Reader, uint32_t Object,
+                      TDMS_ReaderChunk_t *Chunk);
+
+
+/**
+ * @brief  Get next chunk of raw data of a Channel
+ * @param  Reader: Pointer to TDMS Reader structure
+ * @param  Chunk: Pointer to TDMS Reader Chunk structure that is filled by
+ *                TDMS_ReaderFirstChunk or this function
+ *
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_OUT_OF_CAP: There is no more chunk
+ */
+TDMS_Result_t
+TDMS_ReaderNextChunk(TDMS_Reader_t *Reader, TDMS_ReaderChunk_t *Chunk);
+
+
+/**
+ * @brief  Save the content of a file in a compact layout: one segment with
+ *         all of the objects and their properties, followed by the raw data of
+ *         each Channel as one contiguous block
+ * @note   Files that are saved by many small writes have many small segments.
+ *         The defragmented file has one segment, so readers do not walk the
+ *         Lead In parts of all of them. Chunks are streamed from the file, so
+ *         memory does not grow with the size of raw data and files larger than
+ *         RAM can be defragmented (on POSIX systems, where files are mapped).
+ * @note   Properties that are set more than once are saved with their last
+ *         value, and the output is little-endian. DAQmx raw data is saved as
+ *         normal raw data of the raw values (NI_Scale Properties are kept).
+ *
+ * @param  Reader: Pointer to TDMS Reader structure (opened with
+ *                 TDMS_ReaderOpen or TDMS_ReaderOpenMemory)
+ *
+ * @param  Sink: Pointer to the sink of the new file
+ * @param  IndexSink: Pointer to the sink of the new TDMS index file, or Null
+ * @param  BufferSize: Size of the buffer that interleaved and big-endian
+ *                     values are converted in (Byte, at least 16)
+ *
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_OUT_OF_CAP: Characters of a string Channel are more than
+ *                            4 GB and do not fit in one segment
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - Others: Error of a sink
+ */
+TDMS_Result_t
+TDMS_ReaderDefragment(TDMS_Reader_t *Reader, const TDMS_Sink_t *Sink,
+                      const TDMS_Sink_t *IndexSink, uint64_t BufferSize);
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif //! _TDMS_READER_H_
@@ -0,0 +1,102 @@
+/**
+ **********************************************************************************
+ * @file   TDMS_Rotate.h
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  File Rotator of rotating TDMS Writers for POSIX systems
+ * @note   A background thread opens the next file before it is needed and
+ *         closes the files that are finished, so switching the files of a
+ *         rotating Writer does not wait for open and close calls.
+ **********************************************************************************
+ */
+
+/* Define to prevent recursive inclusion ----------------------------------------*/
+#ifndef _TDMS_ROTATE_H_
+#define _TDMS_ROTATE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* Includes ---------------------------------------------------------------------*/
+#include "TDMS.h"
+#include <stdint.h>
+
+
+#if (TDMS_CONFIG_POSIX == 1)
+
+/* Exported Data Types ----------------------------------------------------------*/
+
+/**
+ * @brief  File Rotator structure
+ */
+typedef struct
+{
+  // Passed to TDMS_InitRotatingWriter
+  TDMS_Rotation_t Rotation;
+  // Files and state of the background thread (allocated by
+  // TDMS_InitFileRotator)
+  void *State;
+} TDMS_FileRotator_t;
+
+
+
+/**
+ ==================================================================================
+                             ##### Functions #####
+ ==================================================================================
+ */
+
+/**
+ * @brief  Initialize File Rotator object structure and start its background
+ *         thread
+ * @note   Files are named PathPrefix followed by a 6 digit number of the file
+ *         (from 000000) and ".tdms" (".tdms_index" for TDMS index files). Then
+ *         the Rotation of the File Rotator is passed to
+ *         TDMS_InitRotatingWriter.
+ *
+ * @param  Rotator: Pointer to TDMS File Rotator object structure
+ * @param  PathPrefix: Path of the files without number and extension (copied)
+ * @param  IndexFile: 1 to generate TDMS index files too
+ * @param  MaxSize: Size that a new file is started after it (Byte, 0: disabled)
+ * @param  MaxDuration: Time that a new file is started after it (ms, 0:
+ *                      disabled)
+ *
+ * @param  Builder: Pointer to TDMS Property Builder object structure that
+ *                  Properties of the first part of the files are in (or Null)
+ *
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Starting the thread failed
+ */
+TDMS_Result_t
+TDMS_InitFileRotator(TDMS_FileRotator_t *Rotator, const char *PathPrefix,
+                     uint8_t IndexFile, uint64_t MaxSize, uint64_t MaxDuration,
+                     TDMS_PropertyBuilder_t *Builder);
+
+
+/**
+ * @brief  Stop the background thread of File Rotator and close all of the files
+ * @note   Must be called after the last segment is saved by the rotating
+ *         Writer. The next file that is opened but not used is removed.
+ *
+ * @param  Rotator: Pointer to TDMS File Rotator object structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_IO_ERROR: Closing a file failed
+ */
+TDMS_Result_t
+TDMS_DeInitFileRotator(TDMS_FileRotator_t *Rotator);
+
+#endif //! TDMS_CONFIG_POSIX
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif //! _TDMS_ROTATE_H_
@@ -0,0 +1,135 @@
+/**
+ **********************************************************************************
+ * @file   TDMS_Sink.h
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  Sinks of TDMS Writer for POSIX file descriptors
+ **********************************************************************************
+ */
+
+/* Define to prevent recursive inclusion ----------------------------------------*/
+#ifndef _TDMS_SINK_H_
+#define _TDMS_SINK_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* Includes ---------------------------------------------------------------------*/
+#include "TDMS.h"
+
+
+#if (TDMS_CONFIG_POSIX == 1)
+
+/* Exported Data Types ----------------------------------------------------------*/
+
+/**
+ * @brief  File that is saved by aligned direct (O_DIRECT) writes
+ */
+typedef struct
+{
+  int Fd;
+  // 1 if the file is opened with O_DIRECT (Some file systems do not support
+  // it, then the same aligned writes pass through page cache)
+  uint8_t Direct;
+  // Alignment of file offsets, sizes and addresses of writes (Byte)
+  uint32_t Align;
+  // Aligned staging buffer
+  uint8_t *Buffer;
+  uint64_t BufferSize;
+  uint64_t BufferLen;
+  // Offset of the staging buffer in the file (Byte)
+  uint64_t Offset;
+  // Preallocated space of the file and size of each preallocation (Byte)
+  uint64_t Allocated;
+  uint64_t Prealloc;
+} TDMS_DirectFile_t;
+
+
+
+/**
+ ==================================================================================
+                             ##### Functions #####                                 
+ ==================================================================================
+ */
+
+/**
+ * @brief  Initialize a sink that saves data into a file descriptor
+ * @note   The sink supports scatter-gather write (writev), so a Writer that uses
+ *         it does not copy raw data of Channels. It supports WriteAt (pwrite)
+ *         too.
+ * 
+ * @param  Sink: Pointer to TDMS Sink structure
+ * @param  Fd: File descriptor (e.g. returned by open)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+TDMS_Result_t
+TDMS_InitFdSink(TDMS_Sink_t *Sink, int Fd);
+
+
+/**
+ * @brief  Open (create or truncate) a file that is saved by aligned direct
+ *         writes
+ * @note   Data is staged in an aligned buffer and saved in full blocks with
+ *         O_DIRECT, so it does not pass through page cache and writeback does
+ *         not stall the Writer. Space is preallocated (fallocate) before the
+ *         blocks are written.
+ * 
+ * @param  File: Pointer to TDMS Direct File structure
+ * @param  Path: Path of the file
+ * @param  BufferSize: Size of the staging buffer (Byte). It is rounded up to
+ *                     the alignment of writes (4 KB).
+ * 
+ * @param  Prealloc: Size of each preallocation (Byte, 0: no preallocation)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ *         - TDMS_IO_ERROR: Opening the file failed
+ */
+TDMS_Result_t
+TDMS_OpenDirectFile(TDMS_DirectFile_t *File, const char *Path,
+                    uint64_t BufferSize, uint64_t Prealloc);
+
+
+/**
+ * @brief  Initialize a sink that saves data into a Direct File
+ * @note   The sink supports scatter-gather write, so raw data of Channels is
+ *         copied only once (into the staging buffer). It supports WriteAt too.
+ * 
+ * @param  Sink: Pointer to TDMS Sink structure
+ * @param  File: Pointer to opened TDMS Direct File structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+TDMS_Result_t
+TDMS_InitDirectSink(TDMS_Sink_t *Sink, TDMS_DirectFile_t *File);
+
+
+/**
+ * @brief  Save the rest of a Direct File and close it
+ * @note   The last partial block is written padded to the alignment, then the
+ *         file is truncated to its real size (the padding and the preallocated
+ *         space that is not used are released).
+ * 
+ * @param  File: Pointer to TDMS Direct File structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_IO_ERROR: Writing or closing the file failed
+ */
+TDMS_Result_t
+TDMS_CloseDirectFile(TDMS_DirectFile_t *File);
+
+#endif //! TDMS_CONFIG_POSIX
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif //! _TDMS_SINK_H_
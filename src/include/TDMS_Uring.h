@@ -0,0 +1,124 @@
+/**
+ **********************************************************************************
+ * @file   TDMS_Uring.h
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  io_uring sink of TDMS Writer for Linux systems
+ * @note   Segments are copied into a set of buffers and full buffers are
+ *         written by io_uring while the Writer generates the next segments.
+ *         Buffers are reused when their writes are completed. If io_uring is
+ *         not available, full buffers are written by pwrite.
+ **********************************************************************************
+ */
+
+/* Define to prevent recursive inclusion ----------------------------------------*/
+#ifndef _TDMS_URING_H_
+#define _TDMS_URING_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* Includes ---------------------------------------------------------------------*/
+#include "TDMS.h"
+#include <stdint.h>
+
+
+#if (TDMS_CONFIG_POSIX == 1)
+
+/* Exported Data Types ----------------------------------------------------------*/
+
+/**
+ * @brief  io_uring File structure
+ */
+typedef struct
+{
+  int Fd;
+  // 1 if writes are submitted to io_uring, 0 if they are saved by pwrite
+  uint8_t Uring;
+  // Number and size of the buffers (Byte)
+  uint32_t NumOfBuffers;
+  uint64_t BufferSize;
+  // Offset of the next buffer in the file (Byte)
+  uint64_t Offset;
+  // Ring and buffers (allocated by TDMS_InitUringFile)
+  void *State;
+} TDMS_UringFile_t;
+
+
+
+/**
+ ==================================================================================
+                             ##### Functions #####
+ ==================================================================================
+ */
+
+/**
+ * @brief  Initialize io_uring File structure that saves data into a file
+ *         descriptor
+ * @note   Data is saved from the current position of the file. The file
+ *         descriptor must not be used until TDMS_DeInitUringFile is called.
+ *
+ * @param  File: Pointer to TDMS io_uring File structure
+ * @param  Fd: File descriptor (e.g. returned by open)
+ * @param  NumOfBuffers: Number of buffers (writes in flight, at least 2)
+ * @param  BufferSize: Size of each buffer (Byte)
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ *         - TDMS_NO_MEMORY: Memory allocation failed
+ */
+TDMS_Result_t
+TDMS_InitUringFile(TDMS_UringFile_t *File, int Fd,
+                   uint32_t NumOfBuffers, uint64_t BufferSize);
+
+
+/**
+ * @brief  Initialize a sink that saves data into an io_uring File
+ * @note   The sink supports scatter-gather write, so raw data of Channels is
+ *         copied only once (into the buffers). It supports WriteAt too.
+ *
+ * @param  Sink: Pointer to TDMS Sink structure
+ * @param  File: Pointer to initialized TDMS io_uring File structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_WRONG_ARG: Wrong argument
+ */
+TDMS_Result_t
+TDMS_InitUringSink(TDMS_Sink_t *Sink, TDMS_UringFile_t *File);
+
+
+/**
+ * @brief  Write the data of the current buffer and wait for all of the writes
+ * @param  File: Pointer to TDMS io_uring File structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_IO_ERROR: A write failed
+ */
+TDMS_Result_t
+TDMS_UringFileFlush(TDMS_UringFile_t *File);
+
+
+/**
+ * @brief  Flush io_uring File and release its ring and buffers
+ * @note   The file descriptor is not closed. Its position is moved to the end
+ *         of the saved data.
+ *
+ * @param  File: Pointer to TDMS io_uring File structure
+ * @retval TDMS_Result_t
+ *         - TDMS_OK: Operation was successful
+ *         - TDMS_IO_ERROR: A write failed
+ */
+TDMS_Result_t
+TDMS_DeInitUringFile(TDMS_UringFile_t *File);
+
+#endif //! TDMS_CONFIG_POSIX
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif //! _TDMS_URING_H_